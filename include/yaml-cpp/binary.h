@@ -17,6 +17,20 @@ YAML_CPP_API std::string EncodeBase64(const unsigned char *data,
                                       std::size_t size);
 YAML_CPP_API std::vector<unsigned char> DecodeBase64(const std::string &input);
 
+// Buffer-based versions of the above, for callers that manage their own
+// storage (e.g., to stream a large blob).
+//
+// EncodeBase64 writes exactly EncodedBase64Size(size) characters to 'out'.
+// DecodeBase64 writes at most DecodedBase64MaxSize(size) bytes to 'out', and
+// sets 'written' to the number it wrote; it returns false if 'input' isn't
+// valid base64.
+YAML_CPP_API std::size_t EncodedBase64Size(std::size_t size);
+YAML_CPP_API std::size_t EncodeBase64(const unsigned char *data,
+                                      std::size_t size, char *out);
+YAML_CPP_API std::size_t DecodedBase64MaxSize(std::size_t size);
+YAML_CPP_API bool DecodeBase64(const char *input, std::size_t size,
+                               unsigned char *out, std::size_t &written);
+
 class YAML_CPP_API Binary {
  public:
   Binary(const unsigned char *data_, std::size_t size_)
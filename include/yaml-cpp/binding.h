@@ -0,0 +1,586 @@
+#ifndef BINDING_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+#define BINDING_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+
+#if defined(_MSC_VER) ||                                            \
+    (defined(__GNUC__) && (__GNUC__ == 3 && __GNUC_MINOR__ >= 4) || \
+     (__GNUC__ >= 4))  // GCC supports "pragma once" correctly since 3.4
+#pragma once
+#endif
+
+#include <algorithm>
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "yaml-cpp/anchor.h"
+#include "yaml-cpp/emitterstyle.h"
+#include "yaml-cpp/eventhandler.h"
+#include "yaml-cpp/exceptions.h"
+#include "yaml-cpp/mark.h"
+#include "yaml-cpp/node/convert.h"
+#include "yaml-cpp/node/node.h"
+#include "yaml-cpp/node/type.h"
+#include "yaml-cpp/parser.h"
+
+namespace YAML {
+/**
+ * Names the fields of a struct, so documents can be bound to it (see
+ * {@link LoadInto}). It's specialised for each such struct, with a static
+ * {@code Describe} function that adds its fields, e.g.,
+ *
+ *   template <>
+ *   struct binding<Server> {
+ *     static void Describe(Fields<Server>& fields) {
+ *       fields.Required("host", &Server::host).Optional("port", &Server::port);
+ *     }
+ *   };
+ */
+template <typename T>
+struct binding {};
+
+template <typename T>
+class Fields;
+
+namespace detail {
+class value_binder;
+
+// bind_target
+// . Where the events of the next value go: the binder for its type, and the
+//   object it fills in. A null binder means the value is skipped.
+struct bind_target {
+  bind_target() : binder(nullptr), object(nullptr), optional(false) {}
+  bind_target(const value_binder* binder_, void* object_)
+      : binder(binder_), object(object_), optional(false) {}
+
+  const value_binder* binder;
+  void* object;
+  bool optional;  // a null value leaves the object as it is
+};
+
+// value_binder
+// . Fills in an object of some type from the events of one value; there's one
+//   (stateless) binder per type, and the state of the collections being
+//   filled in is kept by the BindingHandler.
+// . A struct keeps a flag for each of its fields, at the end of 'seen', while
+//   its map is open.
+class value_binder {
+ public:
+  virtual ~value_binder() = default;
+
+  virtual void scalar(void* object, const Mark& mark,
+                      std::string& value) const = 0;
+  virtual void null(void* object, const Mark& mark) const = 0;
+
+  virtual void begin_sequence(void* object, const Mark& mark) const = 0;
+  virtual bind_target element(void* object) const = 0;
+
+  virtual void begin_map(void* object, const Mark& mark,
+                         std::vector<char>& seen) const = 0;
+  virtual bind_target entry(void* object, const Mark& mark, std::string& key,
+                            std::vector<char>& seen) const = 0;
+  virtual void end_map(void* object, const Mark& mark,
+                       std::vector<char>& seen) const = 0;
+};
+
+// typed_binder
+// . The base of the binder for T, which throws for any kind of value the
+//   binder doesn't take.
+template <typename T>
+class typed_binder : public value_binder {
+ public:
+  void scalar(void* /* object */, const Mark& mark,
+              std::string& /* value */) const override {
+    throw TypedBadConversion<T>(mark);
+  }
+  void null(void* /* object */, const Mark& mark) const override {
+    throw TypedBadConversion<T>(mark);
+  }
+
+  void begin_sequence(void* /* object */, const Mark& mark) const override {
+    throw TypedBadConversion<T>(mark);
+  }
+  bind_target element(void* /* object */) const override {
+    return bind_target();
+  }
+
+  void begin_map(void* /* object */, const Mark& mark,
+                 std::vector<char>& /* seen */) const override {
+    throw TypedBadConversion<T>(mark);
+  }
+  bind_target entry(void* /* object */, const Mark& /* mark */,
+                    std::string& /* key */,
+                    std::vector<char>& /* seen */) const override {
+    return bind_target();
+  }
+  void end_map(void* /* object */, const Mark& /* mark */,
+               std::vector<char>& /* seen */) const override {}
+};
+
+template <typename T>
+struct has_binding {
+ private:
+  template <typename U>
+  static auto test(int)
+      -> decltype(binding<U>::Describe(std::declval<Fields<U>&>()),
+                  std::true_type());
+  template <typename>
+  static std::false_type test(...);
+
+ public:
+  static constexpr bool value = decltype(test<T>(0))::value;
+};
+
+// binder
+// . The binder for a type that isn't one of those below: a scalar (or null),
+//   decoded with convert<T>.
+template <typename T, typename Enable = void>
+class binder : public typed_binder<T> {
+ public:
+  void scalar(void* object, const Mark& mark,
+              std::string& value) const override {
+    if (!convert<T>::decode(Node(value), *static_cast<T*>(object)))
+      throw TypedBadConversion<T>(mark);
+  }
+  void null(void* object, const Mark& mark) const override {
+    if (!convert<T>::decode(Node(NodeType::Null), *static_cast<T*>(object)))
+      throw TypedBadConversion<T>(mark);
+  }
+};
+
+template <typename T>
+const value_binder& binder_for() {
+  static const binder<T> instance;
+  return instance;
+}
+
+template <>
+class binder<std::string> : public typed_binder<std::string> {
+ public:
+  void scalar(void* object, const Mark& /* mark */,
+              std::string& value) const override {
+    *static_cast<std::string*>(object) = std::move(value);
+  }
+  void null(void* object, const Mark& /* mark */) const override {
+    *static_cast<std::string*>(object) = "null";  // as Node::as<std::string>
+  }
+};
+
+template <>
+class binder<bool> : public typed_binder<bool> {
+ public:
+  void scalar(void* object, const Mark& mark,
+              std::string& value) const override {
+    if (!conversion::DecodeBool(value, *static_cast<bool*>(object)))
+      throw TypedBadConversion<bool>(mark);
+  }
+};
+
+template <typename T>
+class binder<T, typename std::enable_if<std::is_arithmetic<T>::value &&
+                                        !std::is_same<T, bool>::value>::type>
+    : public typed_binder<T> {
+ public:
+  void scalar(void* object, const Mark& mark,
+              std::string& value) const override {
+    if (!conversion::DecodeNumber(value, *static_cast<T*>(object)))
+      throw TypedBadConversion<T>(mark);
+  }
+};
+
+// (a null sequence or map is empty)
+template <typename T, typename A>
+class binder<std::vector<T, A>> : public typed_binder<std::vector<T, A>> {
+ public:
+  void null(void* object, const Mark& /* mark */) const override {
+    static_cast<std::vector<T, A>*>(object)->clear();
+  }
+
+  void begin_sequence(void* object, const Mark& /* mark */) const override {
+    static_cast<std::vector<T, A>*>(object)->clear();
+  }
+  bind_target element(void* object) const override {
+    std::vector<T, A>& elements = *static_cast<std::vector<T, A>*>(object);
+    elements.emplace_back();
+    return bind_target(&binder_for<T>(), &elements.back());
+  }
+};
+
+template <typename K, typename V, typename C, typename A>
+class binder<std::map<K, V, C, A>> : public typed_binder<std::map<K, V, C, A>> {
+ public:
+  void null(void* object, const Mark& /* mark */) const override {
+    static_cast<std::map<K, V, C, A>*>(object)->clear();
+  }
+
+  void begin_map(void* object, const Mark& /* mark */,
+                 std::vector<char>& /* seen */) const override {
+    static_cast<std::map<K, V, C, A>*>(object)->clear();
+  }
+  bind_target entry(void* object, const Mark& mark, std::string& key,
+                    std::vector<char>& /* seen */) const override {
+    K k;
+    binder_for<K>().scalar(&k, mark, key);
+    V& value = (*static_cast<std::map<K, V, C, A>*>(object))[std::move(k)];
+    return bind_target(&binder_for<V>(), &value);
+  }
+};
+
+// field
+// . A field of a struct: its key, and how to get to its member.
+class field {
+ public:
+  field(const std::string& key_, bool optional_)
+      : key(key_), optional(optional_) {}
+  virtual ~field() = default;
+
+  virtual bind_target target(void* object) const = 0;
+
+  const std::string key;
+  const bool optional;
+};
+
+template <typename T, typename M>
+class member_field : public field {
+ public:
+  member_field(const std::string& key_, bool optional_, M T::*member)
+      : field(key_, optional_), m_member(member) {}
+
+  bind_target target(void* object) const override {
+    bind_target target(&binder_for<M>(), &(static_cast<T*>(object)->*m_member));
+    target.optional = optional;
+    return target;
+  }
+
+ private:
+  M T::*m_member;
+};
+
+using field_list = std::vector<std::unique_ptr<const field>>;
+
+// struct_binder
+// . Binds a map to a struct, by its binding<T>; keys that aren't fields are
+//   skipped.
+// . The fields are sorted by key, and looked up by binary search.
+template <typename T>
+class binder<T, typename std::enable_if<has_binding<T>::value>::type>
+    : public typed_binder<T> {
+ public:
+  binder() : m_fields{} {
+    Fields<T> fields(m_fields);
+    binding<T>::Describe(fields);
+    std::stable_sort(m_fields.begin(), m_fields.end(),
+                     [](const std::unique_ptr<const field>& lhs,
+                        const std::unique_ptr<const field>& rhs) {
+                       return lhs->key < rhs->key;
+                     });
+  }
+
+  // (a null struct has none of its fields)
+  void null(void* object, const Mark& mark) const override {
+    std::vector<char> seen;
+    begin_map(object, mark, seen);
+    end_map(object, mark, seen);
+  }
+
+  void begin_map(void* /* object */, const Mark& /* mark */,
+                 std::vector<char>& seen) const override {
+    seen.resize(seen.size() + m_fields.size(), 0);
+  }
+  bind_target entry(void* object, const Mark& /* mark */, std::string& key,
+                    std::vector<char>& seen) const override {
+    auto it = std::lower_bound(
+        m_fields.begin(), m_fields.end(), key,
+        [](const std::unique_ptr<const field>& lhs, const std::string& rhs) {
+          return lhs->key < rhs;
+        });
+    if (it == m_fields.end() || (*it)->key != key)
+      return bind_target();
+
+    const std::size_t index = static_cast<std::size_t>(it - m_fields.begin());
+    seen[seen.size() - m_fields.size() + index] = 1;
+    return (*it)->target(object);
+  }
+  void end_map(void* /* object */, const Mark& mark,
+               std::vector<char>& seen) const override {
+    const std::size_t base = seen.size() - m_fields.size();
+    for (std::size_t i = 0; i < m_fields.size(); i++) {
+      if (!m_fields[i]->optional && !seen[base + i])
+        throw KeyNotFound(mark, m_fields[i]->key);
+    }
+    seen.resize(base);
+  }
+
+ private:
+  field_list m_fields;
+};
+}  // namespace detail
+
+/**
+ * The fields of a struct, as given by its {@link binding}. Each field is a
+ * key and the member it's bound to; its type can be a number, bool,
+ * std::string, another struct with a binding, or a std::vector or std::map
+ * of them (or any scalar type with a {@code convert<>}).
+ *
+ * A required field that's missing from a map is an error; an optional one
+ * that's missing (or null) keeps the value it had.
+ */
+template <typename T>
+class Fields {
+ public:
+  explicit Fields(detail::field_list& fields) : m_fields(fields) {}
+
+  template <typename M>
+  Fields& Required(const std::string& key, M T::*member) {
+    m_fields.emplace_back(new detail::member_field<T, M>(key, false, member));
+    return *this;
+  }
+
+  template <typename M>
+  Fields& Optional(const std::string& key, M T::*member) {
+    m_fields.emplace_back(new detail::member_field<T, M>(key, true, member));
+    return *this;
+  }
+
+ private:
+  detail::field_list& m_fields;
+};
+
+/**
+ * An event handler that fills in a value of type T as the events arrive, so
+ * there's no Node in between. Keys that aren't fields of a struct are
+ * skipped, along with their values, without keeping anything from them.
+ *
+ * Aliases can be bound only if they're aliases of scalars, outside the
+ * collections that are skipped.
+ *
+ * @throws {@link RepresentationException} (e.g., {@link TypedBadConversion}
+ *         or {@link KeyNotFound}) if the document doesn't fit the value; it's
+ *         then only partly filled in.
+ */
+template <typename T>
+class BindingHandler : public EventHandler {
+ public:
+  explicit BindingHandler(T& value)
+      : m_root(&detail::binder_for<T>(), &value),
+        m_rootPending(false),
+        m_frames{},
+        m_seen{},
+        m_skipDepth(0),
+        m_anchoredScalars{} {}
+
+  void OnDocumentStart(const Mark& /* mark */) override {
+    m_rootPending = true;
+    m_frames.clear();
+    m_seen.clear();
+    m_skipDepth = 0;
+    m_anchoredScalars.clear();
+  }
+  void OnDocumentEnd() override {}
+
+  void OnNull(const Mark& mark, anchor_t /* anchor */) override {
+    if (m_skipDepth > 0)
+      return;
+    if (InKey()) {
+      SkipEntry();
+      return;
+    }
+
+    const detail::bind_target target = Next();
+    if (target.binder && !target.optional)
+      target.binder->null(target.object, mark);
+  }
+
+  void OnAlias(const Mark& mark, anchor_t anchor) override {
+    if (m_skipDepth > 0)
+      return;
+
+    auto it = m_anchoredScalars.find(anchor);
+    if (it != m_anchoredScalars.end()) {
+      std::string value = it->second;
+      Scalar(mark, value);
+      return;
+    }
+    if (InKey()) {
+      SkipEntry();
+      return;
+    }
+    if (Next().binder)
+      throw RepresentationException(mark, ErrorMsg::UNBOUND_ALIAS);
+  }
+
+  void OnScalar(const Mark& mark, const std::string& /* tag */,
+                anchor_t anchor, const std::string& value) override {
+    if (m_skipDepth > 0)
+      return;
+
+    std::string copy = value;
+    OnOwnedScalar(mark, std::string(), anchor, std::move(copy));
+  }
+  void OnOwnedScalar(const Mark& mark, std::string&& /* tag */,
+                     anchor_t anchor, std::string&& value) override {
+    // (a skipped collection keeps nothing, not even its anchors)
+    if (m_skipDepth > 0)
+      return;
+
+    if (anchor != NullAnchor)
+      m_anchoredScalars[anchor] = value;
+    Scalar(mark, value);
+  }
+
+  void OnSequenceStart(const Mark& mark, const std::string& /* tag */,
+                       anchor_t /* anchor */,
+                       EmitterStyle::value /* style */) override {
+    detail::bind_target target;
+    if (!StartCollection(target))
+      return;
+
+    target.binder->begin_sequence(target.object, mark);
+    m_frames.push_back(Frame(target, mark, false));
+  }
+  void OnSequenceEnd() override {
+    if (m_skipDepth > 0) {
+      m_skipDepth--;
+      return;
+    }
+    m_frames.pop_back();
+  }
+
+  void OnMapStart(const Mark& mark, const std::string& /* tag */,
+                  anchor_t /* anchor */,
+                  EmitterStyle::value /* style */) override {
+    detail::bind_target target;
+    if (!StartCollection(target))
+      return;
+
+    target.binder->begin_map(target.object, mark, m_seen);
+    m_frames.push_back(Frame(target, mark, true));
+  }
+  void OnMapEnd() override {
+    if (m_skipDepth > 0) {
+      m_skipDepth--;
+      return;
+    }
+    const Frame& frame = m_frames.back();
+    frame.target.binder->end_map(frame.target.object, frame.mark, m_seen);
+    m_frames.pop_back();
+  }
+
+ private:
+  // Frame
+  // . A collection that's being filled in; in a map, whether the next node is
+  //   a key, or else, where its value goes.
+  struct Frame {
+    Frame(const detail::bind_target& target_, const Mark& mark_, bool isMap_)
+        : target(target_), mark(mark_), isMap(isMap_), isKey(isMap_), value{} {}
+
+    detail::bind_target target;
+    Mark mark;
+    bool isMap;
+    bool isKey;
+    detail::bind_target value;
+  };
+
+  bool InKey() const { return !m_frames.empty() && m_frames.back().isKey; }
+
+  // SkipEntry
+  // . The key (the current node) isn't a scalar, so neither it nor its value
+  //   is bound.
+  void SkipEntry() {
+    Frame& frame = m_frames.back();
+    frame.isKey = false;
+    frame.value = detail::bind_target();
+  }
+
+  // Next
+  // . Returns where the current node (which isn't a map key) goes.
+  detail::bind_target Next() {
+    if (m_frames.empty()) {
+      if (!m_rootPending)
+        return detail::bind_target();
+      m_rootPending = false;
+      return m_root;
+    }
+
+    Frame& frame = m_frames.back();
+    if (!frame.isMap)
+      return frame.target.binder->element(frame.target.object);
+    frame.isKey = true;
+    return frame.value;
+  }
+
+  void Scalar(const Mark& mark, std::string& value) {
+    if (InKey()) {
+      Frame& frame = m_frames.back();
+      frame.value = frame.target.binder->entry(frame.target.object, mark,
+                                               value, m_seen);
+      frame.isKey = false;
+      return;
+    }
+
+    const detail::bind_target target = Next();
+    if (target.binder)
+      target.binder->scalar(target.object, mark, value);
+  }
+
+  // StartCollection
+  // . Returns false if the collection that's starting is skipped.
+  bool StartCollection(detail::bind_target& target) {
+    if (m_skipDepth > 0) {
+      m_skipDepth++;
+      return false;
+    }
+    if (InKey()) {
+      SkipEntry();
+      m_skipDepth = 1;
+      return false;
+    }
+
+    target = Next();
+    if (!target.binder) {
+      m_skipDepth = 1;
+      return false;
+    }
+    return true;
+  }
+
+ private:
+  detail::bind_target m_root;
+  bool m_rootPending;
+  std::vector<Frame> m_frames;
+  std::vector<char> m_seen;
+  std::size_t m_skipDepth;
+  std::map<anchor_t, std::string> m_anchoredScalars;
+};
+
+/**
+ * Parses the first document of the input stream straight into {@code value},
+ * with a {@link BindingHandler}.
+ *
+ * @return false if there's no document (and {@code value} is untouched)
+ * @throws {@link ParserException} if it is malformed.
+ * @throws {@link RepresentationException} if it doesn't fit {@code value}.
+ */
+template <typename T>
+bool LoadInto(std::istream& input, T& value) {
+  Parser parser(input);
+  BindingHandler<T> handler(value);
+  return parser.HandleNextDocument(handler);
+}
+
+/**
+ * Parses the first document of the input string straight into
+ * {@code value}; see above.
+ */
+template <typename T>
+bool LoadInto(const std::string& input, T& value) {
+  std::stringstream stream(input);
+  return LoadInto(stream, value);
+}
+}  // namespace YAML
+
+#endif  // BINDING_H_62B23520_7C8E_11DE_8A39_0800200C9A66
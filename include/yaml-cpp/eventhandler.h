@@ -7,6 +7,7 @@
 #pragma once
 #endif
 
+#include <cstddef>
 #include <string>
 
 #include "yaml-cpp/anchor.h"
@@ -27,6 +28,25 @@ class EventHandler {
   virtual void OnScalar(const Mark& mark, const std::string& tag,
                         anchor_t anchor, const std::string& value) = 0;
 
+  // What the parser calls for a scalar: it's done with 'tag' and 'value', so
+  // a handler that keeps them can take them instead of copying. By default,
+  // it just passes them on to OnScalar.
+  virtual void OnOwnedScalar(const Mark& mark, std::string&& tag,
+                             anchor_t anchor, std::string&& value) {
+    OnScalar(mark, tag, anchor, value);
+  }
+
+  // Block scalars ('|' and '>') can come in pieces instead, so a huge one
+  // never has to be in memory at once: a handler that returns a non-zero
+  // size here gets OnScalarStart, then OnScalarChunk for each piece (of at
+  // most that many bytes, which may split a UTF-8 character), then
+  // OnScalarEnd, in place of OnScalar. The parser asks once per document.
+  virtual std::size_t ScalarChunkSize() const { return 0; }
+  virtual void OnScalarStart(const Mark& /*mark*/, const std::string& /*tag*/,
+                             anchor_t /*anchor*/) {}
+  virtual void OnScalarChunk(const char* /*data*/, std::size_t /*size*/) {}
+  virtual void OnScalarEnd() {}
+
   virtual void OnSequenceStart(const Mark& mark, const std::string& tag,
                                anchor_t anchor, EmitterStyle::value style) = 0;
   virtual void OnSequenceEnd() = 0;
@@ -10,6 +10,7 @@
 #include "yaml-cpp/mark.h"
 #include "yaml-cpp/noexcept.h"
 #include "yaml-cpp/traits.h"
+#include <cstddef>
 #include <sstream>
 #include <stdexcept>
 #include <string>
@@ -77,6 +78,7 @@ const char* const BAD_DEREFERENCE = "bad dereference";
 const char* const BAD_SUBSCRIPT = "operator[] call on a scalar";
 const char* const BAD_PUSHBACK = "appending to a non-sequence";
 const char* const BAD_INSERT = "inserting in a non-convertible-to-map";
+const char* const UNBOUND_ALIAS = "only aliases of scalars can be bound";
 
 const char* const UNMATCHED_GROUP_TAG = "unmatched group tag";
 const char* const UNEXPECTED_END_SEQ = "unexpected end sequence token";
@@ -87,6 +89,9 @@ const char* const INVALID_ANCHOR = "invalid anchor";
 const char* const INVALID_ALIAS = "invalid alias";
 const char* const INVALID_TAG = "invalid tag";
 const char* const BAD_FILE = "bad file";
+const char* const BAD_SNAPSHOT = "bad snapshot";
+const char* const BAD_DOCUMENT_INDEX = "bad document index";
+const char* const BAD_PATH = "bad path";
 
 template <typename T>
 inline const std::string KEY_NOT_FOUND_WITH_KEY(
@@ -249,6 +254,16 @@ class TypedBadConversion : public BadConversion {
   explicit TypedBadConversion(const Mark& mark_) : BadConversion(mark_) {}
 };
 
+// (thrown by Node::as_array, for the first element that isn't a T)
+template <typename T>
+class TypedBadElementConversion : public TypedBadConversion<T> {
+ public:
+  TypedBadElementConversion(const Mark& mark_, std::size_t index_)
+      : TypedBadConversion<T>(mark_), index(index_) {}
+
+  std::size_t index;
+};
+
 class YAML_CPP_API BadDereference : public RepresentationException {
  public:
   BadDereference()
@@ -298,6 +313,33 @@ class YAML_CPP_API BadFile : public Exception {
   BadFile(const BadFile&) = default;
   ~BadFile() YAML_CPP_NOEXCEPT override;
 };
+
+class YAML_CPP_API BadSnapshot : public Exception {
+ public:
+  explicit BadSnapshot(const std::string& reason)
+      : Exception(Mark::null_mark(),
+                  std::string(ErrorMsg::BAD_SNAPSHOT) + ": " + reason) {}
+  BadSnapshot(const BadSnapshot&) = default;
+  ~BadSnapshot() YAML_CPP_NOEXCEPT override;
+};
+
+class YAML_CPP_API BadDocumentIndex : public Exception {
+ public:
+  explicit BadDocumentIndex(const std::string& reason)
+      : Exception(Mark::null_mark(),
+                  std::string(ErrorMsg::BAD_DOCUMENT_INDEX) + ": " + reason) {}
+  BadDocumentIndex(const BadDocumentIndex&) = default;
+  ~BadDocumentIndex() YAML_CPP_NOEXCEPT override;
+};
+
+class YAML_CPP_API BadPath : public Exception {
+ public:
+  explicit BadPath(const std::string& reason)
+      : Exception(Mark::null_mark(),
+                  std::string(ErrorMsg::BAD_PATH) + ": " + reason) {}
+  BadPath(const BadPath&) = default;
+  ~BadPath() YAML_CPP_NOEXCEPT override;
+};
 }  // namespace YAML
 
 #endif  // EXCEPTIONS_H_62B23520_7C8E_11DE_8A39_0800200C9A66
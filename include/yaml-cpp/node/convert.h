@@ -143,9 +143,192 @@ ConvertStreamTo(std::stringstream& stream, T& rhs) {
   }
   return false;
 }
+
+template <typename T>
+typename std::enable_if<std::is_floating_point<T>::value, bool>::type
+DecodeSpecialFloat(const std::string& input, T& rhs) {
+  if (IsInfinity(input)) {
+    rhs = std::numeric_limits<T>::infinity();
+    return true;
+  } else if (IsNegativeInfinity(input)) {
+    rhs = -std::numeric_limits<T>::infinity();
+    return true;
+  } else if (IsNaN(input)) {
+    rhs = std::numeric_limits<T>::quiet_NaN();
+    return true;
+  }
+  return false;
+}
+
+template <typename T>
+typename std::enable_if<!std::is_floating_point<T>::value, bool>::type
+DecodeSpecialFloat(const std::string& /* input */, T& /* rhs */) {
+  return false;
+}
+
+// ParseDecimal
+// . Reads a plain decimal number (with an optional '-', and for floating
+//   point, a fraction and exponent) without a stream, when the result is
+//   sure to be what the stream would read; otherwise, it returns false, and
+//   leaves the number to the stream.
+// . Integers with a leading 0 (octal or hex to the stream) or that overflow
+//   go to the stream.
+template <typename T>
+typename std::enable_if<std::is_integral<T>::value && (sizeof(T) > 1) &&
+                            !std::is_same<T, bool>::value,
+                        bool>::type
+ParseDecimal(const std::string& input, T& rhs) {
+  std::size_t i = 0;
+  const bool negative = !input.empty() && input[0] == '-';
+  if (negative) {
+    if (std::is_unsigned<T>::value)
+      return false;
+    i++;
+  }
+  if (i == input.size() || input[i] < '0' || input[i] > '9')
+    return false;
+  if (input[i] == '0' && i + 1 != input.size())
+    return false;
+
+  const unsigned long long max =
+      static_cast<unsigned long long>((std::numeric_limits<T>::max)());
+  const unsigned long long limit = negative ? max + 1 : max;
+  unsigned long long value = 0;
+  for (; i < input.size(); i++) {
+    if (input[i] < '0' || input[i] > '9')
+      return false;
+    const unsigned digit = static_cast<unsigned>(input[i] - '0');
+    if (value > (limit - digit) / 10)
+      return false;
+    value = value * 10 + digit;
+  }
+
+  if (negative && value > 0)
+    rhs = static_cast<T>(-static_cast<T>(value - 1) - 1);
+  else
+    rhs = static_cast<T>(value);
+  return true;
+}
+
+// (the exact powers of ten, for the floating point ParseDecimal)
+inline double ExactPowerOfTen(int exponent) {
+  static const double powers[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,
+                                  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+                                  1e12, 1e13, 1e14, 1e15, 1e16, 1e17,
+                                  1e18, 1e19, 1e20, 1e21, 1e22};
+  return powers[exponent];
+}
+
+// . A floating point number is read this way only if its digits (as an
+//   integer) and the power of ten it's scaled by are both exact in T; then
+//   one multiplication or division rounds it correctly, as the stream does.
+template <typename T>
+typename std::enable_if<std::is_floating_point<T>::value, bool>::type
+ParseDecimal(const std::string& input, T& rhs) {
+  const int bits = std::numeric_limits<T>::digits < 53
+                       ? std::numeric_limits<T>::digits
+                       : 53;
+  const unsigned long long maxMantissa = 1ull << bits;
+  const int maxExponent = bits < 53 ? 10 : 22;
+
+  std::size_t i = 0;
+  const bool negative = !input.empty() && input[0] == '-';
+  if (negative)
+    i++;
+
+  unsigned long long mantissa = 0;
+  int exponent = 0;
+  std::size_t digits = 0;
+  for (; i < input.size() && input[i] >= '0' && input[i] <= '9'; i++) {
+    mantissa = mantissa * 10 + static_cast<unsigned>(input[i] - '0');
+    if (mantissa > maxMantissa)
+      return false;
+    digits++;
+  }
+  if (digits == 0)
+    return false;
+
+  if (i < input.size() && input[i] == '.') {
+    i++;
+    digits = 0;
+    for (; i < input.size() && input[i] >= '0' && input[i] <= '9'; i++) {
+      mantissa = mantissa * 10 + static_cast<unsigned>(input[i] - '0');
+      if (mantissa > maxMantissa)
+        return false;
+      exponent--;
+      digits++;
+    }
+    if (digits == 0)
+      return false;
+  }
+
+  if (i < input.size() && (input[i] == 'e' || input[i] == 'E')) {
+    i++;
+    const bool negativeExponent = i < input.size() && input[i] == '-';
+    if (i < input.size() && (input[i] == '-' || input[i] == '+'))
+      i++;
+    int value = 0;
+    digits = 0;
+    for (; i < input.size() && input[i] >= '0' && input[i] <= '9'; i++) {
+      value = value * 10 + (input[i] - '0');
+      if (value > 1000)
+        return false;
+      digits++;
+    }
+    if (digits == 0)
+      return false;
+    exponent += negativeExponent ? -value : value;
+  }
+
+  if (i != input.size() || exponent < -maxExponent || exponent > maxExponent)
+    return false;
+
+  T value = static_cast<T>(mantissa);
+  if (exponent < 0)
+    value /= static_cast<T>(ExactPowerOfTen(-exponent));
+  else
+    value *= static_cast<T>(ExactPowerOfTen(exponent));
+  rhs = negative ? -value : value;
+  return true;
+}
+
+// . Characters (which the stream reads as characters, not numbers) always go
+//   to the stream.
+template <typename T>
+typename std::enable_if<!std::is_floating_point<T>::value &&
+                            !(std::is_integral<T>::value && (sizeof(T) > 1) &&
+                              !std::is_same<T, bool>::value),
+                        bool>::type
+ParseDecimal(const std::string& /* input */, T& /* rhs */) {
+  return false;
+}
+
+// DecodeNumber
+// . What convert<T>::decode does with a numeric scalar, for callers that have
+//   the scalar itself, and not a Node.
+template <typename T>
+bool DecodeNumber(const std::string& input, T& rhs) {
+  if (ParseDecimal(input, rhs)) {
+    return true;
+  }
+
+  std::stringstream stream(input);
+  stream.unsetf(std::ios::dec);
+  if ((stream.peek() == '-') && std::is_unsigned<T>::value) {
+    return false;
+  }
+  if (ConvertStreamTo(stream, rhs)) {
+    return true;
+  }
+  return DecodeSpecialFloat(input, rhs);
 }
 
-#define YAML_DEFINE_CONVERT_STREAMABLE(type, negative_op)                  \
+// DecodeBool
+// . Likewise, for convert<bool>::decode.
+YAML_CPP_API bool DecodeBool(const std::string& input, bool& rhs);
+}
+
+#define YAML_DEFINE_CONVERT_STREAMABLE(type)                               \
   template <>                                                              \
   struct convert<type> {                                                   \
                                                                            \
@@ -160,61 +343,27 @@ ConvertStreamTo(std::stringstream& stream, T& rhs) {
       if (node.Type() != NodeType::Scalar) {                               \
         return false;                                                      \
       }                                                                    \
-      const std::string& input = node.Scalar();                            \
-      std::stringstream stream(input);                                     \
-      stream.unsetf(std::ios::dec);                                        \
-      if ((stream.peek() == '-') && std::is_unsigned<type>::value) {       \
-        return false;                                                      \
-      }                                                                    \
-      if (conversion::ConvertStreamTo(stream, rhs)) {                      \
-        return true;                                                       \
-      }                                                                    \
-      if (std::numeric_limits<type>::has_infinity) {                       \
-        if (conversion::IsInfinity(input)) {                               \
-          rhs = std::numeric_limits<type>::infinity();                     \
-          return true;                                                     \
-        } else if (conversion::IsNegativeInfinity(input)) {                \
-          rhs = negative_op std::numeric_limits<type>::infinity();         \
-          return true;                                                     \
-        }                                                                  \
-      }                                                                    \
-                                                                           \
-      if (std::numeric_limits<type>::has_quiet_NaN) {                      \
-        if (conversion::IsNaN(input)) {                                    \
-          rhs = std::numeric_limits<type>::quiet_NaN();                    \
-          return true;                                                     \
-        }                                                                  \
-      }                                                                    \
-                                                                           \
-      return false;                                                        \
+      return conversion::DecodeNumber(node.Scalar(), rhs);                 \
     }                                                                      \
   }
 
-#define YAML_DEFINE_CONVERT_STREAMABLE_SIGNED(type) \
-  YAML_DEFINE_CONVERT_STREAMABLE(type, -)
-
-#define YAML_DEFINE_CONVERT_STREAMABLE_UNSIGNED(type) \
-  YAML_DEFINE_CONVERT_STREAMABLE(type, +)
-
-YAML_DEFINE_CONVERT_STREAMABLE_SIGNED(int);
-YAML_DEFINE_CONVERT_STREAMABLE_SIGNED(short);
-YAML_DEFINE_CONVERT_STREAMABLE_SIGNED(long);
-YAML_DEFINE_CONVERT_STREAMABLE_SIGNED(long long);
-YAML_DEFINE_CONVERT_STREAMABLE_UNSIGNED(unsigned);
-YAML_DEFINE_CONVERT_STREAMABLE_UNSIGNED(unsigned short);
-YAML_DEFINE_CONVERT_STREAMABLE_UNSIGNED(unsigned long);
-YAML_DEFINE_CONVERT_STREAMABLE_UNSIGNED(unsigned long long);
+YAML_DEFINE_CONVERT_STREAMABLE(int);
+YAML_DEFINE_CONVERT_STREAMABLE(short);
+YAML_DEFINE_CONVERT_STREAMABLE(long);
+YAML_DEFINE_CONVERT_STREAMABLE(long long);
+YAML_DEFINE_CONVERT_STREAMABLE(unsigned);
+YAML_DEFINE_CONVERT_STREAMABLE(unsigned short);
+YAML_DEFINE_CONVERT_STREAMABLE(unsigned long);
+YAML_DEFINE_CONVERT_STREAMABLE(unsigned long long);
 
-YAML_DEFINE_CONVERT_STREAMABLE_SIGNED(char);
-YAML_DEFINE_CONVERT_STREAMABLE_SIGNED(signed char);
-YAML_DEFINE_CONVERT_STREAMABLE_UNSIGNED(unsigned char);
+YAML_DEFINE_CONVERT_STREAMABLE(char);
+YAML_DEFINE_CONVERT_STREAMABLE(signed char);
+YAML_DEFINE_CONVERT_STREAMABLE(unsigned char);
 
-YAML_DEFINE_CONVERT_STREAMABLE_SIGNED(float);
-YAML_DEFINE_CONVERT_STREAMABLE_SIGNED(double);
-YAML_DEFINE_CONVERT_STREAMABLE_SIGNED(long double);
+YAML_DEFINE_CONVERT_STREAMABLE(float);
+YAML_DEFINE_CONVERT_STREAMABLE(double);
+YAML_DEFINE_CONVERT_STREAMABLE(long double);
 
-#undef YAML_DEFINE_CONVERT_STREAMABLE_SIGNED
-#undef YAML_DEFINE_CONVERT_STREAMABLE_UNSIGNED
 #undef YAML_DEFINE_CONVERT_STREAMABLE
 
 // bool
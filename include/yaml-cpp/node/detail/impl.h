@@ -105,18 +105,22 @@ inline bool node::equals(const T& rhs, shared_memory_holder pMemory) {
   return false;
 }
 
-inline bool node::equals(const char* rhs, shared_memory_holder pMemory) {
-  std::string lhs;
-  if (convert<std::string>::decode(Node(*this, std::move(pMemory)), lhs)) {
-    return lhs == rhs;
-  }
-  return false;
+// (a string key is compared with the scalar in place, rather than with a
+// copy decoded from it, which is most of what looking up a key costs)
+inline bool node::equals(const std::string& rhs,
+                         shared_memory_holder /* pMemory */) {
+  return type() == NodeType::Scalar && scalar() == rhs;
+}
+
+inline bool node::equals(const char* rhs, shared_memory_holder /* pMemory */) {
+  return type() == NodeType::Scalar && scalar() == rhs;
 }
 
 // indexing
 template <typename Key>
 inline node* node_data::get(const Key& key,
                             shared_memory_holder pMemory) const {
+  load();
   switch (m_type) {
     case NodeType::Map:
       break;
@@ -128,7 +132,7 @@ inline node* node_data::get(const Key& key,
         return pNode;
       return nullptr;
     case NodeType::Scalar:
-      throw BadSubscript(m_mark, key);
+      throw BadSubscript(mark(), key);
   }
 
   auto it = std::find_if(m_map.begin(), m_map.end(), [&](const kv_pair m) {
@@ -140,6 +144,7 @@ inline node* node_data::get(const Key& key,
 
 template <typename Key>
 inline node& node_data::get(const Key& key, shared_memory_holder pMemory) {
+  load();
   switch (m_type) {
     case NodeType::Map:
       break;
@@ -154,7 +159,7 @@ inline node& node_data::get(const Key& key, shared_memory_holder pMemory) {
       convert_to_map(pMemory);
       break;
     case NodeType::Scalar:
-      throw BadSubscript(m_mark, key);
+      throw BadSubscript(mark(), key);
   }
 
   auto it = std::find_if(m_map.begin(), m_map.end(), [&](const kv_pair m) {
@@ -173,6 +178,7 @@ inline node& node_data::get(const Key& key, shared_memory_holder pMemory) {
 
 template <typename Key>
 inline bool node_data::remove(const Key& key, shared_memory_holder pMemory) {
+  load();
   if (m_type == NodeType::Sequence) {
     return remove_idx<Key>::remove(m_sequence, key, m_seqSize);
   }
@@ -204,6 +210,7 @@ inline bool node_data::remove(const Key& key, shared_memory_holder pMemory) {
 template <typename Key, typename Value>
 inline void node_data::force_insert(const Key& key, const Value& value,
                                     shared_memory_holder pMemory) {
+  load();
   switch (m_type) {
     case NodeType::Map:
       break;
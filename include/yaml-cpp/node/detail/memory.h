@@ -7,6 +7,7 @@
 #pragma once
 #endif
 
+#include <cstddef>
 #include <set>
 
 #include "yaml-cpp/dll.h"
@@ -25,6 +26,7 @@ class YAML_CPP_API memory {
   memory() : m_nodes{} {}
   node& create_node();
   void merge(const memory& rhs);
+  std::size_t size() const { return m_nodes.size(); }
 
  private:
   using Nodes = std::set<shared_node>;
@@ -37,6 +39,8 @@ class YAML_CPP_API memory_holder {
 
   node& create_node() { return m_pMemory->create_node(); }
   void merge(memory_holder& rhs);
+  // the number of nodes it holds
+  std::size_t size() const { return m_pMemory->size(); }
 
  private:
   shared_memory m_pMemory;
@@ -41,6 +41,7 @@ class node {
 
   template <typename T>
   bool equals(const T& rhs, shared_memory_holder pMemory);
+  bool equals(const std::string& rhs, shared_memory_holder pMemory);
   bool equals(const char* rhs, shared_memory_holder pMemory);
 
   void mark_defined() {
@@ -86,10 +87,18 @@ class node {
     mark_defined();
     m_pRef->set_scalar(scalar);
   }
+  void set_scalar(std::string&& scalar) {
+    mark_defined();
+    m_pRef->set_scalar(std::move(scalar));
+  }
   void set_tag(const std::string& tag) {
     mark_defined();
     m_pRef->set_tag(tag);
   }
+  void set_tag(std::string&& tag) {
+    mark_defined();
+    m_pRef->set_tag(std::move(tag));
+  }
 
   // style
   void set_style(EmitterStyle::value style) {
@@ -97,6 +106,12 @@ class node {
     m_pRef->set_style(style);
   }
 
+  // lazy
+  void set_lazy(const shared_lazy_collection& pLazy) {
+    mark_defined();
+    m_pRef->set_lazy(pLazy);
+  }
+
   // size/iterator
   std::size_t size() const { return m_pRef->size(); }
 
@@ -114,7 +129,7 @@ class node {
   void push_back(node& input, shared_memory_holder pMemory) {
     m_pRef->push_back(input, pMemory);
     input.add_dependency(*this);
-    m_index = m_amount.fetch_add(1);
+    m_index = next_index();
   }
   void insert(node& key, node& value, shared_memory_holder pMemory) {
     m_pRef->insert(key, value, pMemory);
@@ -169,6 +184,10 @@ class node {
   using nodes = std::set<node*, less>;
   nodes m_dependencies;
   size_t m_index;
+
+  // (each thread takes the indices from m_amount in blocks, so threads that
+  // build nodes at once don't all keep writing to it)
+  static size_t next_index();
   static std::atomic<size_t> m_amount;
 };
 }  // namespace detail
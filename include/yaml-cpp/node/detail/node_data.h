@@ -7,6 +7,7 @@
 #pragma once
 #endif
 
+#include <atomic>
 #include <list>
 #include <map>
 #include <string>
@@ -32,17 +33,25 @@ class YAML_CPP_API node_data {
   node_data();
   node_data(const node_data&) = delete;
   node_data& operator=(const node_data&) = delete;
+  ~node_data();
 
   void mark_defined();
   void set_mark(const Mark& mark);
   void set_type(NodeType::value type);
   void set_tag(const std::string& tag);
+  void set_tag(std::string&& tag);
   void set_null();
   void set_scalar(const std::string& scalar);
+  void set_scalar(std::string&& scalar);
   void set_style(EmitterStyle::value style);
+  void set_lazy(const shared_lazy_collection& pLazy);
 
   bool is_defined() const { return m_isDefined; }
+#ifndef YAML_CPP_NO_NODE_MARKS
   const Mark& mark() const { return m_mark; }
+#else
+  const Mark& mark() const { return no_mark(); }
+#endif
   NodeType::value type() const {
     return m_isDefined ? m_type : NodeType::Undefined;
   }
@@ -82,8 +91,17 @@ class YAML_CPP_API node_data {
 
  public:
   static const std::string& empty_scalar();
+  static const Mark& no_mark();
 
  private:
+  // a lazy collection is parsed the first time anything looks inside it
+  void load() const {
+    if (m_isLazy.load(std::memory_order_acquire))
+      load_lazy();
+  }
+  void load_lazy() const;
+  void drop_lazy();
+
   void compute_seq_size() const;
   void compute_map_size() const;
 
@@ -99,7 +117,18 @@ class YAML_CPP_API node_data {
 
  private:
   bool m_isDefined;
+  // (a lazy collection is kept apart, in lazyload.cpp's table, since few
+  // nodes have one; m_hasLazy is whether this one has, and m_isLazy whether
+  // it's still to be parsed)
+  bool m_hasLazy;
+  mutable std::atomic<bool> m_isLazy;
+  // (a whole mark, not just its offset, since a node has no way to reach
+  // its document's line breaks; built with YAML_CPP_NO_NODE_MARKS, nodes
+  // don't keep where they were parsed from, and mark() is always the null
+  // mark)
+#ifndef YAML_CPP_NO_NODE_MARKS
   Mark m_mark;
+#endif
   NodeType::value m_type;
   std::string m_tag;
   EmitterStyle::value m_style;
@@ -33,9 +33,16 @@ class node_ref {
   void set_mark(const Mark& mark) { m_pData->set_mark(mark); }
   void set_type(NodeType::value type) { m_pData->set_type(type); }
   void set_tag(const std::string& tag) { m_pData->set_tag(tag); }
+  void set_tag(std::string&& tag) { m_pData->set_tag(std::move(tag)); }
   void set_null() { m_pData->set_null(); }
   void set_scalar(const std::string& scalar) { m_pData->set_scalar(scalar); }
+  void set_scalar(std::string&& scalar) {
+    m_pData->set_scalar(std::move(scalar));
+  }
   void set_style(EmitterStyle::value style) { m_pData->set_style(style); }
+  void set_lazy(const shared_lazy_collection& pLazy) {
+    m_pData->set_lazy(pLazy);
+  }
 
   // size/iterator
   std::size_t size() const { return m_pData->size(); }
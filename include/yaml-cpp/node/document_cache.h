@@ -0,0 +1,90 @@
+#ifndef NODE_DOCUMENT_CACHE_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+#define NODE_DOCUMENT_CACHE_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+
+#if defined(_MSC_VER) ||                                            \
+    (defined(__GNUC__) && (__GNUC__ == 3 && __GNUC_MINOR__ >= 4) || \
+     (__GNUC__ >= 4))  // GCC supports "pragma once" correctly since 3.4
+#pragma once
+#endif
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+#include "yaml-cpp/dll.h"
+#include "yaml-cpp/node/node.h"
+
+namespace YAML {
+namespace detail {
+struct document_cache_data;
+}  // namespace detail
+
+/**
+ * A cache of the documents of files, for the threads of a process to share:
+ * each file is loaded once, and everyone who asks for it gets the same
+ * document, until the file changes.
+ *
+ * Each time a file is asked for, its size and modification time are checked
+ * (and, if it was modified about when it was read, or they changed, its
+ * contents are hashed, and it's only parsed again if they did change). Two
+ * files with the same contents share a document.
+ *
+ * Threads that ask for documents that are loaded take no lock, so they
+ * don't wait for each other or for loading; one that asks for a file that
+ * another is loading waits for that. When the documents take up more than
+ * the cache's limit, the ones that were asked for least recently are
+ * dropped.
+ *
+ * Each document loaded (or dropped) copies the cache's list of files (their
+ * names, and pointers to their documents), which readers share, so filling
+ * a cache with n files copies O(n^2) names; it's meant for some thousands
+ * of files, not millions.
+ *
+ * A document is shared, so it mustn't be changed, including through a copy
+ * of it (which shares its nodes); Clone it to have one to change. Reading
+ * it is safe from any number of threads at once.
+ */
+class YAML_CPP_API DocumentCache {
+ public:
+  /**
+   * @param maxBytes about the most memory the documents (and the files they
+   *        were loaded from) may take up; 0 means no limit. The document
+   *        just loaded is kept even if it alone is bigger than this.
+   */
+  explicit DocumentCache(std::size_t maxBytes = 256 << 20);
+  DocumentCache(const DocumentCache&) = delete;
+  DocumentCache& operator=(const DocumentCache&) = delete;
+  ~DocumentCache();
+
+  /**
+   * Returns the file's document, loaded as a single YAML document (like
+   * {@link LoadFile}, but an empty file is a null node), from the cache if
+   * the file hasn't changed. It stays valid after it's dropped from the
+   * cache.
+   *
+   * @throws {@link ParserException} if it is malformed.
+   * @throws {@link BadFile} if the file cannot be loaded.
+   */
+  std::shared_ptr<const Node> Get(const std::string& filename);
+
+  /**
+   * Drops the file's document, so it's loaded again the next time it's
+   * asked for. (Those that have it keep it.)
+   */
+  void Invalidate(const std::string& filename);
+
+  /** Drops every document. */
+  void Clear();
+
+  /** The number of files with documents in the cache. */
+  std::size_t size() const;
+
+  /** About how much memory the documents in the cache take up. */
+  std::size_t bytes() const;
+
+ private:
+  std::unique_ptr<detail::document_cache_data> m_pData;
+};
+}  // namespace YAML
+
+#endif  // NODE_DOCUMENT_CACHE_H_62B23520_7C8E_11DE_8A39_0800200C9A66
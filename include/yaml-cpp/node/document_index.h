@@ -0,0 +1,134 @@
+#ifndef NODE_DOCUMENT_INDEX_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+#define NODE_DOCUMENT_INDEX_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+
+#if defined(_MSC_VER) ||                                            \
+    (defined(__GNUC__) && (__GNUC__ == 3 && __GNUC_MINOR__ >= 4) || \
+     (__GNUC__ >= 4))  // GCC supports "pragma once" correctly since 3.4
+#pragma once
+#endif
+
+#include <cstddef>
+#include <iosfwd>
+#include <memory>
+#include <string>
+
+#include "yaml-cpp/dll.h"
+
+namespace YAML {
+class DocumentIndexer;
+class Node;
+
+namespace detail {
+struct document_index_data;
+}  // namespace detail
+
+/**
+ * Where the documents of a multi-document stream start, so that any one of
+ * them can be loaded (with LoadDocument) without parsing the ones before it.
+ *
+ * An index is only good for the stream it was built from, as it was then;
+ * LoadDocument checks what it cheaply can (e.g., that the stream is still the
+ * same size), but not the whole stream.
+ */
+class YAML_CPP_API DocumentIndex {
+ public:
+  /** Constructs the index of a stream with no documents. */
+  DocumentIndex();
+
+  /** Returns the number of documents in the stream. */
+  std::size_t size() const;
+
+ private:
+  friend class DocumentIndexer;
+  explicit DocumentIndex(
+      std::shared_ptr<const detail::document_index_data> pData);
+
+ private:
+  std::shared_ptr<const detail::document_index_data> m_pData;
+};
+
+/**
+ * Indexes the documents of the input string. It only looks for document
+ * markers and directives at the start of each line, rather than parsing
+ * (and so it doesn't check the documents are well-formed); but a stream that
+ * can't be cut that way (e.g., one in UTF-16) is parsed to count its
+ * documents, and LoadDocument then parses it from the start.
+ *
+ * It counts the documents as the YAML spec has them, which is how LoadAll
+ * does too, except for a document with more after its root node ends (e.g.,
+ * a scalar, a comment and another scalar), which LoadAll reads as two; for
+ * such a stream, LoadDocument throws rather than give the wrong document.
+ *
+ * @throws {@link ParserException} if it must be parsed, and is malformed.
+ */
+YAML_CPP_API DocumentIndex BuildDocumentIndex(const std::string& input);
+
+/**
+ * Indexes the documents of the file. If {@code indexFilename} is given, the
+ * index saved there is used instead, if it's for a file with these contents
+ * (which it keeps the size and a hash of); or else the new index is saved
+ * there (if it can be). Either way, the file is read in full.
+ *
+ * @throws {@link ParserException} if the file must be parsed, and is
+ *         malformed.
+ * @throws {@link BadFile} if the file cannot be loaded.
+ */
+YAML_CPP_API DocumentIndex BuildDocumentIndexFile(
+    const std::string& filename, const std::string& indexFilename = "");
+
+/** Writes the index, in a line-based text format. */
+YAML_CPP_API void SaveDocumentIndex(const DocumentIndex& index,
+                                    std::ostream& output);
+
+/**
+ * Writes the index to a file.
+ *
+ * @throws {@link BadFile} if the file cannot be written.
+ */
+YAML_CPP_API void SaveDocumentIndexFile(const DocumentIndex& index,
+                                        const std::string& filename);
+
+/**
+ * Reads an index written by SaveDocumentIndex.
+ *
+ * @throws {@link BadDocumentIndex} if it isn't an index, or is damaged.
+ */
+YAML_CPP_API DocumentIndex LoadDocumentIndex(std::istream& input);
+
+/**
+ * Reads an index from a file.
+ *
+ * @throws {@link BadDocumentIndex} if it isn't an index, or is damaged.
+ * @throws {@link BadFile} if the file cannot be loaded.
+ */
+YAML_CPP_API DocumentIndex LoadDocumentIndexFile(const std::string& filename);
+
+/**
+ * Loads document {@code n} (counting from 0) of the input stream, which must
+ * be seekable, and the stream {@code index} was built from. Only the
+ * documents that start at the same cut as it are parsed, and only the text
+ * up to the next cut is read; the document's marks are where it is in the
+ * whole stream.
+ *
+ * @return the document, or an undefined node if there are only {@code n}
+ *         documents or fewer
+ * @throws {@link ParserException} if the document is malformed.
+ * @throws {@link BadDocumentIndex} if the index isn't for this stream, or
+ *         the documents it counted at that cut aren't the ones LoadAll would
+ *         read there.
+ */
+YAML_CPP_API Node LoadDocument(std::istream& input, const DocumentIndex& index,
+                               std::size_t n);
+
+/**
+ * Loads document {@code n} of the file {@code index} was built from.
+ *
+ * @throws {@link ParserException} if the document is malformed.
+ * @throws {@link BadDocumentIndex} if the index isn't for this file.
+ * @throws {@link BadFile} if the file cannot be loaded.
+ */
+YAML_CPP_API Node LoadDocument(const std::string& filename,
+                               const DocumentIndex& index, std::size_t n);
+}  // namespace YAML
+
+#endif  // NODE_DOCUMENT_INDEX_H_62B23520_7C8E_11DE_8A39_0800200C9A66
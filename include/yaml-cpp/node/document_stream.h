@@ -0,0 +1,122 @@
+#ifndef NODE_DOCUMENT_STREAM_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+#define NODE_DOCUMENT_STREAM_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+
+#if defined(_MSC_VER) ||                                            \
+    (defined(__GNUC__) && (__GNUC__ == 3 && __GNUC_MINOR__ >= 4) || \
+     (__GNUC__ >= 4))  // GCC supports "pragma once" correctly since 3.4
+#pragma once
+#endif
+
+#include <cstddef>
+#include <iosfwd>
+#include <iterator>
+#include <memory>
+
+#include "yaml-cpp/dll.h"
+#include "yaml-cpp/node/node.h"
+#include "yaml-cpp/noexcept.h"
+
+namespace YAML {
+class Parser;
+
+/**
+ * The documents of a YAML stream, read one at a time, as a single-pass range.
+ *
+ * Each document is parsed when the iterator gets to it, and nothing else is
+ * kept from it, so a document is freed as soon as the caller lets go of it;
+ * memory use doesn't grow with the number of documents.
+ *
+ * The input stream must live as long as this does.
+ */
+class YAML_CPP_API DocumentStream {
+ public:
+  class iterator;
+
+  explicit DocumentStream(std::istream& input);
+  DocumentStream(DocumentStream&& rhs) YAML_CPP_NOEXCEPT;
+  DocumentStream& operator=(DocumentStream&& rhs) YAML_CPP_NOEXCEPT;
+  DocumentStream(const DocumentStream&) = delete;
+  DocumentStream& operator=(const DocumentStream&) = delete;
+  ~DocumentStream();
+
+  /**
+   * Reads the next document, and returns an iterator to it (or end() if there
+   * are no more). Like any input iterator, it's invalidated when another one
+   * for this stream is incremented.
+   *
+   * @throws {@link ParserException} if the next document is malformed.
+   */
+  iterator begin();
+  iterator end();
+
+ private:
+  /**
+   * Reads the next document.
+   *
+   * @return null if there are no more documents
+   */
+  std::shared_ptr<const Node> Next();
+
+  std::unique_ptr<Parser> m_pParser;
+};
+
+class DocumentStream::iterator {
+ public:
+  using iterator_category = std::input_iterator_tag;
+  using value_type = Node;
+  using difference_type = std::ptrdiff_t;
+  using pointer = const Node*;
+  using reference = const Node&;
+
+  iterator() : m_pStream(nullptr), m_pDocument{} {}
+  iterator(const iterator&) = default;
+  iterator& operator=(const iterator&) = default;
+
+  reference operator*() const { return *m_pDocument; }
+  pointer operator->() const { return m_pDocument.get(); }
+
+  /** @throws {@link ParserException} if the next document is malformed. */
+  iterator& operator++() {
+    // (the document is replaced rather than assigned to, since assigning to
+    // a Node would change the one the caller may still have)
+    m_pDocument = m_pStream->Next();
+    if (!m_pDocument) {
+      m_pStream = nullptr;
+    }
+    return *this;
+  }
+
+  iterator operator++(int) {
+    iterator previous(*this);
+    ++*this;
+    return previous;
+  }
+
+  friend bool operator==(const iterator& lhs, const iterator& rhs) {
+    return lhs.m_pStream == rhs.m_pStream;
+  }
+  friend bool operator!=(const iterator& lhs, const iterator& rhs) {
+    return !(lhs == rhs);
+  }
+
+ private:
+  friend class DocumentStream;
+  explicit iterator(DocumentStream* pStream)
+      : m_pStream(pStream), m_pDocument{} {}
+
+  DocumentStream* m_pStream;
+  std::shared_ptr<const Node> m_pDocument;
+};
+
+/**
+ * Returns the documents of the input stream, which are parsed one at a time
+ * as they're iterated over; e.g.,
+ *
+ *   for (const YAML::Node& doc : YAML::Documents(input)) { ... }
+ *
+ * The input stream must outlive the returned range.
+ */
+YAML_CPP_API DocumentStream Documents(std::istream& input);
+}  // namespace YAML
+
+#endif  // NODE_DOCUMENT_STREAM_H_62B23520_7C8E_11DE_8A39_0800200C9A66
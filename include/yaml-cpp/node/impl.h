@@ -163,6 +163,47 @@ inline T Node::as(const S& fallback) const {
   return as_if<T, S>(*this)(fallback);
 }
 
+namespace conversion {
+template <typename T>
+bool DecodeNumber(const std::string& input, T& rhs);  // convert.h
+}
+
+template <typename T, typename A>
+inline void Node::as_array(std::vector<T, A>& out) const {
+  if (!m_isValid)
+    throw InvalidNode(m_invalidKey);
+  if (Type() != NodeType::Sequence)
+    throw TypedBadConversion<std::vector<T, A>>(Mark());
+
+  using is_number =
+      std::integral_constant<bool, std::is_arithmetic<T>::value &&
+                                       !std::is_same<T, bool>::value>;
+  out.clear();
+  out.reserve(m_pNode->size());
+  std::size_t index = 0;
+  for (auto it = m_pNode->begin(); it != m_pNode->end(); ++it, ++index) {
+    detail::node& element = **it;
+    out.emplace_back();
+    if (!DecodeElement(element, out.back(), is_number())) {
+      out.pop_back();
+      throw TypedBadElementConversion<T>(element.mark(), index);
+    }
+  }
+}
+
+template <typename T>
+inline bool Node::DecodeElement(detail::node& element, T& value,
+                                std::true_type /* is_number */) const {
+  return element.type() == NodeType::Scalar &&
+         conversion::DecodeNumber(element.scalar(), value);
+}
+
+template <typename T>
+inline bool Node::DecodeElement(detail::node& element, T& value,
+                                std::false_type /* is_number */) const {
+  return convert<T>::decode(Node(element, m_pMemory), value);
+}
+
 inline const std::string& Node::Scalar() const {
   if (!m_isValid)
     throw InvalidNode(m_invalidKey);
@@ -0,0 +1,65 @@
+#ifndef NODE_LOAD_FILES_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+#define NODE_LOAD_FILES_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+
+#if defined(_MSC_VER) ||                                            \
+    (defined(__GNUC__) && (__GNUC__ == 3 && __GNUC_MINOR__ >= 4) || \
+     (__GNUC__ >= 4))  // GCC supports "pragma once" correctly since 3.4
+#pragma once
+#endif
+
+#include <cstddef>
+#include <exception>
+#include <string>
+#include <vector>
+
+#include "yaml-cpp/dll.h"
+#include "yaml-cpp/node/node.h"
+
+namespace YAML {
+/** How {@link LoadFiles} loads its files. */
+struct YAML_CPP_API LoadFilesOptions {
+  LoadFilesOptions() : numThreads(0), maxBytesInFlight(256 << 20) {}
+
+  /**
+   * The number of threads to load them on (including the calling one); 0
+   * means one per core.
+   */
+  unsigned numThreads;
+
+  /**
+   * The most bytes of files to have read, and not yet parsed, at once; the
+   * threads wait for room before reading another. A file bigger than this is
+   * loaded on its own. 0 means no limit.
+   */
+  std::size_t maxBytesInFlight;
+};
+
+/** A file that {@link LoadFiles} loaded, or the error it threw. */
+struct YAML_CPP_API LoadedFile {
+  LoadedFile() : document{}, error{} {}
+
+  /** The file's document (a null node if it couldn't be loaded). */
+  Node document;
+
+  /**
+   * What loading it threw (e.g., a {@link ParserException} or a
+   * {@link BadFile}), or null if it loaded.
+   */
+  std::exception_ptr error;
+};
+
+/**
+ * Loads each of the files as a single YAML document, like {@link LoadFile}
+ * (from its snapshot, if there's a cache of them), but several at once, on
+ * a pool of threads.
+ *
+ * Each file is read whole, with one read, and parsed from memory. A file
+ * that fails doesn't stop the others: the result has each one's document,
+ * or error, in the order of {@code filenames}.
+ */
+YAML_CPP_API std::vector<LoadedFile> LoadFiles(
+    const std::vector<std::string>& filenames,
+    const LoadFilesOptions& options = LoadFilesOptions());
+}  // namespace YAML
+
+#endif  // NODE_LOAD_FILES_H_62B23520_7C8E_11DE_8A39_0800200C9A66
@@ -9,6 +9,8 @@
 
 #include <stdexcept>
 #include <string>
+#include <type_traits>
+#include <vector>
 
 #include "yaml-cpp/dll.h"
 #include "yaml-cpp/emitterstyle.h"
@@ -30,6 +32,8 @@ class YAML_CPP_API Node {
  public:
   friend class NodeBuilder;
   friend class NodeEvents;
+  friend class Path;
+  friend class PathProjector;
   friend struct detail::iterator_value;
   friend class detail::node;
   friend class detail::node_data;
@@ -68,6 +72,19 @@ class YAML_CPP_API Node {
   T as(const S& fallback) const;
   const std::string& Scalar() const;
 
+  /**
+   * Decodes a sequence into {@code out}, like as<std::vector<T>>(), but in
+   * place, and without a Node for each element; numbers are read without a
+   * stream, when they're plain decimals.
+   *
+   * @throws {@link TypedBadConversion} if this isn't a sequence.
+   * @throws {@link TypedBadElementConversion} for the first element that
+   *         isn't a T, with its index; {@code out} then has the elements
+   *         before it.
+   */
+  template <typename T, typename A>
+  void as_array(std::vector<T, A>& out) const;
+
   const std::string& Tag() const;
   void SetTag(const std::string& tag);
 
@@ -129,6 +146,13 @@ class YAML_CPP_API Node {
   void AssignData(const Node& rhs);
   void AssignNode(const Node& rhs);
 
+  template <typename T>
+  bool DecodeElement(detail::node& element, T& value,
+                     std::true_type /* is_number */) const;
+  template <typename T>
+  bool DecodeElement(detail::node& element, T& value,
+                     std::false_type /* is_number */) const;
+
  private:
   bool m_isValid;
   // String representation of invalid key, if the node is invalid.
@@ -15,6 +15,7 @@
 
 namespace YAML {
 class Node;
+class Path;
 
 /**
  * Loads the input string as a single YAML document.
@@ -38,13 +39,75 @@ YAML_CPP_API Node Load(const char* input);
 YAML_CPP_API Node Load(std::istream& input);
 
 /**
- * Loads the input file as a single YAML document.
+ * Loads the input file as a single YAML document; or from its snapshot, if
+ * there's a cache of them (see SetSnapshotCacheDirectory).
  *
  * @throws {@link ParserException} if it is malformed.
  * @throws {@link BadFile} if the file cannot be loaded.
  */
 YAML_CPP_API Node LoadFile(const std::string& filename);
 
+/**
+ * Loads the input string as a single YAML document, like {@link Load}, but
+ * lazily: each big block collection is only skimmed (to find where it ends)
+ * until something first looks inside it (e.g., with operator[], size(), or
+ * iteration), and then it's parsed. Its type, tag, style and mark are known
+ * without parsing it.
+ *
+ * An error in a collection that hasn't been parsed is thrown when it is;
+ * and, if it isn't fixed, every time it's looked inside after that.
+ *
+ * A document that can't be skimmed safely (e.g., one with anchors and
+ * aliases, or with directives) is loaded all at once, like {@link Load}.
+ *
+ * A collection is parsed once, under a lock, even if several threads look
+ * inside it at once; so, like a Node from {@link Load}, the result can be
+ * read from several threads at once. (Clone it to have one that's parsed in
+ * full.)
+ *
+ * @throws {@link ParserException} if the parts it parses are malformed.
+ */
+YAML_CPP_API Node LoadLazy(const std::string& input);
+
+/**
+ * Loads the input file as a single YAML document, lazily; see
+ * {@link LoadLazy}.
+ *
+ * @throws {@link ParserException} if the parts it parses are malformed.
+ * @throws {@link BadFile} if the file cannot be loaded.
+ */
+YAML_CPP_API Node LoadFileLazy(const std::string& filename);
+
+/**
+ * Loads just what the paths select from the input string (a single YAML
+ * document), each with everything under it, in the maps and sequences on the
+ * way there; they keep only the entries that lead to something selected,
+ * and a sequence keeps its elements' indices, and its length (with nulls for
+ * those it skips). So the paths select the same nodes from the result,
+ * negative indices included, unless they filter on something that wasn't
+ * kept.
+ *
+ * It's loaded like {@link LoadLazy}, so only the big block collections that
+ * a path goes into are parsed; the rest are only skimmed. (A path with
+ * wildcards or "..", though, goes into everything it can.) Like LoadLazy's,
+ * the result keeps the input, for the collections it hasn't parsed, and can
+ * be read from several threads at once.
+ *
+ * @throws {@link ParserException} if the parts it parses are malformed.
+ */
+YAML_CPP_API Node LoadProjected(const std::string& input,
+                                const std::vector<Path>& paths);
+
+/**
+ * Loads just what the paths select from the input file; see
+ * {@link LoadProjected}.
+ *
+ * @throws {@link ParserException} if the parts it parses are malformed.
+ * @throws {@link BadFile} if the file cannot be loaded.
+ */
+YAML_CPP_API Node LoadFileProjected(const std::string& filename,
+                                    const std::vector<Path>& paths);
+
 /**
  * Loads the input string as a list of YAML documents.
  *
@@ -73,6 +136,40 @@ YAML_CPP_API std::vector<Node> LoadAll(std::istream& input);
  * @throws {@link BadFile} if the file cannot be loaded.
  */
 YAML_CPP_API std::vector<Node> LoadAllFromFile(const std::string& filename);
+
+/**
+ * Loads the input string as a list of YAML documents, like {@link LoadAll},
+ * but parses the documents on up to {@code numThreads} threads (by default,
+ * one per core).
+ *
+ * The documents are found by looking for "---" and "..." at the start of a
+ * line, without parsing; input that can't be split that way (e.g., non-UTF-8
+ * input) is loaded on one thread. Either way, the result, or the error, is
+ * the same as {@link LoadAll}'s.
+ *
+ * @throws {@link ParserException} if it is malformed.
+ */
+YAML_CPP_API std::vector<Node> LoadAllParallel(const std::string& input,
+                                               unsigned numThreads = 0);
+
+/**
+ * Reads the whole input stream, and loads it as a list of YAML documents on
+ * up to {@code numThreads} threads; see {@link LoadAllParallel}.
+ *
+ * @throws {@link ParserException} if it is malformed.
+ */
+YAML_CPP_API std::vector<Node> LoadAllParallel(std::istream& input,
+                                               unsigned numThreads = 0);
+
+/**
+ * Loads the input file as a list of YAML documents on up to
+ * {@code numThreads} threads; see {@link LoadAllParallel}.
+ *
+ * @throws {@link ParserException} if it is malformed.
+ * @throws {@link BadFile} if the file cannot be loaded.
+ */
+YAML_CPP_API std::vector<Node> LoadAllFromFileParallel(
+    const std::string& filename, unsigned numThreads = 0);
 }  // namespace YAML
 
 #endif  // VALUE_PARSE_H_62B23520_7C8E_11DE_8A39_0800200C9A66
@@ -0,0 +1,92 @@
+#ifndef NODE_PATH_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+#define NODE_PATH_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+
+#if defined(_MSC_VER) ||                                            \
+    (defined(__GNUC__) && (__GNUC__ == 3 && __GNUC_MINOR__ >= 4) || \
+     (__GNUC__ >= 4))  // GCC supports "pragma once" correctly since 3.4
+#pragma once
+#endif
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "yaml-cpp/dll.h"
+
+namespace YAML {
+class Node;
+class PathProjector;
+
+namespace detail {
+struct path_data;
+}  // namespace detail
+
+/**
+ * A path expression, compiled once, that selects nodes in a document, like
+ * JSONPath or yq; e.g.,
+ *
+ *   spec.template.containers[0].image
+ *   $.metadata.labels["app.kubernetes.io/name"]
+ *   spec.containers[?(@.name == 'web')].ports[-1]
+ *   ..image
+ *
+ * A path is an optional "$" (the root), and then:
+ * . ".key", or "key" at the start: the value for the scalar key; a key runs
+ *   up to the next ".", "[", "]", "(", ")", "=", "!", quote or space, and
+ *   "['key']" or "[\"key\"]" can hold any of those;
+ * . "[n]": element n of a sequence (or, if it's negative, element n from the
+ *   end);
+ * . ".*" or "[*]": every value of a map, or element of a sequence;
+ * . "..": the rest of the path from the node, and from every node under it
+ *   (e.g., "..key", "..*" or "..[0]");
+ * . "[?(@path)]": every value or element that has a match for the path
+ *   (which is relative to it, and can be just "@"); or, with "== value" or
+ *   "!= value" after it, that has a match that's a scalar equal to the value
+ *   (quoted, or a word, like 80 or true), or has matches and none of them is.
+ *
+ * Selecting walks the nodes directly: it makes no node for each step, and
+ * compares keys by their text, without converting them. The document mustn't
+ * have cycles (which Dump doesn't allow either).
+ */
+class YAML_CPP_API Path {
+ public:
+  /** @throws {@link BadPath} if the expression isn't a valid path. */
+  explicit Path(const std::string& expression);
+
+  const std::string& Expression() const;
+
+  /**
+   * Returns the nodes the path selects from {@code root}, in the order they
+   * are in the document.
+   *
+   * @throws {@link InvalidNode} if {@code root} is a zombie node.
+   */
+  std::vector<Node> Select(const Node& root) const;
+
+  /**
+   * Adds the nodes the path selects from {@code root} to {@code matches},
+   * which (if it has the space) is done without allocating.
+   *
+   * @return the number of nodes added
+   * @throws {@link InvalidNode} if {@code root} is a zombie node.
+   */
+  std::size_t Select(const Node& root, std::vector<Node>& matches) const;
+
+  /**
+   * Returns the first node the path selects from {@code root}, or a zombie
+   * node if there isn't one (as operator[] does for a missing key).
+   *
+   * @throws {@link InvalidNode} if {@code root} is a zombie node.
+   */
+  Node SelectFirst(const Node& root) const;
+
+ private:
+  friend class PathProjector;
+
+ private:
+  std::shared_ptr<const detail::path_data> m_pData;
+};
+}  // namespace YAML
+
+#endif  // NODE_PATH_H_62B23520_7C8E_11DE_8A39_0800200C9A66
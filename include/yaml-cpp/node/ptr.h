@@ -17,12 +17,14 @@ class node_ref;
 class node_data;
 class memory;
 class memory_holder;
+class lazy_collection;
 
 using shared_node = std::shared_ptr<node>;
 using shared_node_ref = std::shared_ptr<node_ref>;
 using shared_node_data = std::shared_ptr<node_data>;
 using shared_memory_holder = std::shared_ptr<memory_holder>;
 using shared_memory = std::shared_ptr<memory>;
+using shared_lazy_collection = std::shared_ptr<lazy_collection>;
 }
 }
 
@@ -0,0 +1,158 @@
+#ifndef NODE_STRUCT_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+#define NODE_STRUCT_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+
+#if defined(_MSC_VER) ||                                            \
+    (defined(__GNUC__) && (__GNUC__ == 3 && __GNUC_MINOR__ >= 4) || \
+     (__GNUC__ >= 4))  // GCC supports "pragma once" correctly since 3.4
+#pragma once
+#endif
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <initializer_list>
+#include <vector>
+
+#include "yaml-cpp/binding.h"
+#include "yaml-cpp/node/convert.h"
+#include "yaml-cpp/node/detail/impl.h"
+#include "yaml-cpp/node/impl.h"
+#include "yaml-cpp/node/iterator.h"
+#include "yaml-cpp/node/node.h"
+#include "yaml-cpp/node/type.h"
+
+namespace YAML {
+namespace detail {
+// struct_fields
+// . The fields of a struct defined with YAML_DEFINE_STRUCT, sorted by name,
+//   so decoding a map looks up each of its keys once, by binary search.
+// . Each field's decode returns false if the value can't be converted to
+//   the field's type, like convert<>::decode, rather than throwing.
+template <typename T>
+class struct_fields {
+ public:
+  struct field {
+    const char* name;
+    bool (*decode)(const Node& value, T& rhs);
+  };
+
+  struct_fields(std::initializer_list<field> fields) : m_fields(fields) {
+    std::sort(m_fields.begin(), m_fields.end(),
+              [](const field& lhs, const field& rhs) {
+                return std::strcmp(lhs.name, rhs.name) < 0;
+              });
+  }
+
+  bool decode(const Node& node, T& rhs) const {
+    if (!node.IsMap())
+      return false;
+
+    for (const auto& element : node) {
+      if (!element.first.IsScalar())
+        continue;
+
+      const char* key = element.first.Scalar().c_str();
+      auto it = std::lower_bound(m_fields.begin(), m_fields.end(), key,
+                                 [](const field& lhs, const char* rhs) {
+                                   return std::strcmp(lhs.name, rhs) < 0;
+                                 });
+      if (it != m_fields.end() && std::strcmp(it->name, key) == 0 &&
+          !it->decode(element.second, rhs))
+        return false;
+    }
+    return true;
+  }
+
+ private:
+  std::vector<field> m_fields;
+};
+}  // namespace detail
+}  // namespace YAML
+
+// YAML_PP_FOR_EACH(f, x, y, ...) expands to f(x) f(y) ..., for up to 364
+// arguments; it rescans its expansion until the list runs out.
+#define YAML_PP_EVAL0(...) __VA_ARGS__
+#define YAML_PP_EVAL1(...) \
+  YAML_PP_EVAL0(YAML_PP_EVAL0(YAML_PP_EVAL0(__VA_ARGS__)))
+#define YAML_PP_EVAL2(...) \
+  YAML_PP_EVAL1(YAML_PP_EVAL1(YAML_PP_EVAL1(__VA_ARGS__)))
+#define YAML_PP_EVAL3(...) \
+  YAML_PP_EVAL2(YAML_PP_EVAL2(YAML_PP_EVAL2(__VA_ARGS__)))
+#define YAML_PP_EVAL4(...) \
+  YAML_PP_EVAL3(YAML_PP_EVAL3(YAML_PP_EVAL3(__VA_ARGS__)))
+#define YAML_PP_EVAL(...) \
+  YAML_PP_EVAL4(YAML_PP_EVAL4(YAML_PP_EVAL4(__VA_ARGS__)))
+
+#define YAML_PP_FOR_EACH_END(...)
+#define YAML_PP_FOR_EACH_OUT
+#define YAML_PP_FOR_EACH_GET_END2() 0, YAML_PP_FOR_EACH_END
+#define YAML_PP_FOR_EACH_GET_END1(...) YAML_PP_FOR_EACH_GET_END2
+#define YAML_PP_FOR_EACH_GET_END(...) YAML_PP_FOR_EACH_GET_END1
+#define YAML_PP_FOR_EACH_NEXT0(test, next, ...) next YAML_PP_FOR_EACH_OUT
+#define YAML_PP_FOR_EACH_NEXT1(test, next) \
+  YAML_PP_FOR_EACH_NEXT0(test, next, 0)
+#define YAML_PP_FOR_EACH_NEXT(test, next) \
+  YAML_PP_FOR_EACH_NEXT1(YAML_PP_FOR_EACH_GET_END test, next)
+
+#define YAML_PP_FOR_EACH0(f, x, peek, ...) \
+  f(x) YAML_PP_FOR_EACH_NEXT(peek, YAML_PP_FOR_EACH1)(f, peek, __VA_ARGS__)
+#define YAML_PP_FOR_EACH1(f, x, peek, ...) \
+  f(x) YAML_PP_FOR_EACH_NEXT(peek, YAML_PP_FOR_EACH0)(f, peek, __VA_ARGS__)
+#define YAML_PP_FOR_EACH(f, ...) \
+  YAML_PP_EVAL(YAML_PP_FOR_EACH1(f, __VA_ARGS__, ()()(), ()()(), ()()(), 0))
+
+#define YAML_STRUCT_ENCODE_FIELD(field) node.force_insert(#field, rhs.field);
+#define YAML_STRUCT_DECODE_FIELD(field)                                 \
+  {#field, [](const ::YAML::Node& value, Type& rhs) {                  \
+     return value.IsNull() ||                                          \
+            ::YAML::convert<decltype(Type::field)>::decode(value,      \
+                                                           rhs.field); \
+   }},
+#define YAML_STRUCT_BIND_FIELD(field) fields.Optional(#field, &Type::field);
+
+/**
+ * Defines convert<type> for a struct, from the names of its fields, e.g.,
+ *
+ *   YAML_DEFINE_STRUCT(ns::Server, host, port, timeout)
+ *
+ * at global scope, with the struct's fully qualified name. It also defines
+ * its binding<type> (see yaml-cpp/binding.h), with every field optional.
+ *
+ * Each field is a key of the struct's map, with the field's name. Decoding
+ * goes over the map once, looking up each key in the (sorted) fields; keys
+ * that aren't fields are ignored, and fields that aren't keys (or whose
+ * values are null, as with the binding) keep the value they had. A value
+ * that doesn't convert to its field's type makes decode return false (so
+ * as<type>() throws TypedBadConversion<type>). Encoding adds the fields in
+ * order, without looking for them.
+ */
+#define YAML_DEFINE_STRUCT(type, ...)                                      \
+  namespace YAML {                                                         \
+  template <>                                                              \
+  struct convert<type> {                                                   \
+    using Type = type;                                                     \
+                                                                           \
+    static Node encode(const Type& rhs) {                                  \
+      Node node(NodeType::Map);                                            \
+      YAML_PP_FOR_EACH(YAML_STRUCT_ENCODE_FIELD, __VA_ARGS__)              \
+      return node;                                                         \
+    }                                                                      \
+                                                                           \
+    static bool decode(const Node& node, Type& rhs) {                      \
+      static const detail::struct_fields<Type> fields{                     \
+          YAML_PP_FOR_EACH(YAML_STRUCT_DECODE_FIELD, __VA_ARGS__)};        \
+      return fields.decode(node, rhs);                                     \
+    }                                                                      \
+  };                                                                       \
+                                                                           \
+  template <>                                                              \
+  struct binding<type> {                                                   \
+    using Type = type;                                                     \
+                                                                           \
+    static void Describe(Fields<Type>& fields) {                           \
+      YAML_PP_FOR_EACH(YAML_STRUCT_BIND_FIELD, __VA_ARGS__)                \
+    }                                                                      \
+  };                                                                       \
+  }
+
+#endif  // NODE_STRUCT_H_62B23520_7C8E_11DE_8A39_0800200C9A66
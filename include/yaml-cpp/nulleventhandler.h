@@ -0,0 +1,47 @@
+#ifndef NULLEVENTHANDLER_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+#define NULLEVENTHANDLER_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+
+#if defined(_MSC_VER) ||                                            \
+    (defined(__GNUC__) && (__GNUC__ == 3 && __GNUC_MINOR__ >= 4) || \
+     (__GNUC__ >= 4))  // GCC supports "pragma once" correctly since 3.4
+#pragma once
+#endif
+
+#include <string>
+
+#include "yaml-cpp/anchor.h"
+#include "yaml-cpp/emitterstyle.h"
+#include "yaml-cpp/eventhandler.h"
+
+namespace YAML {
+struct Mark;
+
+/**
+ * An event handler that ignores every event, e.g., to check that the input
+ * parses, or to time the parser on its own.
+ */
+class NullEventHandler final : public EventHandler {
+ public:
+  NullEventHandler() = default;
+
+  void OnDocumentStart(const Mark&) override {}
+  void OnDocumentEnd() override {}
+
+  void OnNull(const Mark&, anchor_t) override {}
+  void OnAlias(const Mark&, anchor_t) override {}
+  void OnScalar(const Mark&, const std::string&, anchor_t,
+                const std::string&) override {}
+  void OnOwnedScalar(const Mark&, std::string&&, anchor_t,
+                     std::string&&) override {}
+
+  void OnSequenceStart(const Mark&, const std::string&, anchor_t,
+                       EmitterStyle::value) override {}
+  void OnSequenceEnd() override {}
+
+  void OnMapStart(const Mark&, const std::string&, anchor_t,
+                  EmitterStyle::value) override {}
+  void OnMapEnd() override {}
+};
+}  // namespace YAML
+
+#endif  // NULLEVENTHANDLER_H_62B23520_7C8E_11DE_8A39_0800200C9A66
@@ -42,9 +42,6 @@ class YAML_CPP_API ostream_wrapper {
   std::size_t pos() const { return m_pos; }
   bool comment() const { return m_comment; }
 
- private:
-  void update_pos(char ch);
-
  private:
   mutable std::vector<char> m_buffer;
   std::ostream* const m_pStream;
@@ -9,16 +9,36 @@
 
 #include <ios>
 #include <memory>
+#include <type_traits>
 
 #include "yaml-cpp/dll.h"
 
 namespace YAML {
 class EventHandler;
 class Node;
+class NodeBuilder;
+class NullEventHandler;
+class ResumableParser;
+struct Mark;
 class Scanner;
 struct Directives;
+class TapeBuilder;
 struct Token;
 
+/**
+ * Whether Parser::HandleNextDocument is compiled for {@code Handler}, to call
+ * its events directly; it is for NullEventHandler, and the library's own
+ * handlers (all final).
+ */
+template <typename Handler>
+struct IsDirectEventHandler : std::false_type {};
+template <>
+struct IsDirectEventHandler<NullEventHandler> : std::true_type {};
+template <>
+struct IsDirectEventHandler<NodeBuilder> : std::true_type {};
+template <>
+struct IsDirectEventHandler<TapeBuilder> : std::true_type {};
+
 /**
  * A parser turns a stream of bytes into one stream of "events" per YAML
  * document in the input stream.
@@ -50,6 +70,14 @@ class YAML_CPP_API Parser {
    */
   void Load(std::istream& in);
 
+  /**
+   * Resets the parser with the given input stream, which was cut from a
+   * larger stream at {@code start}; the marks of events and errors are then
+   * positions in that larger stream. {@code start} must be at the beginning
+   * of a line.
+   */
+  void Load(std::istream& in, const Mark& start);
+
   /**
    * Handles the next document by calling events on the {@code eventHandler}.
    *
@@ -58,9 +86,27 @@ class YAML_CPP_API Parser {
    */
   bool HandleNextDocument(EventHandler& eventHandler);
 
+  /**
+   * Handles the next document like the above, but calls the handler's events
+   * directly, rather than through EventHandler's virtual methods, so that
+   * they can be inlined. It's chosen over the above for the handlers it's
+   * compiled for (see IsDirectEventHandler).
+   *
+   * @throw a ParserException on error.
+   * @return false if there are no more documents
+   */
+  template <typename Handler,
+            typename std::enable_if<IsDirectEventHandler<Handler>::value,
+                                    int>::type = 0>
+  bool HandleNextDocument(Handler& handler);
+
   void PrintTokens(std::ostream& out);
 
  private:
+  // (which parses pushed input a token at a time, with this parser's
+  // scanner and directives)
+  friend class ResumableParser;
+
   /**
    * Reads any directives that are next in the queue, setting the internal
    * {@code m_pDirectives} state.
@@ -81,6 +127,10 @@ class YAML_CPP_API Parser {
    */
   void HandleTagDirective(const Token& token);
 
+  /** The body of both versions of HandleNextDocument. */
+  template <typename Handler>
+  bool HandleDocument(Handler& handler);
+
  private:
   std::unique_ptr<Scanner> m_pScanner;
   std::unique_ptr<Directives> m_pDirectives;
@@ -0,0 +1,77 @@
+#ifndef PUSHPARSER_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+#define PUSHPARSER_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+
+#if defined(_MSC_VER) ||                                            \
+    (defined(__GNUC__) && (__GNUC__ == 3 && __GNUC_MINOR__ >= 4) || \
+     (__GNUC__ >= 4))  // GCC supports "pragma once" correctly since 3.4
+#pragma once
+#endif
+
+#include <cstddef>
+#include <memory>
+
+#include "yaml-cpp/dll.h"
+
+namespace YAML {
+class EventHandler;
+class ResumableParser;
+
+/**
+ * A parser that is given its input a piece at a time, e.g., as it comes in
+ * over a socket, rather than reading it from a stream; it never waits for
+ * input.
+ *
+ * Events go to the handler just as a Parser over the whole input would send
+ * them, and so do errors, but as the input comes in: an event goes once the
+ * tokens that decide it have come in, and a document is handled once it
+ * ends (e.g., at a document end marker ("...") or the next document's start
+ * marker ("---")). When the parser runs out of input, it stops after the
+ * last token it scanned whole, and carries on from there once it has more;
+ * it holds only the input it hasn't finished scanning. (The token it
+ * stopped in is scanned again from its start, so it waits to do that until
+ * as much input has come in as that scan had got through; and a block
+ * scalar that the handler takes in chunks is held until it's been scanned
+ * whole.)
+ */
+class YAML_CPP_API PushParser {
+ public:
+  /** Constructs a parser that calls events on {@code handler}. */
+  explicit PushParser(EventHandler& handler);
+
+  PushParser(const PushParser&) = delete;
+  PushParser(PushParser&&) = delete;
+  PushParser& operator=(const PushParser&) = delete;
+  PushParser& operator=(PushParser&&) = delete;
+
+  ~PushParser();
+
+  /**
+   * Adds {@code size} bytes of input, and handles the events that they
+   * decide. The input is copied, as far as it's needed.
+   *
+   * @throw a ParserException on error, after which the parser takes no more
+   *        input.
+   * @return the number of documents that it finished handling
+   */
+  std::size_t feed(const char* data, std::size_t size);
+
+  /**
+   * Marks the end of the input, and handles the events that are left.
+   *
+   * @throw a ParserException on error.
+   * @return the number of documents that it finished handling
+   */
+  std::size_t finish();
+
+ private:
+  /** Handles the events that the input so far decides. */
+  std::size_t Parse();
+
+ private:
+  EventHandler& m_handler;
+  std::unique_ptr<ResumableParser> m_pParser;
+  bool m_done;  // has it finished, or failed?
+};
+}  // namespace YAML
+
+#endif  // PUSHPARSER_H_62B23520_7C8E_11DE_8A39_0800200C9A66
@@ -0,0 +1,76 @@
+#ifndef SNAPSHOT_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+#define SNAPSHOT_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+
+#if defined(_MSC_VER) ||                                            \
+    (defined(__GNUC__) && (__GNUC__ == 3 && __GNUC_MINOR__ >= 4) || \
+     (__GNUC__ >= 4))  // GCC supports "pragma once" correctly since 3.4
+#pragma once
+#endif
+
+#include <cstddef>
+#include <iosfwd>
+#include <string>
+
+#include "yaml-cpp/dll.h"
+#include "yaml-cpp/tape.h"
+
+namespace YAML {
+/**
+ * Writes the tape's document (with its tags, styles, anchors and aliases,
+ * and, if {@code withMarks}, its marks) to a binary snapshot, which
+ * LoadSnapshot reads back much faster than the YAML can be parsed.
+ *
+ * The format is versioned and checksummed; a snapshot can be read on any
+ * platform, but only by a yaml-cpp that writes the same version.
+ */
+YAML_CPP_API void SaveSnapshot(const Tape& tape, std::ostream& output,
+                               bool withMarks = true);
+
+/**
+ * Writes the tape's document to a binary snapshot file.
+ *
+ * @throws {@link BadFile} if the file cannot be written.
+ */
+YAML_CPP_API void SaveSnapshotFile(const Tape& tape,
+                                   const std::string& filename,
+                                   bool withMarks = true);
+
+/**
+ * Reads a document from a binary snapshot. Its scalars are read as one block,
+ * straight into the tape.
+ *
+ * @throws {@link BadSnapshot} if it isn't a snapshot, is of another version,
+ *         or is damaged.
+ */
+YAML_CPP_API Tape LoadSnapshot(std::istream& input);
+
+/**
+ * Reads a document from a binary snapshot in memory (e.g., one compiled
+ * into the program by yaml-cpp-embed).
+ *
+ * @throws {@link BadSnapshot} if it isn't a valid snapshot.
+ */
+YAML_CPP_API Tape LoadSnapshot(const char* data, std::size_t size);
+
+/**
+ * Reads a document from a binary snapshot file.
+ *
+ * @throws {@link BadSnapshot} if it isn't a valid snapshot.
+ * @throws {@link BadFile} if the file cannot be loaded.
+ */
+YAML_CPP_API Tape LoadSnapshotFile(const std::string& filename);
+
+/**
+ * Makes LoadFile keep a snapshot of each file it loads in {@code directory}
+ * (which must exist), named for the SHA-256 digest of the file's contents,
+ * and load the snapshot instead of parsing the file whenever it's there. An
+ * empty {@code directory} (the default) turns this off.
+ *
+ * The cache is only an optimization: a snapshot that's missing, damaged or
+ * of another version is replaced, and if one can't be written, LoadFile
+ * goes on without it.
+ */
+YAML_CPP_API void SetSnapshotCacheDirectory(const std::string& directory);
+}  // namespace YAML
+
+#endif  // SNAPSHOT_H_62B23520_7C8E_11DE_8A39_0800200C9A66
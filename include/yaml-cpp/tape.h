@@ -0,0 +1,332 @@
+#ifndef TAPE_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+#define TAPE_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+
+#if defined(_MSC_VER) ||                                            \
+    (defined(__GNUC__) && (__GNUC__ == 3 && __GNUC_MINOR__ >= 4) || \
+     (__GNUC__ >= 4))  // GCC supports "pragma once" correctly since 3.4
+#pragma once
+#endif
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "yaml-cpp/dll.h"
+#include "yaml-cpp/emitterstyle.h"
+#include "yaml-cpp/exceptions.h"
+#include "yaml-cpp/mark.h"
+#include "yaml-cpp/node/convert.h"
+#include "yaml-cpp/node/impl.h"
+#include "yaml-cpp/node/node.h"
+#include "yaml-cpp/node/type.h"
+
+namespace YAML {
+class TapeBuilder;
+class TapeIterator;
+class TapeSnapshot;
+
+namespace detail {
+// tape_entry
+// . One node of a Tape. A collection's subtree (for a map, each key and then
+//   its value) comes right after it, so its next sibling is 'skip' entries
+//   on.
+// . Its mark is only where it starts in the input; the line and column come
+//   from tape_data::lines, which keeps the entry at 32 bytes.
+struct tape_entry {
+  enum { LINK = 0xFF };  // an alias, for the 'type'
+  enum : std::uint32_t { NO_POS = 0xFFFFFFFF };  // a null mark, for the 'pos'
+
+  tape_entry(unsigned char type_, std::uint32_t pos_)
+      : type(type_),
+        style(EmitterStyle::Default),
+        anchored(false),
+        tag(0),
+        size(0),
+        skip(1),
+        value(0),
+        length(0),
+        pos(pos_) {}
+
+  unsigned char type;    // a NodeType::value, or LINK
+  unsigned char style;   // an EmitterStyle::value, for a collection
+  bool anchored;         // is there a link to it?
+  std::uint32_t tag;     // its index in tape_data::tags
+  std::uint32_t size;    // a collection's elements, or key/value pairs; or,
+                         // for a link, the index of the entry it's an alias of
+  std::uint32_t skip;    // the entries in its subtree, itself included
+  std::size_t value;     // where a scalar's value is in the arena (it's
+  std::uint32_t length;  // followed by a '\0')
+  std::uint32_t pos;     // where it starts in the input, or NO_POS
+};
+
+// tape_line
+// . Where a line that some entry starts on begins in the input.
+struct tape_line {
+  std::uint32_t start;
+  std::uint32_t line;
+};
+
+struct tape_data {
+  tape_data() : entries{}, arena{}, tags{}, lines{} {}
+
+  // The mark of 'entry', from its pos and the line it's on.
+  Mark mark(const tape_entry& entry) const;
+
+  std::vector<tape_entry> entries;
+  std::string arena;
+  std::vector<std::string> tags;
+  std::vector<tape_line> lines;  // by start
+};
+}  // namespace detail
+
+/**
+ * A node of a Tape; it's only valid as long as the tape (or a copy of it)
+ * is. An alias is the node it's an alias of.
+ */
+class YAML_CPP_API TapeNode {
+ public:
+  /** Constructs an invalid node, like the one find() returns for a key that
+   * isn't there. */
+  TapeNode() : m_pData(nullptr), m_index(0) {}
+
+  bool IsDefined() const { return m_pData != nullptr; }
+  explicit operator bool() const { return IsDefined(); }
+  bool operator!() const { return !IsDefined(); }
+
+  NodeType::value Type() const;
+  bool IsNull() const { return Type() == NodeType::Null; }
+  bool IsScalar() const { return Type() == NodeType::Scalar; }
+  bool IsSequence() const { return Type() == NodeType::Sequence; }
+  bool IsMap() const { return Type() == NodeType::Map; }
+
+  YAML::Mark Mark() const;
+  const std::string& Tag() const;
+  EmitterStyle::value Style() const;
+
+  /** A scalar's value (which is empty for any other node). */
+  std::string Scalar() const;
+  /** A scalar's value where the tape keeps it, with a '\0' after it. */
+  const char* ScalarData() const;
+  std::size_t ScalarSize() const;
+
+  /** The number of elements of a sequence, or of key/value pairs of a map. */
+  std::size_t size() const;
+
+  /**
+   * The element of a sequence at {@code index}, or an invalid node if there
+   * isn't one. It skips over the elements before it, without looking into
+   * them.
+   */
+  TapeNode at(std::size_t index) const;
+
+  /**
+   * The value of a map for the scalar key {@code key}, or an invalid node if
+   * there isn't one. It compares the keys in order, skipping over the values
+   * without looking into them.
+   */
+  TapeNode find(const char* key, std::size_t size) const;
+  TapeNode find(const std::string& key) const {
+    return find(key.data(), key.size());
+  }
+  TapeNode find(const char* key) const;
+
+  TapeIterator begin() const;
+  TapeIterator end() const;
+
+  /**
+   * Converts the node, like Node::as: scalars are read straight from the
+   * tape, and anything else through ToNode() and its convert<>.
+   */
+  template <typename T>
+  T as() const;
+  template <typename T, typename S>
+  T as(const S& fallback) const;
+
+  /** A copy of the node (and its subtree) as a Node. */
+  Node ToNode() const;
+
+ private:
+  friend class Tape;
+  friend class TapeIterator;
+
+  // (a link is resolved to the entry it's an alias of)
+  TapeNode(const detail::tape_data* pData, std::size_t index);
+
+  const detail::tape_entry& entry() const;
+
+ private:
+  const detail::tape_data* m_pData;
+  std::size_t m_index;
+};
+
+/**
+ * What a TapeIterator points to: the element of a sequence, or the key and
+ * value of a map (as first and second), like Node's iterators.
+ */
+class TapeValue : public TapeNode, public std::pair<TapeNode, TapeNode> {
+ public:
+  TapeValue() : TapeNode(), std::pair<TapeNode, TapeNode>() {}
+  explicit TapeValue(const TapeNode& node)
+      : TapeNode(node), std::pair<TapeNode, TapeNode>() {}
+  TapeValue(const TapeNode& key, const TapeNode& value)
+      : TapeNode(), std::pair<TapeNode, TapeNode>(key, value) {}
+};
+
+/** Goes over the elements of a sequence, or the key/value pairs of a map. */
+class YAML_CPP_API TapeIterator {
+ private:
+  struct proxy {
+    explicit proxy(const TapeValue& x) : m_ref(x) {}
+    const TapeValue* operator->() { return std::addressof(m_ref); }
+    operator const TapeValue*() { return std::addressof(m_ref); }
+
+    TapeValue m_ref;
+  };
+
+ public:
+  using iterator_category = std::forward_iterator_tag;
+  using value_type = TapeValue;
+  using difference_type = std::ptrdiff_t;
+  using pointer = TapeValue*;
+  using reference = TapeValue;
+
+  TapeIterator() : m_pData(nullptr), m_index(0), m_map(false) {}
+
+  TapeValue operator*() const;
+  proxy operator->() const { return proxy(**this); }
+
+  TapeIterator& operator++();
+  TapeIterator operator++(int) {
+    TapeIterator it = *this;
+    ++(*this);
+    return it;
+  }
+
+  bool operator==(const TapeIterator& rhs) const {
+    return m_index == rhs.m_index && m_pData == rhs.m_pData;
+  }
+  bool operator!=(const TapeIterator& rhs) const { return !(*this == rhs); }
+
+ private:
+  friend class TapeNode;
+  TapeIterator(const detail::tape_data* pData, std::size_t index, bool map)
+      : m_pData(pData), m_index(index), m_map(map) {}
+
+ private:
+  const detail::tape_data* m_pData;
+  std::size_t m_index;  // the entry of the element, or key
+  bool m_map;
+};
+
+/**
+ * A document loaded into one flat, immutable array of entries, with its
+ * scalars in one string, rather than into a graph of nodes; it's faster to
+ * load, and smaller, than a Node, but it can't be changed. Copies share the
+ * same document.
+ */
+class YAML_CPP_API Tape {
+ public:
+  /** Constructs a tape with no document (whose root is invalid). */
+  Tape();
+
+  /** The document's root node. */
+  TapeNode Root() const;
+
+ private:
+  friend class TapeBuilder;
+  friend class TapeSnapshot;
+  explicit Tape(std::shared_ptr<const detail::tape_data> pData);
+
+ private:
+  std::shared_ptr<const detail::tape_data> m_pData;
+};
+
+/**
+ * Loads the input string as a single YAML document, into a Tape (which has
+ * no document if the input has none).
+ *
+ * @throws {@link ParserException} if it is malformed.
+ */
+YAML_CPP_API Tape LoadTape(const std::string& input);
+
+/**
+ * Loads the input string as a single YAML document, into a Tape.
+ *
+ * @throws {@link ParserException} if it is malformed.
+ */
+YAML_CPP_API Tape LoadTape(const char* input);
+
+/**
+ * Loads the input stream as a single YAML document, into a Tape.
+ *
+ * @throws {@link ParserException} if it is malformed.
+ */
+YAML_CPP_API Tape LoadTape(std::istream& input);
+
+/**
+ * Loads the input file as a single YAML document, into a Tape.
+ *
+ * @throws {@link ParserException} if it is malformed.
+ * @throws {@link BadFile} if the file cannot be loaded.
+ */
+YAML_CPP_API Tape LoadTapeFile(const std::string& filename);
+
+namespace detail {
+inline bool tape_decode(const TapeNode& node, std::string& value) {
+  if (node.IsNull()) {
+    value = "null";
+    return true;
+  }
+  if (!node.IsScalar())
+    return false;
+  value.assign(node.ScalarData(), node.ScalarSize());
+  return true;
+}
+
+inline bool tape_decode(const TapeNode& node, bool& value) {
+  return node.IsScalar() && conversion::DecodeBool(node.Scalar(), value);
+}
+
+template <typename T>
+typename std::enable_if<std::is_arithmetic<T>::value, bool>::type
+tape_decode(const TapeNode& node, T& value) {
+  return node.IsScalar() && conversion::DecodeNumber(node.Scalar(), value);
+}
+
+template <typename T>
+typename std::enable_if<!std::is_arithmetic<T>::value, bool>::type
+tape_decode(const TapeNode& node, T& value) {
+  return convert<T>::decode(node.ToNode(), value);
+}
+}  // namespace detail
+
+template <typename T>
+inline T TapeNode::as() const {
+  if (!IsDefined())
+    throw InvalidNode(std::string());
+
+  T value;
+  if (!detail::tape_decode(*this, value))
+    throw TypedBadConversion<T>(Mark());
+  return value;
+}
+
+template <typename T, typename S>
+inline T TapeNode::as(const S& fallback) const {
+  if (!IsDefined())
+    return fallback;
+
+  T value;
+  if (!detail::tape_decode(*this, value))
+    return fallback;
+  return value;
+}
+}  // namespace YAML
+
+#endif  // TAPE_H_62B23520_7C8E_11DE_8A39_0800200C9A66
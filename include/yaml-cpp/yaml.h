@@ -8,6 +8,7 @@
 #endif
 
 #include "yaml-cpp/parser.h"
+#include "yaml-cpp/pushparser.h"
 #include "yaml-cpp/emitter.h"
 #include "yaml-cpp/emitterstyle.h"
 #include "yaml-cpp/stlemitter.h"
@@ -16,9 +17,19 @@
 #include "yaml-cpp/node/node.h"
 #include "yaml-cpp/node/impl.h"
 #include "yaml-cpp/node/convert.h"
+#include "yaml-cpp/node/struct.h"
 #include "yaml-cpp/node/iterator.h"
 #include "yaml-cpp/node/detail/impl.h"
 #include "yaml-cpp/node/parse.h"
+#include "yaml-cpp/node/document_stream.h"
+#include "yaml-cpp/node/document_cache.h"
+#include "yaml-cpp/node/document_index.h"
+#include "yaml-cpp/node/load_files.h"
+#include "yaml-cpp/node/path.h"
 #include "yaml-cpp/node/emit.h"
 
+#include "yaml-cpp/binding.h"
+#include "yaml-cpp/tape.h"
+#include "yaml-cpp/snapshot.h"
+
 #endif  // YAML_H_62B23520_7C8E_11DE_8A39_0800200C9A66
@@ -1,17 +1,186 @@
 #include "yaml-cpp/binary.h"
 
-#include <cctype>
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define YAML_CPP_BASE64_SSE2
+#endif
+#if defined(YAML_CPP_BASE64_SSE2) && defined(__SSSE3__)
+#include <tmmintrin.h>
+#define YAML_CPP_BASE64_SSSE3
+#endif
 
 namespace YAML {
 static const char encoding[] =
     "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
 
-std::string EncodeBase64(const unsigned char *data, std::size_t size) {
+// decoding[ch] is the 6-bit value of 'ch', or one of these
+static const unsigned char INVALID = 255;
+static const unsigned char WHITESPACE = 254;
+
+static const unsigned char decoding[] = {
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 254, 254, 254, 254, 254, 255,
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 254, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 62,  255,
+    255, 255, 63,  52,  53,  54,  55,  56,  57,  58,  59,  60,  61,  255, 255,
+    255, 0,   255, 255, 255, 0,   1,   2,   3,   4,   5,   6,   7,   8,   9,
+    10,  11,  12,  13,  14,  15,  16,  17,  18,  19,  20,  21,  22,  23,  24,
+    25,  255, 255, 255, 255, 255, 255, 26,  27,  28,  29,  30,  31,  32,  33,
+    34,  35,  36,  37,  38,  39,  40,  41,  42,  43,  44,  45,  46,  47,  48,
+    49,  50,  51,  255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+    255,
+};
+
+#ifdef YAML_CPP_BASE64_SSE2
+namespace {
+// Maps 16 6-bit values to their base64 characters, without a table lookup:
+// each range of the alphabet is a constant offset from the previous one.
+__m128i EncodeCharacters(__m128i indices) {
+  __m128i chars = _mm_add_epi8(indices, _mm_set1_epi8('A'));
+  chars = _mm_add_epi8(
+      chars, _mm_and_si128(_mm_cmpgt_epi8(indices, _mm_set1_epi8(25)),
+                           _mm_set1_epi8('a' - 26 - 'A')));
+  chars = _mm_add_epi8(
+      chars, _mm_and_si128(_mm_cmpgt_epi8(indices, _mm_set1_epi8(51)),
+                           _mm_set1_epi8('0' - 52 - ('a' - 26))));
+  chars = _mm_add_epi8(
+      chars, _mm_and_si128(_mm_cmpgt_epi8(indices, _mm_set1_epi8(61)),
+                           _mm_set1_epi8('+' - 62 - ('0' - 52))));
+  chars = _mm_add_epi8(
+      chars, _mm_and_si128(_mm_cmpgt_epi8(indices, _mm_set1_epi8(62)),
+                           _mm_set1_epi8('/' - 63 - ('+' - 62))));
+  return chars;
+}
+
+// Encodes 12 bytes into 16 characters. With SSSE3 this reads 16 bytes from
+// 'data'; the caller must make sure they're there.
+void EncodeBlock(const unsigned char *data, char *out) {
+#ifdef YAML_CPP_BASE64_SSSE3
+  // spread each 3 byte group over a 32-bit lane, then pull the four 6-bit
+  // fields into their own bytes with a pair of multiplies
+  __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data));
+  in = _mm_shuffle_epi8(
+      in, _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+  const __m128i high =
+      _mm_mulhi_epu16(_mm_and_si128(in, _mm_set1_epi32(0x0fc0fc00)),
+                      _mm_set1_epi32(0x04000040));
+  const __m128i low =
+      _mm_mullo_epi16(_mm_and_si128(in, _mm_set1_epi32(0x003f03f0)),
+                      _mm_set1_epi32(0x01000010));
+  const __m128i indices = _mm_or_si128(high, low);
+#else
+  int groups[4];
+  for (int i = 0; i < 4; i++, data += 3) {
+    groups[i] = (data[0] << 16) | (data[1] << 8) | data[2];
+  }
+  const __m128i in =
+      _mm_setr_epi32(groups[0], groups[1], groups[2], groups[3]);
+  const __m128i indices = _mm_or_si128(
+      _mm_or_si128(
+          _mm_and_si128(_mm_srli_epi32(in, 18), _mm_set1_epi32(0x3f)),
+          _mm_and_si128(_mm_srli_epi32(in, 4), _mm_set1_epi32(0x3f00))),
+      _mm_or_si128(
+          _mm_and_si128(_mm_slli_epi32(in, 10), _mm_set1_epi32(0x3f0000)),
+          _mm_and_si128(_mm_slli_epi32(in, 24), _mm_set1_epi32(0x3f000000))));
+#endif
+  _mm_storeu_si128(reinterpret_cast<__m128i *>(out),
+                   EncodeCharacters(indices));
+}
+
+__m128i InRange(__m128i chars, char lo, char hi) {
+  return _mm_and_si128(_mm_cmpgt_epi8(chars, _mm_set1_epi8(lo - 1)),
+                       _mm_cmplt_epi8(chars, _mm_set1_epi8(hi + 1)));
+}
+
+// Decodes 16 characters into 12 bytes, if they're all in the base64
+// alphabet. Anything else (whitespace, padding, errors) is left to the
+// scalar decoder.
+bool DecodeBlock(const char *input, unsigned char *out) {
+  const __m128i chars =
+      _mm_loadu_si128(reinterpret_cast<const __m128i *>(input));
+  const __m128i upper = InRange(chars, 'A', 'Z');
+  const __m128i lower = InRange(chars, 'a', 'z');
+  const __m128i digit = InRange(chars, '0', '9');
+  const __m128i plus = _mm_cmpeq_epi8(chars, _mm_set1_epi8('+'));
+  const __m128i slash = _mm_cmpeq_epi8(chars, _mm_set1_epi8('/'));
+  const __m128i valid = _mm_or_si128(
+      _mm_or_si128(_mm_or_si128(upper, lower), _mm_or_si128(digit, plus)),
+      slash);
+  if (_mm_movemask_epi8(valid) != 0xFFFF) {
+    return false;
+  }
+
+  const __m128i shift = _mm_or_si128(
+      _mm_or_si128(
+          _mm_or_si128(_mm_and_si128(upper, _mm_set1_epi8(-'A')),
+                       _mm_and_si128(lower, _mm_set1_epi8(26 - 'a'))),
+          _mm_or_si128(_mm_and_si128(digit, _mm_set1_epi8(52 - '0')),
+                       _mm_and_si128(plus, _mm_set1_epi8(62 - '+')))),
+      _mm_and_si128(slash, _mm_set1_epi8(63 - '/')));
+  const __m128i values = _mm_add_epi8(chars, shift);
+
+#ifdef YAML_CPP_BASE64_SSSE3
+  // merge pairs of 6-bit values, then pairs of 12-bit values, then gather
+  // the three bytes of each 32-bit lane
+  const __m128i pairs =
+      _mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140));
+  const __m128i groups = _mm_madd_epi16(pairs, _mm_set1_epi32(0x00011000));
+  const __m128i bytes = _mm_shuffle_epi8(
+      groups, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1,
+                            -1));
+  _mm_storel_epi64(reinterpret_cast<__m128i *>(out), bytes);
+  const int tail = _mm_cvtsi128_si32(_mm_srli_si128(bytes, 8));
+  std::memcpy(out + 8, &tail, 4);
+#else
+  const __m128i groups = _mm_or_si128(
+      _mm_or_si128(
+          _mm_slli_epi32(_mm_and_si128(values, _mm_set1_epi32(0x3f)), 18),
+          _mm_slli_epi32(_mm_and_si128(values, _mm_set1_epi32(0x3f00)), 4)),
+      _mm_or_si128(
+          _mm_srli_epi32(_mm_and_si128(values, _mm_set1_epi32(0x3f0000)), 10),
+          _mm_srli_epi32(values, 24)));
+  int group[4];
+  _mm_storeu_si128(reinterpret_cast<__m128i *>(group), groups);
+  for (int i = 0; i < 4; i++) {
+    *out++ = static_cast<unsigned char>(group[i] >> 16);
+    *out++ = static_cast<unsigned char>(group[i] >> 8);
+    *out++ = static_cast<unsigned char>(group[i]);
+  }
+#endif
+  return true;
+}
+}  // namespace
+#endif
+
+std::size_t EncodedBase64Size(std::size_t size) { return (size + 2) / 3 * 4; }
+
+std::size_t EncodeBase64(const unsigned char *data, std::size_t size,
+                         char *out) {
   const char PAD = '=';
+  char *const begin = out;
 
-  std::string ret;
-  ret.resize(4 * size / 3 + 3);
-  char *out = &ret[0];
+#ifdef YAML_CPP_BASE64_SSE2
+#ifdef YAML_CPP_BASE64_SSSE3
+  const std::size_t blockInput = 16;
+#else
+  const std::size_t blockInput = 12;
+#endif
+  for (; size >= blockInput; size -= 12, data += 12, out += 16) {
+    EncodeBlock(data, out);
+  }
+#endif
 
   std::size_t chunks = size / 3;
   std::size_t remainder = size % 3;
@@ -40,61 +209,82 @@ std::string EncodeBase64(const unsigned char *data, std::size_t size) {
       break;
   }
 
-  ret.resize(out - &ret[0]);
-  return ret;
+  return static_cast<std::size_t>(out - begin);
 }
 
-static const unsigned char decoding[] = {
-    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
-    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
-    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 62,  255,
-    255, 255, 63,  52,  53,  54,  55,  56,  57,  58,  59,  60,  61,  255, 255,
-    255, 0,   255, 255, 255, 0,   1,   2,   3,   4,   5,   6,   7,   8,   9,
-    10,  11,  12,  13,  14,  15,  16,  17,  18,  19,  20,  21,  22,  23,  24,
-    25,  255, 255, 255, 255, 255, 255, 26,  27,  28,  29,  30,  31,  32,  33,
-    34,  35,  36,  37,  38,  39,  40,  41,  42,  43,  44,  45,  46,  47,  48,
-    49,  50,  51,  255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
-    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
-    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
-    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
-    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
-    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
-    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
-    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
-    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
-    255,
-};
+std::string EncodeBase64(const unsigned char *data, std::size_t size) {
+  std::string ret(EncodedBase64Size(size), '\0');
+  if (!ret.empty()) {
+    EncodeBase64(data, size, &ret[0]);
+  }
+  return ret;
+}
 
-std::vector<unsigned char> DecodeBase64(const std::string &input) {
-  using ret_type = std::vector<unsigned char>;
-  if (input.empty())
-    return ret_type();
+std::size_t DecodedBase64MaxSize(std::size_t size) { return size / 4 * 3; }
 
-  ret_type ret(3 * input.size() / 4 + 1);
-  unsigned char *out = &ret[0];
+bool DecodeBase64(const char *input, std::size_t size, unsigned char *out,
+                  std::size_t &written) {
+  unsigned char *const begin = out;
+  const char *cur = input;
+  const char *const last = input + size;
 
   unsigned value = 0;
-  for (std::size_t i = 0, cnt = 0; i < input.size(); i++) {
-    if (std::isspace(input[i])) {
-      // skip newlines
-      continue;
+  unsigned cnt = 0;
+  bool afterPad = false;
+  while (cur != last) {
+#ifdef YAML_CPP_BASE64_SSE2
+    // whole blocks of the alphabet go 16 characters at a time; we only fall
+    // back to one at a time for a block with whitespace or padding in it
+    if (cnt % 4 == 0) {
+      for (; last - cur >= 16 && DecodeBlock(cur, out); cur += 16, out += 12) {
+        afterPad = false;
+      }
     }
-    unsigned char d = decoding[static_cast<unsigned>(input[i])];
-    if (d == 255)
-      return ret_type();
-
-    value = (value << 6) | d;
-    if (cnt % 4 == 3) {
-      *out++ = value >> 16;
-      if (i > 0 && input[i - 1] != '=')
-        *out++ = value >> 8;
-      if (input[i] != '=')
-        *out++ = value;
+    const char *const scalarEnd =
+        cur + std::min<std::ptrdiff_t>(16, last - cur);
+#else
+    const char *const scalarEnd = last;
+#endif
+
+    for (; cur != scalarEnd; ++cur) {
+      const unsigned char d = decoding[static_cast<unsigned char>(*cur)];
+      if (d == WHITESPACE) {
+        // skip newlines
+        continue;
+      }
+      if (d == INVALID) {
+        written = 0;
+        return false;
+      }
+
+      value = (value << 6) | d;
+      if (cnt % 4 == 3) {
+        *out++ = static_cast<unsigned char>(value >> 16);
+        if (!afterPad)
+          *out++ = static_cast<unsigned char>(value >> 8);
+        if (*cur != '=')
+          *out++ = static_cast<unsigned char>(value);
+      }
+      afterPad = *cur == '=';
+      ++cnt;
     }
-    ++cnt;
   }
 
-  ret.resize(out - &ret[0]);
+  written = static_cast<std::size_t>(out - begin);
+  return true;
+}
+
+std::vector<unsigned char> DecodeBase64(const std::string &input) {
+  using ret_type = std::vector<unsigned char>;
+  if (input.empty())
+    return ret_type();
+
+  ret_type ret(DecodedBase64MaxSize(input.size()) + 1);
+  std::size_t size = 0;
+  if (!DecodeBase64(input.data(), input.size(), &ret[0], size))
+    return ret_type();
+
+  ret.resize(size);
   return ret;
 }
 }  // namespace YAML
@@ -42,6 +42,10 @@ bool convert<bool>::decode(const Node& node, bool& rhs) {
   if (!node.IsScalar())
     return false;
 
+  return conversion::DecodeBool(node.Scalar(), rhs);
+}
+
+bool conversion::DecodeBool(const std::string& input, bool& rhs) {
   // we can't use iostream bool extraction operators as they don't
   // recognize all possible values in the table below (taken from
   // http://yaml.org/type/bool.html)
@@ -54,16 +58,16 @@ bool convert<bool>::decode(const Node& node, bool& rhs) {
       {"on", "off"},
   };
 
-  if (!IsFlexibleCase(node.Scalar()))
+  if (!IsFlexibleCase(input))
     return false;
 
   for (const auto& name : names) {
-    if (name.truename == tolower(node.Scalar())) {
+    if (name.truename == tolower(input)) {
       rhs = true;
       return true;
     }
 
-    if (name.falsename == tolower(node.Scalar())) {
+    if (name.falsename == tolower(input)) {
       rhs = false;
       return true;
     }
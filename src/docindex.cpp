@@ -0,0 +1,214 @@
+#include "docindex.h"
+
+#include <cstring>
+
+namespace YAML {
+namespace {
+// IsBlankOrBreakAt
+// . Whether 'p' (in [text, end]) is at a blank, a line break, or the end,
+//   which is what must follow a document marker (see Exp::DocStart).
+bool IsBlankOrBreakAt(const char* p, const char* end) {
+  if (p == end)
+    return true;
+  switch (*p) {
+    case ' ':
+    case '\t':
+    case '\n':
+      return true;
+    case '\r':
+      return p + 1 != end && p[1] == '\n';
+    default:
+      return false;
+  }
+}
+
+DocumentStart MakeDocumentStart(std::size_t pos, std::size_t line) {
+  DocumentStart start;
+  start.pos = pos;
+  start.line = line;
+  start.directivesPos = 0;
+  start.directivesSize = 0;
+  start.directivesLines = 0;
+  start.ownDirectives = false;
+  start.documents = 0;
+  return start;
+}
+
+std::size_t CountLines(const char* text, std::size_t size) {
+  std::size_t lines = 0;
+  for (const char* p = text, *end = text + size;
+       (p = static_cast<const char*>(std::memchr(p, '\n', end - p))) != 0;
+       ++p)
+    ++lines;
+  return lines;
+}
+}  // namespace
+
+bool IsEmptyFrom(const char* p, const char* end) {
+  while (p != end && (*p == ' ' || *p == '\t'))
+    ++p;
+  if (p == end || *p == '#' || *p == '\n')
+    return true;
+  return *p == '\r' && p + 1 != end && p[1] == '\n';
+}
+
+LineType ClassifyLine(const char* line, const char* end) {
+  const std::size_t size = static_cast<std::size_t>(end - line);
+  if (size > 0 && line[0] == '%')
+    return LineType::Directive;
+  if (size >= 3 && std::memcmp(line, "---", 3) == 0 &&
+      IsBlankOrBreakAt(line + 3, end))
+    return LineType::DocStart;
+  if (size >= 3 && std::memcmp(line, "...", 3) == 0 &&
+      IsBlankOrBreakAt(line + 3, end))
+    return LineType::DocEnd;
+  if (IsEmptyFrom(line, end))
+    return LineType::Empty;
+  return LineType::Content;
+}
+
+std::size_t Utf8ByteOrderMarkSize(const char* input, std::size_t size) {
+  if (size >= 3 && static_cast<unsigned char>(input[0]) == 0xEF &&
+      static_cast<unsigned char>(input[1]) == 0xBB &&
+      static_cast<unsigned char>(input[2]) == 0xBF)
+    return 3;
+  return 0;
+}
+
+// ScanDocumentStarts
+// . The scanner treats "---" and "..." at the start of a line as document
+//   markers wherever they are (a block or plain scalar ends there, and a
+//   quoted one is an error), so they can be found line by line. Indented
+//   markers (e.g., inside a block scalar) aren't markers, and are skipped.
+// . A cut is made at each "---" line, and at the line after each "..." line.
+//   If the stream turns out not to split into the same documents there, it
+//   will have an error on either side of the cut, which is what callers
+//   fall back on.
+// . A line starting with '%' is a directive for the scanner; but it's only
+//   the start of a document's directives right after the start of the stream
+//   or a "...", which is the only place we accept them.
+bool ScanDocumentStarts(const char* input, std::size_t size,
+                        std::vector<DocumentStart>& starts) {
+  starts.clear();
+
+  const std::size_t bom = Utf8ByteOrderMarkSize(input, size);
+  const char* const text = input + bom;
+  const char* const textEnd = input + size;
+  const std::size_t textSize = size - bom;
+
+  // UTF-16 and UTF-32 have byte order marks starting with 0xFE or 0xFF, or
+  // zero bytes in their first few characters; and anywhere else, a zero byte
+  // could make a cut look like the start of one of those
+  if (textSize > 0 && (static_cast<unsigned char>(text[0]) == 0xFE ||
+                       static_cast<unsigned char>(text[0]) == 0xFF))
+    return false;
+  if (std::memchr(text, '\0', textSize) != 0)
+    return false;
+
+  starts.push_back(MakeDocumentStart(0, 0));
+
+  // the directives in effect after the last "---"
+  DocumentStart directives = MakeDocumentStart(0, 0);
+
+  // whether we've seen only empty lines since the last cut, and that cut
+  // was at the start of the stream or after a "..."
+  bool atBoundary = true;
+  bool cutAfterDocEnd = false;
+  bool inDirectives = false;
+  const char* directivesEnd = text;
+
+  // where we are as far as documents go: not in one, in one, or after the
+  // "..." that ended one (which eats any more "..."s)
+  enum { NoDocument, InDocument, EndedDocument } state = NoDocument;
+
+  std::size_t lineNumber = 0;
+  for (const char* line = text; line != textEnd; ++lineNumber) {
+    const char* newline = static_cast<const char*>(
+        std::memchr(line, '\n', static_cast<std::size_t>(textEnd - line)));
+    const char* const lineEnd = newline ? newline + 1 : textEnd;
+    const std::size_t pos = static_cast<std::size_t>(line - text);
+
+    switch (ClassifyLine(line, lineEnd)) {
+      case LineType::Directive:
+        if (!atBoundary && !inDirectives)
+          return false;
+        if (!inDirectives) {
+          inDirectives = true;
+          directives.directivesPos = pos;
+          starts.back().ownDirectives = true;
+          starts.back().directivesPos = 0;
+          starts.back().directivesSize = 0;
+          starts.back().directivesLines = 0;
+        }
+        directivesEnd = lineEnd;
+        state = NoDocument;
+        break;
+      case LineType::DocStart:
+        if (inDirectives) {
+          inDirectives = false;
+          directives.directivesSize =
+              static_cast<std::size_t>(directivesEnd - text) -
+              directives.directivesPos;
+          directives.directivesLines = CountLines(
+              text + directives.directivesPos, directives.directivesSize);
+        } else if (!atBoundary) {
+          DocumentStart start = directives;
+          start.pos = pos;
+          start.line = lineNumber;
+          start.ownDirectives = false;
+          start.documents = 0;
+          starts.push_back(start);
+          cutAfterDocEnd = false;
+        }
+        starts.back().documents++;
+        state = InDocument;
+        atBoundary = false;
+        break;
+      case LineType::DocEnd:
+        if (inDirectives)
+          return false;
+        // a document eats all the "..." lines after it, so the last cut
+        // wasn't really the start of one
+        if (atBoundary && cutAfterDocEnd)
+          starts.pop_back();
+        if (state == NoDocument)
+          starts.back().documents++;
+        state = EndedDocument;
+        // anything else on the line starts the next document, and could go on
+        // to the next line (e.g., a plain scalar), so we can't cut after it;
+        // and the next document's text has to start with an ASCII character,
+        // or it could be taken for a byte order mark
+        atBoundary = IsEmptyFrom(line + 3, lineEnd);
+        if (!atBoundary) {
+          starts.back().documents++;
+          state = InDocument;
+        }
+        cutAfterDocEnd = atBoundary && lineEnd != textEnd &&
+                         static_cast<unsigned char>(*lineEnd) < 0x80;
+        if (cutAfterDocEnd) {
+          DocumentStart start = directives;
+          start.pos = static_cast<std::size_t>(lineEnd - text);
+          start.line = lineNumber + 1;
+          start.ownDirectives = false;
+          start.documents = 0;
+          starts.push_back(start);
+        }
+        break;
+      case LineType::Empty:
+        break;
+      case LineType::Content:
+        if (inDirectives)
+          return false;
+        if (state != InDocument)
+          starts.back().documents++;
+        state = InDocument;
+        atBoundary = false;
+        break;
+    }
+
+    line = lineEnd;
+  }
+
+  return !inDirectives;
+}
+}  // namespace YAML
@@ -0,0 +1,68 @@
+#ifndef DOCINDEX_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+#define DOCINDEX_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+
+#if defined(_MSC_VER) ||                                            \
+    (defined(__GNUC__) && (__GNUC__ == 3 && __GNUC_MINOR__ >= 4) || \
+     (__GNUC__ >= 4))  // GCC supports "pragma once" correctly since 3.4
+#pragma once
+#endif
+
+#include <cstddef>
+#include <vector>
+
+namespace YAML {
+// DocumentStart
+// . A place where the stream can be cut so that everything after it parses
+//   to the same documents it would have as part of the whole stream.
+// . Every document starts at exactly one of these, but one of these may be
+//   followed by no document (e.g., if only comments follow) or, rarely, by
+//   more than one.
+struct DocumentStart {
+  // where the cut is, counted from the start of the stream (after any
+  // byte order mark), like Mark::pos and Mark::line
+  std::size_t pos;
+  std::size_t line;
+
+  // the directives in effect at the cut, as the text of the lines that
+  // declared them (empty if there are none, or if 'ownDirectives')
+  std::size_t directivesPos;
+  std::size_t directivesSize;
+  std::size_t directivesLines;
+
+  // whether the text at the cut starts with the document's own directives
+  bool ownDirectives;
+
+  // the number of documents that start between this cut and the next
+  std::size_t documents;
+};
+
+// Finds every place a UTF-8 stream can be cut between documents, without
+// parsing it: it only looks for document markers and directives at the start
+// of a line. It counts the documents after each cut the way the parser does:
+// a document starts at a "---", at content, or at a "..." that doesn't end
+// one (and is then empty), and it ends with all the "..."s after it.
+//
+// Returns false if the stream can't be cut safely that way; that is, if it
+// isn't UTF-8, or if it has directives that aren't at the start of the stream
+// or after a document end marker ("..."), where a line starting with '%'
+// could just as well be part of a scalar.
+bool ScanDocumentStarts(const char* input, std::size_t size,
+                        std::vector<DocumentStart>& starts);
+
+// The size of the byte order mark that 'input' starts with, if any; the
+// positions ScanDocumentStarts returns are counted from after it.
+std::size_t Utf8ByteOrderMarkSize(const char* input, std::size_t size);
+
+// What a line is, as far as finding documents goes: a directive, a document
+// marker, a line with only blanks or a comment, or anything else.
+enum class LineType { Directive, DocStart, DocEnd, Empty, Content };
+
+// Classifies the line from 'line' to 'end' (after its '\n', if it has one).
+LineType ClassifyLine(const char* line, const char* end);
+
+// Whether the rest of the line from 'p' has nothing but blanks and maybe a
+// comment; 'end' is the end of the line (after its '\n', if any).
+bool IsEmptyFrom(const char* p, const char* end);
+}  // namespace YAML
+
+#endif  // DOCINDEX_H_62B23520_7C8E_11DE_8A39_0800200C9A66
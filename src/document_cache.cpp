@@ -0,0 +1,371 @@
+#include "yaml-cpp/node/document_cache.h"
+
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+#include <fstream>
+#include <future>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "memorybuf.h"
+#include "nodebuilder.h"
+#include "readfile.h"
+#include "snapshotcache.h"
+#include "yaml-cpp/exceptions.h"
+#include "yaml-cpp/node/detail/memory.h"
+#include "yaml-cpp/node/detail/node.h"
+#include "yaml-cpp/node/detail/node_data.h"
+#include "yaml-cpp/node/impl.h"
+#include "yaml-cpp/parser.h"
+
+namespace YAML {
+namespace {
+// What a node takes up, besides its scalar: the node, its ref and data, and
+// (roughly) their control blocks and its place in its memory's set.
+const std::size_t kNodeBytes = sizeof(detail::node) + sizeof(detail::node_ref) +
+                               sizeof(detail::node_data) + 128;
+
+// FileStamp
+// . What's checked, on each Get, to see if a file has changed.
+struct FileStamp {
+  std::uint64_t size;
+  std::int64_t modified;  // in seconds, like std::time
+};
+
+bool Stat(const std::string& filename, FileStamp& stamp) {
+  struct stat info;
+  if (stat(filename.c_str(), &info) != 0)
+    return false;
+  stamp.size = static_cast<std::uint64_t>(info.st_size);
+  stamp.modified = static_cast<std::int64_t>(info.st_mtime);
+  return true;
+}
+
+// The version of the next table any cache makes.
+std::atomic<std::uint64_t> nextVersion(1);
+
+// The time an entry was last asked for, in microseconds.
+std::int64_t Now() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+}  // namespace
+
+namespace detail {
+// document_cache_entry
+// . A file's document, and what's needed to tell if it's still the file's.
+// . It's never changed once it's in the cache (but for when it was last
+//   asked for), so readers can share it without locking; when the file
+//   changes, it's replaced.
+struct document_cache_entry {
+  document_cache_entry(std::shared_ptr<const Node> document_,
+                       const FileStamp& stamp_, std::int64_t readAt_,
+                       const Sha256Digest& hash_, std::size_t length_,
+                       std::size_t bytes_)
+      : document(std::move(document_)),
+        stamp(stamp_),
+        readAt(readAt_),
+        hash(hash_),
+        length(length_),
+        bytes(bytes_),
+        used(Now()) {}
+
+  const std::shared_ptr<const Node> document;
+  const FileStamp stamp;
+  const std::int64_t readAt;  // when the file was read, like stamp.modified
+  const Sha256Digest hash;  // and length: the file's contents'
+  const std::size_t length;
+  const std::size_t bytes;
+  mutable std::atomic<std::int64_t> used;
+};
+
+// document_cache_data
+// . The entries are in a table that's replaced, rather than changed, so a
+//   reader only has to take the current one; those that change it take the
+//   mutex, and copy it.
+// . Each table has a version, unique among every cache's, so that a reader
+//   can tell if the one it took last is still current (see CurrentTable)
+//   without taking pTable, which std::atomic_load does with a lock.
+struct document_cache_data {
+  using Entry = std::shared_ptr<const document_cache_entry>;
+  using Table = std::unordered_map<std::string, Entry>;
+
+  explicit document_cache_data(std::size_t maxBytes_)
+      : maxBytes(maxBytes_),
+        pTable(new Table),
+        version(nextVersion++),
+        mutex{},
+        bytes(0),
+        loading{} {}
+
+  const std::size_t maxBytes;
+  std::shared_ptr<const Table> pTable;
+  std::atomic<std::uint64_t> version;  // of pTable
+  std::mutex mutex;
+  std::atomic<std::size_t> bytes;  // of the entries in the table
+  // the files being loaded, for those that ask for them meanwhile to wait for
+  std::unordered_map<std::string, std::shared_future<Entry>> loading;
+};
+}  // namespace detail
+
+namespace {
+using Entry = detail::document_cache_data::Entry;
+using Table = detail::document_cache_data::Table;
+
+// SetTable
+// . Replaces the cache's table; the mutex must be held. (The table is
+//   allocated on its own, not with std::make_shared, so the weak pointers
+//   that readers keep to it don't keep its memory.)
+void SetTable(detail::document_cache_data& data,
+              std::shared_ptr<const Table> pTable) {
+  std::atomic_store(&data.pTable, std::move(pTable));
+  data.version.store(nextVersion++, std::memory_order_release);
+}
+
+// CurrentTable
+// . Returns the cache's table. Each thread remembers the last table it took
+//   from a few caches, with its version; while that's still the cache's
+//   version, the table is taken from there, with no lock (weak_ptr::lock
+//   only counts a reference).
+std::shared_ptr<const Table> CurrentTable(
+    const detail::document_cache_data& data) {
+  struct Slot {
+    Slot() : pData(nullptr), version(0), pTable{} {}
+    Slot(const Slot&) = delete;
+    Slot& operator=(const Slot&) = delete;
+
+    const detail::document_cache_data* pData;
+    std::uint64_t version;
+    std::weak_ptr<const Table> pTable;
+  };
+  static thread_local Slot slots[8];
+  Slot& slot = slots[reinterpret_cast<std::uintptr_t>(&data) /
+                     sizeof(detail::document_cache_data) % 8];
+
+  const std::uint64_t version = data.version.load(std::memory_order_acquire);
+  if (slot.pData == &data && slot.version == version) {
+    std::shared_ptr<const Table> pTable = slot.pTable.lock();
+    if (pTable)
+      return pTable;
+  }
+  std::shared_ptr<const Table> pTable = std::atomic_load(&data.pTable);
+  slot.pData = &data;
+  slot.version = version;
+  slot.pTable = pTable;
+  return pTable;
+}
+
+// Fresh
+// . Returns whether the entry is still the file's, judging by its stamp. A
+//   file modified in the second it was read (or after) may have changed
+//   after it was read, without its stamp showing it; so it's read again.
+bool Fresh(const detail::document_cache_entry& entry, const FileStamp& stamp) {
+  return entry.stamp.size == stamp.size &&
+         entry.stamp.modified == stamp.modified &&
+         entry.stamp.modified < entry.readAt;
+}
+
+void Touch(const detail::document_cache_entry& entry) {
+  // (at most every millisecond, so readers of an entry don't keep writing
+  // to it)
+  const std::int64_t now = Now();
+  if (now - entry.used.load(std::memory_order_relaxed) >= 1000)
+    entry.used.store(now, std::memory_order_relaxed);
+}
+
+std::string ReadFile(const std::string& filename, std::uint64_t size) {
+  std::ifstream fin(filename);
+  if (!fin) {
+    throw BadFile(filename);
+  }
+  return ReadSized(fin, static_cast<std::size_t>(size), filename);
+}
+
+// Read
+// . Reads the file, and makes an entry for it: with the document of
+//   'pCached' (its last entry, if it has one) or of another file, if one of
+//   those has the same contents, and otherwise by parsing it.
+Entry Read(const detail::document_cache_data& data,
+           const std::string& filename, const Entry& pCached) {
+  // (it's stamped before it's read, so that a change while it's read shows
+  // the next time)
+  FileStamp stamp;
+  if (!Stat(filename, stamp)) {
+    throw BadFile(filename);
+  }
+  const std::int64_t readAt = static_cast<std::int64_t>(std::time(nullptr));
+  const std::string input = ReadFile(filename, stamp.size);
+  const Sha256Digest hash = ContentHash(input);
+
+  auto same = [&](const Entry& pEntry) {
+    return pEntry && pEntry->hash == hash && pEntry->length == input.size();
+  };
+  Entry pSame = same(pCached) ? pCached : nullptr;
+  if (!pSame) {
+    const std::shared_ptr<const Table> pTable = CurrentTable(data);
+    for (const Table::value_type& entry : *pTable) {
+      if (same(entry.second)) {
+        pSame = entry.second;
+        break;
+      }
+    }
+  }
+  if (pSame) {
+    return std::make_shared<const detail::document_cache_entry>(
+        pSame->document, stamp, readAt, hash, input.size(), pSame->bytes);
+  }
+
+  MemoryBuf buffer(input.data(), input.size());
+  std::istream stream(&buffer);
+  Parser parser(stream);
+  NodeBuilder builder;
+  const bool loaded =
+      parser.HandleNextDocument(builder) && builder.RootNode();
+  auto pDocument = std::make_shared<const Node>(
+      loaded ? builder.Root() : Node(NodeType::Null));
+  const std::size_t bytes =
+      input.size() + builder.Memory()->size() * kNodeBytes;
+  return std::make_shared<const detail::document_cache_entry>(
+      std::move(pDocument), stamp, readAt, hash, input.size(), bytes);
+}
+
+// Evict
+// . Drops the entries asked for least recently (other than 'kept') from the
+//   table, until they're within the cache's limit.
+void Evict(detail::document_cache_data& data, Table& table,
+           const std::string& kept) {
+  if (data.maxBytes == 0 || data.bytes <= data.maxBytes)
+    return;
+
+  std::vector<std::pair<std::int64_t, const std::string*>> entries;
+  entries.reserve(table.size());
+  for (const Table::value_type& entry : table) {
+    if (entry.first != kept)
+      entries.emplace_back(entry.second->used.load(std::memory_order_relaxed),
+                           &entry.first);
+  }
+  std::sort(entries.begin(), entries.end());
+
+  for (const auto& entry : entries) {
+    if (data.bytes <= data.maxBytes)
+      break;
+    auto it = table.find(*entry.second);
+    data.bytes -= it->second->bytes;
+    table.erase(it);
+  }
+}
+
+// Replace
+// . Puts the entry for the file in the table (or, if it's null, takes the
+//   file's out); the mutex must be held.
+void Replace(detail::document_cache_data& data, const std::string& filename,
+             const Entry& pEntry) {
+  const std::shared_ptr<const Table>& pCurrent = data.pTable;
+  if (!pEntry && pCurrent->find(filename) == pCurrent->end())
+    return;
+
+  std::shared_ptr<Table> pTable(new Table(*pCurrent));
+  auto it = pTable->find(filename);
+  if (it != pTable->end()) {
+    data.bytes -= it->second->bytes;
+    pTable->erase(it);
+  }
+  if (pEntry) {
+    pTable->emplace(filename, pEntry);
+    data.bytes += pEntry->bytes;
+    Evict(data, *pTable, filename);
+  }
+  SetTable(data, std::move(pTable));
+}
+
+// Publish
+// . Replaces the file's entry, once it's been loaded (or failed to), and
+//   tells those waiting for it.
+void Publish(detail::document_cache_data& data, const std::string& filename,
+             const Entry& pEntry) {
+  std::lock_guard<std::mutex> lock(data.mutex);
+  data.loading.erase(filename);
+  Replace(data, filename, pEntry);
+}
+
+// Load
+// . Loads the file into the cache, or, if another thread is loading it,
+//   waits for that.
+Entry Load(detail::document_cache_data& data, const std::string& filename,
+           const Entry& pCached) {
+  std::promise<Entry> promise;
+  {
+    std::unique_lock<std::mutex> lock(data.mutex);
+    auto it = data.loading.find(filename);
+    if (it != data.loading.end()) {
+      std::shared_future<Entry> loading = it->second;
+      lock.unlock();
+      return loading.get();
+    }
+    data.loading.emplace(filename, promise.get_future().share());
+  }
+
+  try {
+    const Entry pEntry = Read(data, filename, pCached);
+    Publish(data, filename, pEntry);
+    promise.set_value(pEntry);
+    return pEntry;
+  } catch (...) {
+    // (a file that can't be loaded now has no document)
+    Publish(data, filename, nullptr);
+    promise.set_exception(std::current_exception());
+    throw;
+  }
+}
+}  // namespace
+
+DocumentCache::DocumentCache(std::size_t maxBytes)
+    : m_pData(new detail::document_cache_data(maxBytes)) {}
+
+DocumentCache::~DocumentCache() = default;
+
+std::shared_ptr<const Node> DocumentCache::Get(const std::string& filename) {
+  const std::shared_ptr<const Table> pTable = CurrentTable(*m_pData);
+  auto it = pTable->find(filename);
+  const Entry pCached = it != pTable->end() ? it->second : nullptr;
+
+  FileStamp stamp;
+  if (!Stat(filename, stamp)) {
+    if (pCached) {
+      std::lock_guard<std::mutex> lock(m_pData->mutex);
+      Replace(*m_pData, filename, nullptr);
+    }
+    throw BadFile(filename);
+  }
+  if (pCached && Fresh(*pCached, stamp)) {
+    Touch(*pCached);
+    return pCached->document;
+  }
+  return Load(*m_pData, filename, pCached)->document;
+}
+
+void DocumentCache::Invalidate(const std::string& filename) {
+  std::lock_guard<std::mutex> lock(m_pData->mutex);
+  Replace(*m_pData, filename, nullptr);
+}
+
+void DocumentCache::Clear() {
+  std::lock_guard<std::mutex> lock(m_pData->mutex);
+  m_pData->bytes = 0;
+  SetTable(*m_pData, std::shared_ptr<const Table>(new Table));
+}
+
+std::size_t DocumentCache::size() const {
+  return CurrentTable(*m_pData)->size();
+}
+
+std::size_t DocumentCache::bytes() const { return m_pData->bytes; }
+}  // namespace YAML
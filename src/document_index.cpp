@@ -0,0 +1,346 @@
+#include "yaml-cpp/node/document_index.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <vector>
+
+#include "docindex.h"
+#include "memorybuf.h"
+#include "nodebuilder.h"
+#include "snapshotcache.h"
+#include "yaml-cpp/exceptions.h"
+#include "yaml-cpp/mark.h"
+#include "yaml-cpp/node/impl.h"
+#include "yaml-cpp/node/node.h"
+#include "yaml-cpp/nulleventhandler.h"
+#include "yaml-cpp/parser.h"
+
+namespace YAML {
+namespace detail {
+struct document_index_data {
+  document_index_data()
+      : size(0), hash{}, bom(0), starts{}, firsts{}, documents(0) {}
+
+  std::size_t size;    // of the stream, with its byte order mark
+  std::string hash;    // its ContentHash, in hex
+  std::size_t bom;     // the size of its UTF-8 byte order mark, if it has one
+  std::vector<DocumentStart> starts;
+  std::vector<std::size_t> firsts;  // the documents before each start
+  std::size_t documents;
+};
+}  // namespace detail
+
+// DocumentIndexer
+// . Gets at a DocumentIndex's data, for building, reading and writing it.
+class DocumentIndexer {
+ public:
+  static const detail::document_index_data& Data(const DocumentIndex& index) {
+    return *index.m_pData;
+  }
+  static DocumentIndex Make(detail::document_index_data&& data) {
+    data.firsts.clear();
+    data.documents = 0;
+    for (const DocumentStart& start : data.starts) {
+      data.firsts.push_back(data.documents);
+      data.documents += start.documents;
+    }
+    return DocumentIndex(
+        std::make_shared<const detail::document_index_data>(std::move(data)));
+  }
+};
+
+namespace {
+const char* const kHeader = "yaml-cpp document index 3";
+
+// CountDocuments
+// . Parses the stream (without building anything) to count its documents.
+std::size_t CountDocuments(const char* input, std::size_t size) {
+  MemoryBuf buffer(input, size);
+  std::istream stream(&buffer);
+  Parser parser(stream);
+  NullEventHandler handler;
+  std::size_t documents = 0;
+  while (parser.HandleNextDocument(handler)) {
+    documents++;
+  }
+  return documents;
+}
+
+// StreamSize
+// . Returns the size of the stream, which is left at its start.
+std::size_t StreamSize(std::istream& input) {
+  input.clear();
+  input.seekg(0, std::ios::end);
+  const std::streamoff end = input.tellg();
+  if (!input || end < 0) {
+    throw BadDocumentIndex("the stream can't be read at random");
+  }
+  input.seekg(0);
+  return static_cast<std::size_t>(end);
+}
+
+// ReadAt
+// . Appends 'size' bytes of the stream, from 'pos', to 'text'.
+void ReadAt(std::istream& input, std::size_t pos, std::size_t size,
+            std::string& text) {
+  const std::size_t offset = text.size();
+  text.resize(offset + size);
+  input.seekg(static_cast<std::streamoff>(pos));
+  if (size > 0) {
+    input.read(&text[offset], static_cast<std::streamsize>(size));
+  }
+  if (!input) {
+    throw BadDocumentIndex("it is not of this stream");
+  }
+}
+
+bool ReadNumber(std::istream& input, std::size_t& value) {
+  unsigned long long number = 0;
+  if (!(input >> number)) {
+    return false;
+  }
+  value = static_cast<std::size_t>(number);
+  return value == number;
+}
+
+// (the hash of the input is passed in, for BuildDocumentIndexFile, which has
+// already computed it)
+DocumentIndex BuildIndex(const std::string& input, const std::string& hash) {
+  detail::document_index_data data;
+  data.size = input.size();
+  data.hash = hash;
+  data.bom = Utf8ByteOrderMarkSize(input.data(), input.size());
+  if (!ScanDocumentStarts(input.data(), input.size(), data.starts)) {
+    // (LoadDocument then parses the stream from the start)
+    data.bom = 0;
+    data.starts.assign(1, DocumentStart());
+    DocumentStart& start = data.starts.front();
+    start.pos = start.line = 0;
+    start.directivesPos = start.directivesSize = start.directivesLines = 0;
+    start.ownDirectives = false;
+    start.documents = CountDocuments(input.data(), input.size());
+  }
+  return DocumentIndexer::Make(std::move(data));
+}
+}  // namespace
+
+DocumentIndex::DocumentIndex()
+    : m_pData(std::make_shared<const detail::document_index_data>()) {}
+
+DocumentIndex::DocumentIndex(
+    std::shared_ptr<const detail::document_index_data> pData)
+    : m_pData(std::move(pData)) {}
+
+std::size_t DocumentIndex::size() const { return m_pData->documents; }
+
+DocumentIndex BuildDocumentIndex(const std::string& input) {
+  return BuildIndex(input, ToHex(ContentHash(input)));
+}
+
+DocumentIndex BuildDocumentIndexFile(const std::string& filename,
+                                     const std::string& indexFilename) {
+  std::ifstream fin(filename, std::ios::binary);
+  if (!fin) {
+    throw BadFile(filename);
+  }
+
+  const std::string input((std::istreambuf_iterator<char>(fin)),
+                          std::istreambuf_iterator<char>());
+  const std::string hash = ToHex(ContentHash(input));
+
+  // (the size alone isn't enough: a file rewritten to the same size can have
+  // its cuts elsewhere)
+  if (!indexFilename.empty()) {
+    std::ifstream findex(indexFilename);
+    if (findex) {
+      try {
+        const DocumentIndex index = LoadDocumentIndex(findex);
+        const detail::document_index_data& data = DocumentIndexer::Data(index);
+        if (data.size == input.size() && data.hash == hash) {
+          return index;
+        }
+      } catch (const BadDocumentIndex&) {
+        // it's replaced below
+      }
+    }
+  }
+
+  const DocumentIndex index = BuildIndex(input, hash);
+  if (!indexFilename.empty()) {
+    try {
+      SaveDocumentIndexFile(index, indexFilename);
+    } catch (const BadFile&) {
+      // the index is only saved to save time
+      std::remove(indexFilename.c_str());
+    }
+  }
+  return index;
+}
+
+void SaveDocumentIndex(const DocumentIndex& index, std::ostream& output) {
+  const detail::document_index_data& data = DocumentIndexer::Data(index);
+  output << kHeader << "\n";
+  output << data.size << " " << data.hash << " " << data.bom << " "
+         << data.starts.size() << "\n";
+  for (const DocumentStart& start : data.starts) {
+    output << start.pos << " " << start.line << " " << start.directivesPos
+           << " " << start.directivesSize << " " << start.directivesLines
+           << " " << (start.ownDirectives ? 1 : 0) << " " << start.documents
+           << "\n";
+  }
+}
+
+void SaveDocumentIndexFile(const DocumentIndex& index,
+                           const std::string& filename) {
+  std::ofstream fout(filename);
+  if (!fout) {
+    throw BadFile(filename);
+  }
+  SaveDocumentIndex(index, fout);
+  if (!fout) {
+    throw BadFile(filename);
+  }
+}
+
+DocumentIndex LoadDocumentIndex(std::istream& input) {
+  std::string header;
+  if (!std::getline(input, header) || header != kHeader) {
+    throw BadDocumentIndex("it is not a document index");
+  }
+
+  detail::document_index_data data;
+  std::size_t count = 0;
+  if (!ReadNumber(input, data.size) || !(input >> data.hash) ||
+      !ReadNumber(input, data.bom) || !ReadNumber(input, count) ||
+      data.bom > data.size || count == 0) {
+    throw BadDocumentIndex("it is damaged");
+  }
+
+  const std::size_t size = data.size - data.bom;
+  for (std::size_t i = 0; i < count; i++) {
+    DocumentStart start;
+    std::size_t ownDirectives = 0;
+    if (!ReadNumber(input, start.pos) || !ReadNumber(input, start.line) ||
+        !ReadNumber(input, start.directivesPos) ||
+        !ReadNumber(input, start.directivesSize) ||
+        !ReadNumber(input, start.directivesLines) ||
+        !ReadNumber(input, ownDirectives) ||
+        !ReadNumber(input, start.documents)) {
+      throw BadDocumentIndex("it is truncated");
+    }
+    start.ownDirectives = ownDirectives != 0;
+
+    // each start is after the last, and its directives are before it
+    const bool first = data.starts.empty();
+    if ((first ? start.pos != 0 : start.pos <= data.starts.back().pos) ||
+        start.pos > size || ownDirectives > 1 ||
+        start.directivesPos > start.pos ||
+        start.directivesSize > start.pos - start.directivesPos) {
+      throw BadDocumentIndex("it is damaged");
+    }
+    data.starts.push_back(start);
+  }
+  return DocumentIndexer::Make(std::move(data));
+}
+
+DocumentIndex LoadDocumentIndexFile(const std::string& filename) {
+  std::ifstream fin(filename);
+  if (!fin) {
+    throw BadFile(filename);
+  }
+  return LoadDocumentIndex(fin);
+}
+
+Node LoadDocument(std::istream& input, const DocumentIndex& index,
+                  std::size_t n) {
+  const detail::document_index_data& data = DocumentIndexer::Data(index);
+  if (n >= data.documents) {
+    return Node(NodeType::Undefined);
+  }
+  if (StreamSize(input) != data.size) {
+    throw BadDocumentIndex("it is not of this stream");
+  }
+
+  // the start the document is at, and the documents before it there
+  const std::size_t i = static_cast<std::size_t>(
+      std::upper_bound(data.firsts.begin(), data.firsts.end(), n) -
+      data.firsts.begin() - 1);
+  const DocumentStart& start = data.starts[i];
+  const std::size_t end =
+      i + 1 < data.starts.size() ? data.starts[i + 1].pos : data.size - data.bom;
+  Mark mark;
+  mark.pos = static_cast<int>(start.pos);
+  mark.line = static_cast<int>(start.line);
+
+  std::string text;
+  if (start.pos == 0) {
+    // the byte order mark is skipped (and not counted) by the stream
+    ReadAt(input, 0, data.bom + end, text);
+  } else {
+    if (start.directivesSize > 0) {
+      // the directives come first, as if they'd been right before the cut
+      ReadAt(input, data.bom + start.directivesPos, start.directivesSize,
+             text);
+      mark.pos -= static_cast<int>(start.directivesSize);
+      mark.line -= static_cast<int>(start.directivesLines);
+    }
+
+    // (every cut is at the start of a line, which is a cheap check that the
+    // stream hasn't changed)
+    const std::size_t directivesSize = text.size();
+    ReadAt(input, data.bom + start.pos - 1, end - start.pos + 1, text);
+    if (text[directivesSize] != '\n') {
+      throw BadDocumentIndex("it is not of this stream");
+    }
+    text.erase(directivesSize, 1);
+  }
+
+  MemoryBuf buffer(text.data(), text.size());
+  std::istream stream(&buffer);
+  Parser parser;
+  parser.Load(stream, mark);
+  for (std::size_t skipped = data.firsts[i]; skipped < n; skipped++) {
+    NullEventHandler handler;
+    if (!parser.HandleNextDocument(handler)) {
+      throw BadDocumentIndex("it is not of this stream");
+    }
+  }
+
+  NodeBuilder builder;
+  if (!parser.HandleNextDocument(builder)) {
+    throw BadDocumentIndex("it is not of this stream");
+  }
+
+  // the rest of the documents at the start are parsed too, to check that
+  // there are as many as the index says; otherwise, the stream has a
+  // document that goes on after its root node ends (which yaml-cpp reads as
+  // another document, but the YAML spec doesn't allow, and the index didn't
+  // count), and the documents after it are numbered differently
+  for (std::size_t parsed = n + 1;
+       parsed < data.firsts[i] + start.documents; parsed++) {
+    NullEventHandler handler;
+    if (!parser.HandleNextDocument(handler)) {
+      throw BadDocumentIndex("it is not of this stream");
+    }
+  }
+  NullEventHandler handler;
+  if (parser.HandleNextDocument(handler)) {
+    throw BadDocumentIndex(
+        "the stream has documents that go on after their root nodes end");
+  }
+  return builder.Root();
+}
+
+Node LoadDocument(const std::string& filename, const DocumentIndex& index,
+                  std::size_t n) {
+  std::ifstream fin(filename, std::ios::binary);
+  if (!fin) {
+    throw BadFile(filename);
+  }
+  return LoadDocument(fin, index, n);
+}
+}  // namespace YAML
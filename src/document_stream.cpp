@@ -0,0 +1,37 @@
+#include "yaml-cpp/node/document_stream.h"
+
+#include "nodebuilder.h"
+#include "yaml-cpp/node/impl.h"
+#include "yaml-cpp/parser.h"
+
+namespace YAML {
+DocumentStream::DocumentStream(std::istream& input)
+    : m_pParser(new Parser(input)) {}
+
+DocumentStream::DocumentStream(DocumentStream&& rhs) YAML_CPP_NOEXCEPT =
+    default;
+DocumentStream& DocumentStream::operator=(DocumentStream&& rhs)
+    YAML_CPP_NOEXCEPT = default;
+DocumentStream::~DocumentStream() = default;
+
+DocumentStream::iterator DocumentStream::begin() {
+  iterator it(this);
+  return ++it;
+}
+
+DocumentStream::iterator DocumentStream::end() { return iterator(); }
+
+std::shared_ptr<const Node> DocumentStream::Next() {
+  if (!m_pParser) {
+    return nullptr;
+  }
+
+  NodeBuilder builder;
+  if (!m_pParser->HandleNextDocument(builder)) {
+    return nullptr;
+  }
+  return std::make_shared<const Node>(builder.Root());
+}
+
+DocumentStream Documents(std::istream& input) { return DocumentStream(input); }
+}  // namespace YAML
@@ -25,6 +25,7 @@ EmitterState::EmitterState()
       m_doublePrecision(std::numeric_limits<double>::max_digits10),
       //
       m_modifiedSettings{},
+      m_pendingSettingsBegin(0),
       m_globalModifiedSettings{},
       m_groups{},
       m_curIndent(0),
@@ -66,8 +67,8 @@ void EmitterState::SetLongKey() {
     return;
   }
 
-  assert(m_groups.back()->type == GroupType::Map);
-  m_groups.back()->longKey = true;
+  assert(m_groups.back().type == GroupType::Map);
+  m_groups.back().longKey = true;
 }
 
 void EmitterState::ForceFlow() {
@@ -76,16 +77,16 @@ void EmitterState::ForceFlow() {
     return;
   }
 
-  m_groups.back()->flowType = FlowType::Flow;
+  m_groups.back().flowType = FlowType::Flow;
 }
 
 void EmitterState::StartedNode() {
   if (m_groups.empty()) {
     m_docCount++;
   } else {
-    m_groups.back()->childCount++;
-    if (m_groups.back()->childCount % 2 == 0) {
-      m_groups.back()->longKey = false;
+    m_groups.back().childCount++;
+    if (m_groups.back().childCount % 2 == 0) {
+      m_groups.back().longKey = false;
     }
   }
 
@@ -133,27 +134,22 @@ void EmitterState::StartedGroup(GroupType::value type) {
   StartedNode();
 
   const std::size_t lastGroupIndent =
-      (m_groups.empty() ? 0 : m_groups.back()->indent);
+      (m_groups.empty() ? 0 : m_groups.back().indent);
   m_curIndent += lastGroupIndent;
 
-  // TODO: Create move constructors for settings types to simplify transfer
-  std::unique_ptr<Group> pGroup(new Group(type));
-
   // transfer settings (which last until this group is done)
-  //
-  // NB: if pGroup->modifiedSettings == m_modifiedSettings,
-  // m_modifiedSettings is not changed!
-  pGroup->modifiedSettings = std::move(m_modifiedSettings);
+  Group group(type, m_pendingSettingsBegin);
+  m_pendingSettingsBegin = m_modifiedSettings.size();
 
   // set up group
   if (GetFlowType(type) == Block) {
-    pGroup->flowType = FlowType::Block;
+    group.flowType = FlowType::Block;
   } else {
-    pGroup->flowType = FlowType::Flow;
+    group.flowType = FlowType::Flow;
   }
-  pGroup->indent = GetIndent();
+  group.indent = GetIndent();
 
-  m_groups.push_back(std::move(pGroup));
+  m_groups.push_back(group);
 }
 
 void EmitterState::EndedGroup(GroupType::value type) {
@@ -171,25 +167,27 @@ void EmitterState::EndedGroup(GroupType::value type) {
     SetError(ErrorMsg::INVALID_ANCHOR);
   }
 
-  // get rid of the current group
+  // get rid of the current group, along with its settings
   {
-    std::unique_ptr<Group> pFinishedGroup = std::move(m_groups.back());
+    const Group& finishedGroup = m_groups.back();
+    const GroupType::value finishedType = finishedGroup.type;
+    m_modifiedSettings.unwind(finishedGroup.settingsBegin);
+    m_pendingSettingsBegin = finishedGroup.settingsBegin;
     m_groups.pop_back();
-    if (pFinishedGroup->type != type) {
+    if (finishedType != type) {
       return SetError(ErrorMsg::UNMATCHED_GROUP_TAG);
     }
   }
 
   // reset old settings
-  std::size_t lastIndent = (m_groups.empty() ? 0 : m_groups.back()->indent);
+  std::size_t lastIndent = (m_groups.empty() ? 0 : m_groups.back().indent);
   assert(m_curIndent >= lastIndent);
   m_curIndent -= lastIndent;
 
   // some global settings that we changed may have been overridden
   // by a local setting we just popped, so we need to restore them
-  m_globalModifiedSettings.restore();
+  m_globalModifiedSettings.replay();
 
-  ClearModifiedSettings();
   m_hasAnchor = false;
   m_hasTag = false;
   m_hasNonContent = false;
@@ -200,27 +198,27 @@ EmitterNodeType::value EmitterState::CurGroupNodeType() const {
     return EmitterNodeType::NoType;
   }
 
-  return m_groups.back()->NodeType();
+  return m_groups.back().NodeType();
 }
 
 GroupType::value EmitterState::CurGroupType() const {
-  return m_groups.empty() ? GroupType::NoType : m_groups.back()->type;
+  return m_groups.empty() ? GroupType::NoType : m_groups.back().type;
 }
 
 FlowType::value EmitterState::CurGroupFlowType() const {
-  return m_groups.empty() ? FlowType::NoType : m_groups.back()->flowType;
+  return m_groups.empty() ? FlowType::NoType : m_groups.back().flowType;
 }
 
 std::size_t EmitterState::CurGroupIndent() const {
-  return m_groups.empty() ? 0 : m_groups.back()->indent;
+  return m_groups.empty() ? 0 : m_groups.back().indent;
 }
 
 std::size_t EmitterState::CurGroupChildCount() const {
-  return m_groups.empty() ? m_docCount : m_groups.back()->childCount;
+  return m_groups.empty() ? m_docCount : m_groups.back().childCount;
 }
 
 bool EmitterState::CurGroupLongKey() const {
-  return m_groups.empty() ? false : m_groups.back()->longKey;
+  return m_groups.empty() ? false : m_groups.back().longKey;
 }
 
 std::size_t EmitterState::LastIndent() const {
@@ -228,13 +226,15 @@ std::size_t EmitterState::LastIndent() const {
     return 0;
   }
 
-  return m_curIndent - m_groups[m_groups.size() - 2]->indent;
+  return m_curIndent - m_groups[m_groups.size() - 2].indent;
 }
 
-void EmitterState::ClearModifiedSettings() { m_modifiedSettings.clear(); }
+void EmitterState::ClearModifiedSettings() {
+  m_modifiedSettings.unwind(m_pendingSettingsBegin);
+}
 
 void EmitterState::RestoreGlobalModifiedSettings() {
-  m_globalModifiedSettings.restore();
+  m_globalModifiedSettings.replay();
 }
 
 bool EmitterState::SetOutputCharset(EMITTER_MANIP value,
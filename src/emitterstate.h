@@ -12,8 +12,6 @@
 #include "yaml-cpp/emittermanip.h"
 
 #include <cassert>
-#include <memory>
-#include <stack>
 #include <stdexcept>
 #include <vector>
 
@@ -147,17 +145,21 @@ class EmitterState {
   Setting<std::size_t> m_floatPrecision;
   Setting<std::size_t> m_doublePrecision;
 
+  // Local changes form a single undo log: each group owns the entries from
+  // its 'settingsBegin' up to the next group's, and the entries from
+  // m_pendingSettingsBegin on belong to the node currently being built.
   SettingChanges m_modifiedSettings;
+  std::size_t m_pendingSettingsBegin;
   SettingChanges m_globalModifiedSettings;
 
   struct Group {
-    explicit Group(GroupType::value type_)
+    Group(GroupType::value type_, std::size_t settingsBegin_)
         : type(type_),
           flowType{},
           indent(0),
           childCount(0),
           longKey(false),
-          modifiedSettings{} {}
+          settingsBegin(settingsBegin_) {}
 
     GroupType::value type;
     FlowType::value flowType;
@@ -165,7 +167,7 @@ class EmitterState {
     std::size_t childCount;
     bool longKey;
 
-    SettingChanges modifiedSettings;
+    std::size_t settingsBegin;
 
     EmitterNodeType::value NodeType() const {
       if (type == GroupType::Seq) {
@@ -186,7 +188,7 @@ class EmitterState {
     }
   };
 
-  std::vector<std::unique_ptr<Group>> m_groups;
+  std::vector<Group> m_groups;
   std::size_t m_curIndent;
   bool m_hasAnchor;
   bool m_hasAlias;
@@ -199,12 +201,13 @@ template <typename T>
 void EmitterState::_Set(Setting<T>& fmt, T value, FmtScope::value scope) {
   switch (scope) {
     case FmtScope::Local:
-      m_modifiedSettings.push(fmt.set(value));
+      m_modifiedSettings.push(fmt);
+      fmt.set(value);
       break;
     case FmtScope::Global:
       fmt.set(value);
       m_globalModifiedSettings.push(
-          fmt.set(value));  // this pushes an identity set, so when we restore,
+          fmt);  // this records the new value, so when we restore,
       // it restores to the value here, and not the previous one
       break;
     default:
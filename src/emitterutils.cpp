@@ -2,6 +2,12 @@
 #include <iomanip>
 #include <sstream>
 
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define YAML_CPP_EMITTER_SSE2
+#endif
+
 #include "emitterutils.h"
 #include "exp.h"
 #include "indentation.h"
@@ -87,9 +93,9 @@ int Utf8BytesIndicated(char ch) {
 
 bool IsTrailingByte(char ch) { return (ch & 0xC0) == 0x80; }
 
-bool GetNextCodePointAndAdvance(int& codePoint,
-                                std::string::const_iterator& first,
-                                std::string::const_iterator last) {
+template <typename Iterator>
+bool GetNextCodePointAndAdvance(int& codePoint, Iterator& first,
+                                Iterator last) {
   if (first == last)
     return false;
 
@@ -152,8 +158,89 @@ void WriteCodePoint(ostream_wrapper& out, int codePoint) {
   }
 }
 
-bool IsValidPlainScalar(const std::string& str, FlowType::value flowType,
-                        bool allowOnlyAscii) {
+int Utf8Length(int codePoint) {
+  if (codePoint <= 0x7F)
+    return 1;
+  if (codePoint <= 0x7FF)
+    return 2;
+  if (codePoint <= 0xFFFF)
+    return 3;
+  return 4;
+}
+
+// Whether the bytes [first, last) that were just decoded into 'codePoint'
+// are exactly what WriteCodePoint would write for it, so they may be copied
+// to the output as they are.
+bool IsVerbatim(int codePoint, const char* first, const char* last) {
+  return codePoint != REPLACEMENT_CHARACTER &&
+         last - first == Utf8Length(codePoint);
+}
+
+bool IsSpecialByte(char ch, const char* specials, std::size_t numSpecials) {
+  return std::find(specials, specials + numSpecials, ch) !=
+         specials + numSpecials;
+}
+
+// CountOrdinaryBytes
+// . Returns the length of the longest prefix of [first, last) made only of
+//   printable ASCII (0x20-0x7E) other than the given special characters.
+// . The callers only need per-character handling past that prefix, so this
+//   is the hot loop for long strings; it checks 16 bytes at a time where SSE2
+//   is available.
+template <std::size_t N>
+std::size_t CountOrdinaryBytes(const char* first, const char* last,
+                               const char (&specials)[N]) {
+  const std::size_t numSpecials = N - 1;
+  const char* cur = first;
+
+#ifdef YAML_CPP_EMITTER_SSE2
+  const __m128i belowPrintable = _mm_set1_epi8(0x1F);
+  const __m128i del = _mm_set1_epi8(0x7F);
+  while (last - cur >= 16) {
+    const __m128i block =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(cur));
+    // a signed compare also rejects every byte >= 0x80
+    const __m128i printable = _mm_cmpgt_epi8(block, belowPrintable);
+    __m128i special = _mm_cmpeq_epi8(block, del);
+    for (std::size_t i = 0; i < numSpecials; i++) {
+      special = _mm_or_si128(
+          special, _mm_cmpeq_epi8(block, _mm_set1_epi8(specials[i])));
+    }
+    if (_mm_movemask_epi8(_mm_andnot_si128(special, printable)) != 0xFFFF) {
+      break;
+    }
+    cur += 16;
+  }
+#endif
+
+  for (; cur != last; ++cur) {
+    const unsigned char ch = static_cast<unsigned char>(*cur);
+    if (ch < 0x20 || ch >= 0x7F ||
+        IsSpecialByte(*cur, specials, numSpecials)) {
+      break;
+    }
+  }
+  return static_cast<std::size_t>(cur - first);
+}
+
+bool IsBreakAt(const char* cur, const char* last) {
+  return cur != last &&
+         (*cur == '\n' || (*cur == '\r' && cur + 1 != last && cur[1] == '\n'));
+}
+
+bool IsBlankOrBreakAt(const char* cur, const char* last) {
+  return cur != last && (*cur == ' ' || *cur == '\t' || IsBreakAt(cur, last));
+}
+
+// The styles a string can be emitted in; found in a single pass over it.
+struct StringStyles {
+  bool plain;
+  bool singleQuoted;
+  bool literal;
+};
+
+bool IsValidPlainScalarStart(const std::string& str,
+                             FlowType::value flowType) {
   // check against null
   if (IsNullString(str)) {
     return false;
@@ -168,54 +255,83 @@ bool IsValidPlainScalar(const std::string& str, FlowType::value flowType,
 
   // and check the end for plain whitespace (which can't be faithfully kept in a
   // plain scalar)
-  if (!str.empty() && *str.rbegin() == ' ') {
-    return false;
-  }
-
-  // then check until something is disallowed
-  static const RegEx& disallowed_flow =
-      Exp::EndScalarInFlow() | (Exp::BlankOrBreak() + Exp::Comment()) |
-      Exp::NotPrintable() | Exp::Utf8_ByteOrderMark() | Exp::Break() |
-      Exp::Tab();
-  static const RegEx& disallowed_block =
-      Exp::EndScalar() | (Exp::BlankOrBreak() + Exp::Comment()) |
-      Exp::NotPrintable() | Exp::Utf8_ByteOrderMark() | Exp::Break() |
-      Exp::Tab();
-  const RegEx& disallowed =
-      flowType == FlowType::Flow ? disallowed_flow : disallowed_block;
+  return str.empty() || *str.rbegin() != ' ';
+}
 
-  StringCharSource buffer(str.c_str(), str.size());
-  while (buffer) {
-    if (disallowed.Matches(buffer)) {
-      return false;
-    }
-    if (allowOnlyAscii && (0x80 <= static_cast<unsigned char>(buffer[0]))) {
-      return false;
+// ClassifyString
+// . Everything that isn't ordinary printable ASCII is checked against the
+//   rules below, which mirror the Exp:: expressions the scanner uses:
+//   . no breaks, tabs or non-printable characters (Exp::NotPrintable) in a
+//     plain scalar, nor a byte order mark
+//   . no ": " (Exp::EndScalar), nor " #" (a comment) in a plain scalar
+//   . in flow context, no flow indicators in a plain scalar
+//     (Exp::EndScalarInFlow)
+//   . no newlines in a single quoted scalar, and no literals in flow context
+//   . and if we're escaping non-ascii characters, then none of those styles
+//     can hold them
+StringStyles ClassifyString(const std::string& str, FlowType::value flowType,
+                            bool escapeNonAscii) {
+  StringStyles styles;
+  styles.plain = IsValidPlainScalarStart(str, flowType);
+  styles.singleQuoted = true;
+  styles.literal = flowType != FlowType::Flow;
+
+  const char* const first = str.data();
+  const char* const last = first + str.size();
+  const char* cur = first;
+  while (true) {
+    cur += flowType == FlowType::Flow
+               ? CountOrdinaryBytes(cur, last, ":#,?[]{}")
+               : CountOrdinaryBytes(cur, last, ":#");
+    if (cur == last) {
+      break;
     }
-    ++buffer;
-  }
 
-  return true;
-}
-
-bool IsValidSingleQuotedScalar(const std::string& str, bool escapeNonAscii) {
-  // TODO: check for non-printable characters?
-  return std::none_of(str.begin(), str.end(), [=](char ch) {
-    return (escapeNonAscii && (0x80 <= static_cast<unsigned char>(ch))) ||
-           (ch == '\n');
-  });
-}
+    const unsigned char ch = static_cast<unsigned char>(*cur);
+    const char* const next = cur + 1;
+    if (ch >= 0x80) {
+      if (escapeNonAscii) {
+        styles.plain = styles.singleQuoted = styles.literal = false;
+      } else if (ch == 0xC2 && next != last) {
+        const unsigned char nextCh = static_cast<unsigned char>(*next);
+        if ((nextCh >= 0x80 && nextCh <= 0x84) ||
+            (nextCh >= 0x86 && nextCh <= 0x9F)) {
+          styles.plain = false;
+        }
+      } else if (ch == 0xEF && last - next >= 2 &&
+                 static_cast<unsigned char>(next[0]) == 0xBB &&
+                 static_cast<unsigned char>(next[1]) == 0xBF) {
+        styles.plain = false;
+      }
+    } else if (ch == '\n') {
+      styles.plain = styles.singleQuoted = false;
+    } else if (ch == '\r') {
+      if (IsBreakAt(cur, last)) {
+        styles.plain = false;
+      }
+    } else if (ch < 0x20 || ch == 0x7F) {
+      styles.plain = false;
+    } else if (ch == ':') {
+      if (next == last || IsBlankOrBreakAt(next, last)) {
+        styles.plain = false;
+      }
+    } else if (ch == '#') {
+      if (cur != first && (cur[-1] == ' ' || cur[-1] == '\t' ||
+                           cur[-1] == '\n')) {
+        styles.plain = false;
+      }
+    } else {
+      // a flow indicator in flow context
+      styles.plain = false;
+    }
 
-bool IsValidLiteralScalar(const std::string& str, FlowType::value flowType,
-                          bool escapeNonAscii) {
-  if (flowType == FlowType::Flow) {
-    return false;
+    if (!styles.plain && !styles.singleQuoted && !styles.literal) {
+      break;
+    }
+    ++cur;
   }
 
-  // TODO: check for non-printable characters?
-  return std::none_of(str.begin(), str.end(), [=](char ch) {
-    return (escapeNonAscii && (0x80 <= static_cast<unsigned char>(ch)));
-  });
+  return styles;
 }
 
 std::pair<uint16_t, uint16_t> EncodeUTF16SurrogatePair(int codePoint) {
@@ -253,6 +369,54 @@ void WriteDoubleQuoteEscapeSequence(ostream_wrapper& out, int codePoint, StringE
     out << hexDigits[(codePoint >> (4 * (digits - 1))) & 0xF];
 }
 
+bool NeedsDoubleQuoteEscape(int codePoint,
+                            StringEscaping::value stringEscaping) {
+  switch (codePoint) {
+    case '\"':
+    case '\\':
+      return true;
+    default:
+      // Control characters and non-breaking space, and byte order marks
+      // (ZWNS) should be escaped (YAML 1.2, sec. 5.2)
+      return codePoint < 0x20 || (codePoint >= 0x80 && codePoint <= 0xA0) ||
+             codePoint == 0xFEFF ||
+             (stringEscaping == StringEscaping::NonAscii && codePoint > 0x7E);
+  }
+}
+
+void WriteDoubleQuotedCodePoint(ostream_wrapper& out, int codePoint,
+                                StringEscaping::value stringEscaping) {
+  switch (codePoint) {
+    case '\"':
+      out << "\\\"";
+      break;
+    case '\\':
+      out << "\\\\";
+      break;
+    case '\n':
+      out << "\\n";
+      break;
+    case '\t':
+      out << "\\t";
+      break;
+    case '\r':
+      out << "\\r";
+      break;
+    case '\b':
+      out << "\\b";
+      break;
+    case '\f':
+      out << "\\f";
+      break;
+    default:
+      if (NeedsDoubleQuoteEscape(codePoint, stringEscaping)) {
+        WriteDoubleQuoteEscapeSequence(out, codePoint, stringEscaping);
+      } else {
+        WriteCodePoint(out, codePoint);
+      }
+  }
+}
+
 bool WriteAliasName(ostream_wrapper& out, const std::string& str) {
   int codePoint;
   for (std::string::const_iterator i = str.begin();
@@ -273,19 +437,19 @@ StringFormat::value ComputeStringFormat(const std::string& str,
                                         bool escapeNonAscii) {
   switch (strFormat) {
     case Auto:
-      if (IsValidPlainScalar(str, flowType, escapeNonAscii)) {
+      if (ClassifyString(str, flowType, escapeNonAscii).plain) {
         return StringFormat::Plain;
       }
       return StringFormat::DoubleQuoted;
     case SingleQuoted:
-      if (IsValidSingleQuotedScalar(str, escapeNonAscii)) {
+      if (ClassifyString(str, flowType, escapeNonAscii).singleQuoted) {
         return StringFormat::SingleQuoted;
       }
       return StringFormat::DoubleQuoted;
     case DoubleQuoted:
       return StringFormat::DoubleQuoted;
     case Literal:
-      if (IsValidLiteralScalar(str, flowType, escapeNonAscii)) {
+      if (ClassifyString(str, flowType, escapeNonAscii).literal) {
         return StringFormat::Literal;
       }
       return StringFormat::DoubleQuoted;
@@ -296,22 +460,40 @@ StringFormat::value ComputeStringFormat(const std::string& str,
   return StringFormat::DoubleQuoted;
 }
 
+// The writers below copy runs of characters that need no special handling
+// straight to the output, and only decode (and possibly escape) one code
+// point at a time where the run ends.
 bool WriteSingleQuotedString(ostream_wrapper& out, const std::string& str) {
   out << "'";
-  int codePoint;
-  for (std::string::const_iterator i = str.begin();
-       GetNextCodePointAndAdvance(codePoint, i, str.end());) {
+  const char* const last = str.data() + str.size();
+  const char* cur = str.data();
+  const char* run = cur;
+  while (true) {
+    cur += CountOrdinaryBytes(cur, last, "'");
+    if (cur == last) {
+      break;
+    }
+
+    const char* const codePointStart = cur;
+    int codePoint;
+    GetNextCodePointAndAdvance(codePoint, cur, last);
     if (codePoint == '\n') {
       return false;  // We can't handle a new line and the attendant indentation
                      // yet
     }
+    if (codePoint != '\'' && IsVerbatim(codePoint, codePointStart, cur)) {
+      continue;
+    }
 
+    out.write(run, static_cast<std::size_t>(codePointStart - run));
     if (codePoint == '\'') {
       out << "''";
     } else {
       WriteCodePoint(out, codePoint);
     }
+    run = cur;
   }
+  out.write(run, static_cast<std::size_t>(cur - run));
   out << "'";
   return true;
 }
@@ -319,46 +501,28 @@ bool WriteSingleQuotedString(ostream_wrapper& out, const std::string& str) {
 bool WriteDoubleQuotedString(ostream_wrapper& out, const std::string& str,
                              StringEscaping::value stringEscaping) {
   out << "\"";
-  int codePoint;
-  for (std::string::const_iterator i = str.begin();
-       GetNextCodePointAndAdvance(codePoint, i, str.end());) {
-    switch (codePoint) {
-      case '\"':
-        out << "\\\"";
-        break;
-      case '\\':
-        out << "\\\\";
-        break;
-      case '\n':
-        out << "\\n";
-        break;
-      case '\t':
-        out << "\\t";
-        break;
-      case '\r':
-        out << "\\r";
-        break;
-      case '\b':
-        out << "\\b";
-        break;
-      case '\f':
-        out << "\\f";
-        break;
-      default:
-        if (codePoint < 0x20 ||
-            (codePoint >= 0x80 &&
-             codePoint <= 0xA0)) {  // Control characters and non-breaking space
-          WriteDoubleQuoteEscapeSequence(out, codePoint, stringEscaping);
-        } else if (codePoint == 0xFEFF) {  // Byte order marks (ZWNS) should be
-                                           // escaped (YAML 1.2, sec. 5.2)
-          WriteDoubleQuoteEscapeSequence(out, codePoint, stringEscaping);
-        } else if (stringEscaping == StringEscaping::NonAscii && codePoint > 0x7E) {
-          WriteDoubleQuoteEscapeSequence(out, codePoint, stringEscaping);
-        } else {
-          WriteCodePoint(out, codePoint);
-        }
+  const char* const last = str.data() + str.size();
+  const char* cur = str.data();
+  const char* run = cur;
+  while (true) {
+    cur += CountOrdinaryBytes(cur, last, "\"\\");
+    if (cur == last) {
+      break;
+    }
+
+    const char* const codePointStart = cur;
+    int codePoint;
+    GetNextCodePointAndAdvance(codePoint, cur, last);
+    if (!NeedsDoubleQuoteEscape(codePoint, stringEscaping) &&
+        IsVerbatim(codePoint, codePointStart, cur)) {
+      continue;
     }
+
+    out.write(run, static_cast<std::size_t>(codePointStart - run));
+    WriteDoubleQuotedCodePoint(out, codePoint, stringEscaping);
+    run = cur;
   }
+  out.write(run, static_cast<std::size_t>(cur - run));
   out << "\"";
   return true;
 }
@@ -367,15 +531,31 @@ bool WriteLiteralString(ostream_wrapper& out, const std::string& str,
                         std::size_t indent) {
   out << "|\n";
   out << IndentTo(indent);
-  int codePoint;
-  for (std::string::const_iterator i = str.begin();
-       GetNextCodePointAndAdvance(codePoint, i, str.end());) {
+  const char* const last = str.data() + str.size();
+  const char* cur = str.data();
+  const char* run = cur;
+  while (true) {
+    cur += CountOrdinaryBytes(cur, last, "");
+    if (cur == last) {
+      break;
+    }
+
+    const char* const codePointStart = cur;
+    int codePoint;
+    GetNextCodePointAndAdvance(codePoint, cur, last);
+    if (codePoint != '\n' && IsVerbatim(codePoint, codePointStart, cur)) {
+      continue;
+    }
+
+    out.write(run, static_cast<std::size_t>(codePointStart - run));
     if (codePoint == '\n') {
       out << "\n" << IndentTo(indent);
     } else {
       WriteCodePoint(out, codePoint);
     }
+    run = cur;
   }
+  out.write(run, static_cast<std::size_t>(cur - run));
   return true;
 }
 
@@ -489,8 +669,20 @@ bool WriteTagWithPrefix(ostream_wrapper& out, const std::string& prefix,
 }
 
 bool WriteBinary(ostream_wrapper& out, const Binary& binary) {
-  WriteDoubleQuotedString(out, EncodeBase64(binary.data(), binary.size()),
-                          StringEscaping::None);
+  // base64 never needs escaping, so we encode a chunk at a time straight
+  // into the output instead of building the whole string first
+  const std::size_t chunkSize = 3 * 1024;
+  char encoded[4 * 1024];
+
+  out << "\"";
+  const unsigned char* data = binary.data();
+  for (std::size_t remaining = binary.size(); remaining > 0;) {
+    const std::size_t size = std::min(remaining, chunkSize);
+    out.write(encoded, EncodeBase64(data, size, encoded));
+    data += size;
+    remaining -= size;
+  }
+  out << "\"";
   return true;
 }
 }  // namespace Utils
@@ -17,4 +17,7 @@ BadPushback::~BadPushback() YAML_CPP_NOEXCEPT = default;
 BadInsert::~BadInsert() YAML_CPP_NOEXCEPT = default;
 EmitterException::~EmitterException() YAML_CPP_NOEXCEPT = default;
 BadFile::~BadFile() YAML_CPP_NOEXCEPT = default;
+BadSnapshot::~BadSnapshot() YAML_CPP_NOEXCEPT = default;
+BadDocumentIndex::~BadDocumentIndex() YAML_CPP_NOEXCEPT = default;
+BadPath::~BadPath() YAML_CPP_NOEXCEPT = default;
 }  // namespace YAML
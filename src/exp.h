@@ -182,6 +182,14 @@ inline const RegEx& EscSingleQuote() {
   static const RegEx e = RegEx("\'\'");
   return e;
 }
+inline const RegEx& EndSingleQuotedScalar() {
+  static const RegEx e = RegEx('\'') & !EscSingleQuote();
+  return e;
+}
+inline const RegEx& EndDoubleQuotedScalar() {
+  static const RegEx e = RegEx('\"');
+  return e;
+}
 inline const RegEx& EscBreak() {
   static const RegEx e = RegEx('\\') + Break();
   return e;
@@ -0,0 +1,129 @@
+#ifndef INFLIGHT_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+#define INFLIGHT_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+
+#if defined(_MSC_VER) ||                                            \
+    (defined(__GNUC__) && (__GNUC__ == 3 && __GNUC_MINOR__ >= 4) || \
+     (__GNUC__ >= 4))  // GCC supports "pragma once" correctly since 3.4
+#pragma once
+#endif
+
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+
+namespace YAML {
+// InFlight
+// . Counts the bytes of the files that are read and not yet parsed, and
+//   keeps them under a limit (0 for none) by making a thread wait until
+//   there's room for the next file it reads; one file is always allowed, so
+//   a file over the limit is loaded on its own.
+// . A file that can't be sized (e.g., a pipe) is read a chunk at a time
+//   instead, and each chunk waits for room the same way, or until the file
+//   is the only one in flight. Only one such file grows at once, since it
+//   waits while it holds room, and two of them could wait on each other.
+class InFlight {
+ public:
+  explicit InFlight(std::size_t limit)
+      : m_limit(limit), m_bytes(0), m_growing(false), m_mutex{}, m_released{} {}
+
+  void Acquire(std::size_t bytes) {
+    if (m_limit == 0)
+      return;
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_released.wait(lock, [&] { return m_bytes == 0 || HasRoom(bytes); });
+    m_bytes += bytes;
+  }
+
+  void Release(std::size_t bytes) {
+    if (m_limit == 0)
+      return;
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_bytes -= bytes;
+    }
+    m_released.notify_all();
+  }
+
+  void BeginGrowing() {
+    if (m_limit == 0)
+      return;
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_released.wait(lock, [&] { return !m_growing; });
+    m_growing = true;
+  }
+
+  // (adds 'bytes' to the 'held' that the growing file has already)
+  void Grow(std::size_t held, std::size_t bytes) {
+    if (m_limit == 0)
+      return;
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_released.wait(lock, [&] { return m_bytes == held || HasRoom(bytes); });
+    m_bytes += bytes;
+  }
+
+  void EndGrowing(std::size_t held) {
+    if (m_limit == 0)
+      return;
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_bytes -= held;
+      m_growing = false;
+    }
+    m_released.notify_all();
+  }
+
+ private:
+  bool HasRoom(std::size_t bytes) const {
+    return m_bytes < m_limit && bytes <= m_limit - m_bytes;
+  }
+
+ private:
+  const std::size_t m_limit;
+  std::size_t m_bytes;
+  bool m_growing;  // is a file that couldn't be sized being read?
+  std::mutex m_mutex;
+  std::condition_variable m_released;
+};
+
+// Reservation
+// . Holds 'bytes' of an InFlight's room until it's destroyed.
+class Reservation {
+ public:
+  Reservation(InFlight& inFlight, std::size_t bytes)
+      : m_inFlight(inFlight), m_bytes(bytes) {
+    m_inFlight.Acquire(m_bytes);
+  }
+  Reservation(const Reservation&) = delete;
+  Reservation& operator=(const Reservation&) = delete;
+  ~Reservation() { m_inFlight.Release(m_bytes); }
+
+ private:
+  InFlight& m_inFlight;
+  const std::size_t m_bytes;
+};
+
+// GrowingReservation
+// . Holds the room of a file that couldn't be sized, as it's read, until
+//   it's destroyed.
+class GrowingReservation {
+ public:
+  explicit GrowingReservation(InFlight& inFlight)
+      : m_inFlight(inFlight), m_bytes(0) {
+    m_inFlight.BeginGrowing();
+  }
+  GrowingReservation(const GrowingReservation&) = delete;
+  GrowingReservation& operator=(const GrowingReservation&) = delete;
+  ~GrowingReservation() { m_inFlight.EndGrowing(m_bytes); }
+
+  void Grow(std::size_t bytes) {
+    m_inFlight.Grow(m_bytes, bytes);
+    m_bytes += bytes;
+  }
+
+ private:
+  InFlight& m_inFlight;
+  std::size_t m_bytes;
+};
+}  // namespace YAML
+
+#endif  // INFLIGHT_H_62B23520_7C8E_11DE_8A39_0800200C9A66
@@ -0,0 +1,679 @@
+#include "lazyload.h"
+
+#include <cstring>
+#include <istream>
+#include <unordered_map>
+#include <utility>
+
+#include "docindex.h"
+#include "memorybuf.h"
+#include "nodebuilder.h"
+#include "yaml-cpp/anchor.h"
+#include "yaml-cpp/emitterstyle.h"
+#include "yaml-cpp/exceptions.h"
+#include "yaml-cpp/mark.h"
+#include "yaml-cpp/node/detail/memory.h"
+#include "yaml-cpp/node/detail/node.h"
+#include "yaml-cpp/node/impl.h"
+#include "yaml-cpp/node/node.h"
+#include "yaml-cpp/node/parse.h"
+#include "yaml-cpp/parser.h"
+
+namespace YAML {
+namespace detail {
+namespace {
+// The smallest collection worth leaving lazy; anything smaller is parsed
+// along with the entries around it.
+const std::size_t kLazySize = 4096;
+
+bool IsBlank(char ch) {
+  return ch == ' ' || ch == '\t' || ch == '\r' || ch == '\n';
+}
+
+bool IsBlankOrEnd(const char* p, const char* end) {
+  return p == end || IsBlank(*p);
+}
+
+bool IsSequenceIndicator(const char* p, const char* end) {
+  return *p == '-' && IsBlankOrEnd(p + 1, end);
+}
+
+// KeyEnd
+// . If the line from 'p' to 'end' starts with a key that can't be anything
+//   else (a plain key, or a quoted one all on the line), returns its ':';
+//   otherwise (e.g., a complex key, or a tagged one), returns null.
+// . A key can't start with what could be a byte order mark, since it may
+//   be at the start of the text that's parsed.
+const char* KeyEnd(const char* p, const char* end) {
+  switch (static_cast<unsigned char>(*p)) {
+    case '"':
+    case '\'': {
+      const char quote = *p;
+      for (p++; p != end; p++) {
+        if (quote == '"' && *p == '\\') {
+          if (++p == end)
+            return nullptr;
+        } else if (*p == quote) {
+          if (quote == '"' || p + 1 == end || p[1] != '\'')
+            break;
+          p++;
+        }
+      }
+      if (p == end)
+        return nullptr;
+      for (p++; p != end && *p == ' '; p++) {
+      }
+      return p != end && *p == ':' && IsBlankOrEnd(p + 1, end) ? p : nullptr;
+    }
+    case '?':
+    case ':':
+    case '[':
+    case ']':
+    case '{':
+    case '}':
+    case ',':
+    case '#':
+    case '&':
+    case '*':
+    case '!':
+    case '|':
+    case '>':
+    case '%':
+    case '@':
+    case '`':
+    case '\t':
+    case '\r':
+    case 0xEF:
+    case 0xFE:
+    case 0xFF:
+      return nullptr;
+    default:
+      break;
+  }
+
+  for (; p != end; p++) {
+    if (*p == ':' && IsBlankOrEnd(p + 1, end))
+      return p;
+    if (*p == '#' && IsBlank(p[-1]))
+      return nullptr;
+  }
+  return nullptr;
+}
+
+// What the content from 'p' to 'end' (the rest of its line) starts: a block
+// map, a block sequence, or something else (Null).
+NodeType::value CollectionType(const char* p, const char* end) {
+  if (IsSequenceIndicator(p, end))
+    return NodeType::Sequence;
+  if (KeyEnd(p, end))
+    return NodeType::Map;
+  return NodeType::Null;
+}
+
+lazy_region MakeRegion(std::size_t begin, std::size_t line,
+                       std::size_t column, std::size_t indent,
+                       NodeType::value type) {
+  lazy_region region;
+  region.begin = begin;
+  region.end = begin;
+  region.line = line;
+  region.column = column;
+  region.indent = indent;
+  region.type = type;
+  return region;
+}
+
+Mark MakeMark(std::size_t pos, std::size_t line, std::size_t column) {
+  Mark mark;
+  mark.pos = static_cast<int>(pos);
+  mark.line = static_cast<int>(line);
+  mark.column = static_cast<int>(column);
+  return mark;
+}
+
+// The mark of the collection itself, which is where its first entry is.
+Mark CollectionMark(const lazy_region& region) {
+  return MakeMark(region.begin + region.indent - region.column, region.line,
+                  region.indent);
+}
+
+// SkimItem
+// . An entry of a collection (a key and its value, or an item) from 'begin'
+//   to 'end'; for a map, the key ends at 'keyEnd'.
+// . 'value' is where the value is, if it's a block collection; its type is
+//   Null otherwise. It's 'open' until we know, which is when a value starts
+//   on a later line than its key (or "-").
+struct SkimItem {
+  std::size_t begin;
+  std::size_t line;
+  std::size_t column;
+  std::size_t keyEnd;
+  std::size_t end;
+  bool open;
+  lazy_region value;
+};
+
+// Skimmer
+// . Finds the entries of a block collection, and where the values that are
+//   block collections are, a line at a time: an entry starts on each line
+//   at the collection's indent, and the lines indented more belong to it.
+// . It follows quoted scalars and flow collections (which may run over
+//   several lines, whatever their indent) and skips block scalars, but
+//   doesn't decode anything.
+// . It fails on anything it isn't sure of (e.g., a line indented less than
+//   the collection, a complex key, or a flow collection that's still open
+//   at a line that would start an entry); then the collection is just
+//   parsed whole.
+class Skimmer {
+ public:
+  Skimmer(const char* input, const lazy_region& region)
+      : m_input(input),
+        m_region(region),
+        m_quote(0),
+        m_flowDepth(0),
+        m_atStart(false),
+        m_blockScalar(false) {}
+  Skimmer(const Skimmer&) = delete;
+  Skimmer& operator=(const Skimmer&) = delete;
+
+  bool Skim(std::vector<SkimItem>& items);
+
+ private:
+  SkimItem& AddItem(std::vector<SkimItem>& items, const char* p,
+                    std::size_t line, std::size_t column,
+                    const char* keyEnd);
+  void ScanLine(const char* p, const char* end);
+
+  const char* const m_input;
+  const lazy_region& m_region;
+
+  // carried from line to line
+  char m_quote;
+  std::size_t m_flowDepth;
+  bool m_atStart;
+  bool m_blockScalar;
+};
+
+bool Skimmer::Skim(std::vector<SkimItem>& items) {
+  const char* const end = m_input + m_region.end;
+  bool inBlockScalar = false;
+  std::size_t blockIndent = 0;
+
+  std::size_t line = m_region.line;
+  std::size_t column = m_region.column;
+  for (const char* p = m_input + m_region.begin, *next = p; p != end;
+       p = next, line++, column = 0) {
+    const char* eol = static_cast<const char*>(
+        std::memchr(p, '\n', static_cast<std::size_t>(end - p)));
+    if (!eol)
+      eol = end;
+    next = eol == end ? end : eol + 1;
+
+    const char* q = p;
+    while (q != eol && *q == ' ')
+      q++;
+    const std::size_t indent = column + static_cast<std::size_t>(q - p);
+    const bool empty = IsEmptyFrom(q, next);
+
+    if (m_quote || m_flowDepth > 0) {
+      if (!empty && indent <= m_region.indent)
+        return false;
+      ScanLine(p, eol);
+      continue;
+    }
+    if (inBlockScalar) {
+      if (empty || indent > blockIndent)
+        continue;
+      inBlockScalar = false;
+    }
+    if (empty)
+      continue;
+    if (*q == '\t' || indent < m_region.indent)
+      return false;
+
+    m_atStart = true;
+    const std::size_t pos = static_cast<std::size_t>(p - m_input);
+    if (indent > m_region.indent) {
+      if (items.empty())
+        return false;
+      SkimItem& item = items.back();
+      if (item.open) {
+        item.open = false;
+        item.value =
+            MakeRegion(pos, line, column, indent, CollectionType(q, eol));
+      }
+      ScanLine(q, eol);
+    } else if (m_region.type == NodeType::Sequence) {
+      if (!IsSequenceIndicator(q, eol))
+        return false;
+      SkimItem& item = AddItem(items, p, line, column, nullptr);
+      const char* content = q + 1;
+      while (content != eol && *content == ' ')
+        content++;
+      item.open = IsEmptyFrom(content, next);
+      if (!item.open) {
+        const std::size_t contentColumn =
+            indent + static_cast<std::size_t>(content - q);
+        item.value = MakeRegion(static_cast<std::size_t>(content - m_input),
+                                line, contentColumn, contentColumn,
+                                CollectionType(content, eol));
+      }
+      ScanLine(q + 1, eol);
+    } else if (IsSequenceIndicator(q, eol)) {
+      // a sequence at the same indent as its key
+      if (items.empty())
+        return false;
+      SkimItem& item = items.back();
+      if (item.open) {
+        item.open = false;
+        item.value =
+            MakeRegion(pos, line, column, indent, NodeType::Sequence);
+      } else if (item.value.type != NodeType::Sequence ||
+                 item.value.indent != indent) {
+        return false;
+      }
+      ScanLine(q + 1, eol);
+    } else {
+      const char* colon = KeyEnd(q, eol);
+      if (!colon)
+        return false;
+      SkimItem& item = AddItem(items, p, line, column, colon + 1);
+      item.open = IsEmptyFrom(colon + 1, next);
+      ScanLine(colon + 1, eol);
+    }
+
+    if (m_blockScalar) {
+      m_blockScalar = false;
+      inBlockScalar = true;
+      blockIndent = indent;
+    }
+  }
+
+  if (m_quote || m_flowDepth > 0 || items.empty())
+    return false;
+  for (std::size_t i = 0; i < items.size(); i++) {
+    items[i].end = i + 1 < items.size() ? items[i + 1].begin : m_region.end;
+    items[i].value.end = items[i].end;
+  }
+  return true;
+}
+
+SkimItem& Skimmer::AddItem(std::vector<SkimItem>& items, const char* p,
+                           std::size_t line, std::size_t column,
+                           const char* keyEnd) {
+  const std::size_t pos = static_cast<std::size_t>(p - m_input);
+  SkimItem item;
+  item.begin = pos;
+  item.line = line;
+  item.column = column;
+  item.keyEnd = keyEnd ? static_cast<std::size_t>(keyEnd - m_input) : pos;
+  item.end = pos;
+  item.open = false;
+  item.value = MakeRegion(pos, line, column, 0, NodeType::Null);
+  items.push_back(item);
+  return items.back();
+}
+
+// ScanLine
+// . Follows the line from 'p' to 'end' (the end of the line): where quoted
+//   scalars and flow collections start and end (m_quote and m_flowDepth,
+//   which may be left open for the next line), and whether a block scalar
+//   starts (m_blockScalar).
+// . m_atStart is whether we're where a node could start (after the indent,
+//   a "- ", a ": ", a tag, and so on), since only there does a quote or a
+//   bracket start something, rather than being part of a plain scalar.
+void Skimmer::ScanLine(const char* p, const char* end) {
+  for (; p != end; p++) {
+    const char ch = *p;
+    if (m_quote == '\'') {
+      if (ch == '\'') {
+        if (p + 1 != end && p[1] == '\'') {
+          p++;
+        } else {
+          m_quote = 0;
+          m_atStart = false;
+        }
+      }
+      continue;
+    }
+    if (m_quote == '"') {
+      if (ch == '\\') {
+        if (p + 1 != end)
+          p++;
+      } else if (ch == '"') {
+        m_quote = 0;
+        m_atStart = false;
+      }
+      continue;
+    }
+
+    if (ch == ' ' || ch == '\t' || ch == '\r')
+      continue;
+    if (ch == '#' && (p == m_input || IsBlank(p[-1])))
+      return;
+    if (ch == '!' && m_atStart) {
+      while (p + 1 != end && !IsBlank(p[1]))
+        p++;
+      continue;
+    }
+
+    if (m_flowDepth > 0) {
+      switch (ch) {
+        case '[':
+        case '{':
+          m_flowDepth++;
+          m_atStart = true;
+          break;
+        case ']':
+        case '}':
+          m_flowDepth--;
+          m_atStart = false;
+          break;
+        case ',':
+        case ':':
+          m_atStart = true;
+          break;
+        case '"':
+        case '\'':
+          if (m_atStart)
+            m_quote = ch;
+          m_atStart = false;
+          break;
+        default:
+          m_atStart = false;
+          break;
+      }
+      continue;
+    }
+
+    if (m_atStart) {
+      switch (ch) {
+        case '"':
+        case '\'':
+          m_quote = ch;
+          continue;
+        case '[':
+        case '{':
+          m_flowDepth = 1;
+          continue;
+        case '|':
+        case '>':
+          m_blockScalar = true;
+          return;
+        case '-':
+        case '?':
+        case ':':
+          if (IsBlankOrEnd(p + 1, end))
+            continue;
+          break;
+        default:
+          break;
+      }
+    }
+    m_atStart = ch == ':' && IsBlankOrEnd(p + 1, end);
+  }
+}
+
+// CanSkim
+// . Whether 'input' has nothing that the skim doesn't handle: it must be a
+//   single document with no directives or document markers, in UTF-8 with
+//   no byte order mark, and with no anchors or aliases (since the parts of
+//   the document are parsed on their own). Anything that could be an anchor
+//   or an alias counts, even in a scalar or a comment.
+bool CanSkim(const std::string& input) {
+  const char* const begin = input.data();
+  const char* const end = begin + input.size();
+  if (begin != end && (Utf8ByteOrderMarkSize(begin, input.size()) > 0 ||
+                       static_cast<unsigned char>(*begin) == 0xFE ||
+                       static_cast<unsigned char>(*begin) == 0xFF))
+    return false;
+
+  for (const char* p = begin; p != end; p++) {
+    if (p == begin || p[-1] == '\n') {
+      const char* eol = static_cast<const char*>(
+          std::memchr(p, '\n', static_cast<std::size_t>(end - p)));
+      const LineType type = ClassifyLine(p, eol ? eol + 1 : end);
+      if (type != LineType::Content && type != LineType::Empty)
+        return false;
+    }
+    switch (*p) {
+      case '\0':
+        return false;
+      case '\r':
+        if (p + 1 == end || p[1] != '\n')
+          return false;
+        break;
+      case '&':
+      case '*':
+        if ((p == begin || IsBlank(p[-1]) || p[-1] == '[' || p[-1] == '{' ||
+             p[-1] == ',') &&
+            !IsBlankOrEnd(p + 1, end))
+          return false;
+        break;
+      default:
+        break;
+    }
+  }
+  return true;
+}
+
+// The top level of 'input', if it's a block collection that can be skimmed.
+bool SkimRoot(const std::string& input, lazy_region& region) {
+  if (!CanSkim(input))
+    return false;
+
+  const char* const begin = input.data();
+  const char* const end = begin + input.size();
+  std::size_t line = 0;
+  for (const char* p = begin; p != end; line++) {
+    const char* eol = static_cast<const char*>(
+        std::memchr(p, '\n', static_cast<std::size_t>(end - p)));
+    if (!eol)
+      eol = end;
+    const char* next = eol == end ? end : eol + 1;
+    if (!IsEmptyFrom(p, next)) {
+      const char* q = p;
+      while (q != eol && *q == ' ')
+        q++;
+      const std::size_t indent = static_cast<std::size_t>(q - p);
+      region = MakeRegion(static_cast<std::size_t>(p - begin), line, 0,
+                          indent, CollectionType(q, eol));
+      region.end = input.size();
+      return region.type != NodeType::Null;
+    }
+    p = next;
+  }
+  return false;
+}
+
+// ParseRun
+// . Parses the text from 'begin' to 'end' (which starts at 'mark') as a
+//   collection of 'type', and adds its children to 'children'; its nodes
+//   go into 'memory'.
+// . The text goes on over the indent of the line at 'end', if it ends at
+//   the start of one, so that it ends where Load would see the next token;
+//   that's the mark of a null value at the end of it.
+// . It must be just the one collection (e.g., a line indented less than
+//   the collection, but more than its parent, ends it early); if it isn't,
+//   or it has an error, the whole input is loaded, to throw Load's error.
+void ParseRun(const std::string& input, std::size_t begin, std::size_t end,
+              const Mark& mark, NodeType::value type, memory_holder& memory,
+              std::vector<node*>& children) {
+  while (end < input.size() && input[end] == ' ')
+    end++;
+  MemoryBuf buffer(input.data() + begin, end - begin);
+  std::istream stream(&buffer);
+  Parser parser;
+  NodeBuilder builder;
+  node* root = nullptr;
+  try {
+    parser.Load(stream, mark);
+    parser.HandleNextDocument(builder);
+    root = builder.RootNode();
+    if (!root || root->type() != type || parser)
+      throw ParserException(mark, type == NodeType::Map
+                                      ? ErrorMsg::END_OF_MAP
+                                      : ErrorMsg::END_OF_SEQ);
+  } catch (const ParserException&) {
+    Load(input);
+    throw;
+  }
+
+  memory.merge(*builder.Memory());
+  for (node_iterator it = root->begin(); it != root->end(); ++it) {
+    if (type == NodeType::Sequence) {
+      children.push_back((*it).pNode);
+    } else {
+      children.push_back((*it).first);
+      children.push_back((*it).second);
+    }
+  }
+}
+
+// LoadRegion
+// . Loads the collection in 'region' into 'children' (see
+//   lazy_collection::load): its entries are skimmed, and each run of
+//   entries whose values are small is parsed in one go, while each big
+//   collection is left lazy.
+void LoadRegion(const std::shared_ptr<const std::string>& pInput,
+                const lazy_region& region, memory_holder& memory,
+                std::vector<node*>& children) {
+  const std::string& input = *pInput;
+  std::vector<SkimItem> items;
+  Skimmer skimmer(input.data(), region);
+  if (!skimmer.Skim(items)) {
+    ParseRun(input, region.begin, region.end,
+             MakeMark(region.begin, region.line, region.column), region.type,
+             memory, children);
+    return;
+  }
+
+  std::size_t run = 0;
+  for (std::size_t i = 0; i <= items.size(); i++) {
+    const bool lazy = i < items.size() &&
+                      items[i].value.type != NodeType::Null &&
+                      items[i].value.end - items[i].value.begin >= kLazySize;
+    if (i < items.size() && !lazy)
+      continue;
+
+    if (run < i) {
+      const SkimItem& first = items[run];
+      ParseRun(input, first.begin, items[i - 1].end,
+               MakeMark(first.begin, first.line, first.column), region.type,
+               memory, children);
+    }
+    run = i + 1;
+    if (i == items.size())
+      break;
+
+    const SkimItem& item = items[i];
+    if (region.type == NodeType::Map) {
+      std::vector<node*> pair;
+      ParseRun(input, item.begin, item.keyEnd,
+               MakeMark(item.begin, item.line, item.column), NodeType::Map,
+               memory, pair);
+      children.push_back(pair[0]);
+    }
+
+    node& value = memory.create_node();
+    value.set_type(item.value.type);
+    value.set_tag("?");
+    value.set_style(EmitterStyle::Block);
+    value.set_mark(CollectionMark(item.value));
+    value.set_lazy(std::make_shared<lazy_collection>(pInput, item.value));
+    children.push_back(&value);
+  }
+}
+}  // namespace
+
+lazy_collection::lazy_collection(std::shared_ptr<const std::string> pInput,
+                                 const lazy_region& region)
+    : m_mutex{},
+      m_loaded(false),
+      m_pInput(std::move(pInput)),
+      m_region(region),
+      m_pMemory{} {}
+
+// (std::call_once would do, but libstdc++'s has hung when the function
+// throws, which this does for a malformed collection)
+void lazy_collection::load(const adder& add) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (m_loaded.load(std::memory_order_relaxed))
+    return;
+
+  std::vector<node*> children;
+  shared_memory_holder pMemory(new memory_holder);
+  LoadRegion(m_pInput, m_region, *pMemory, children);
+  add(children);
+  m_pMemory = pMemory;
+  m_pInput.reset();
+  m_loaded.store(true, std::memory_order_release);
+}
+
+namespace {
+// (it's never destroyed, since nodes that are may still be using it then)
+struct LazyTable {
+  LazyTable() : mutex{}, collections{} {}
+
+  std::mutex mutex;
+  std::unordered_map<const node_data*, shared_lazy_collection> collections;
+};
+
+LazyTable& TheLazyTable() {
+  static LazyTable* const table = new LazyTable;
+  return *table;
+}
+}  // namespace
+
+void set_lazy_collection(const node_data& data,
+                         shared_lazy_collection pLazy) {
+  LazyTable& table = TheLazyTable();
+  shared_lazy_collection pOld;
+  std::lock_guard<std::mutex> lock(table.mutex);
+  shared_lazy_collection& slot = table.collections[&data];
+  pOld = std::move(slot);
+  slot = std::move(pLazy);
+}
+
+shared_lazy_collection lazy_collection_of(const node_data& data) {
+  LazyTable& table = TheLazyTable();
+  std::lock_guard<std::mutex> lock(table.mutex);
+  return table.collections.at(&data);
+}
+
+shared_lazy_collection take_lazy_collection(const node_data& data) {
+  LazyTable& table = TheLazyTable();
+  std::lock_guard<std::mutex> lock(table.mutex);
+  auto it = table.collections.find(&data);
+  if (it == table.collections.end())
+    return nullptr;
+  shared_lazy_collection pLazy = std::move(it->second);
+  table.collections.erase(it);
+  return pLazy;
+}
+}  // namespace detail
+
+Node LoadLazily(std::shared_ptr<const std::string> pInput) {
+  detail::lazy_region region;
+  if (!detail::SkimRoot(*pInput, region)) {
+    return Load(*pInput);
+  }
+
+  NodeBuilder builder;
+  const Mark mark = detail::CollectionMark(region);
+  if (region.type == NodeType::Map) {
+    builder.OnMapStart(mark, "?", NullAnchor, EmitterStyle::Block);
+    builder.OnMapEnd();
+  } else {
+    builder.OnSequenceStart(mark, "?", NullAnchor, EmitterStyle::Block);
+    builder.OnSequenceEnd();
+  }
+
+  // the top level is loaded now, so that its errors are thrown from here
+  detail::node& root = *builder.RootNode();
+  root.set_lazy(
+      std::make_shared<detail::lazy_collection>(std::move(pInput), region));
+  root.size();
+  return builder.Root();
+}
+}  // namespace YAML
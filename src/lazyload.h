@@ -0,0 +1,88 @@
+#ifndef LAZYLOAD_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+#define LAZYLOAD_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+
+#if defined(_MSC_VER) ||                                            \
+    (defined(__GNUC__) && (__GNUC__ == 3 && __GNUC_MINOR__ >= 4) || \
+     (__GNUC__ >= 4))  // GCC supports "pragma once" correctly since 3.4
+#pragma once
+#endif
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "yaml-cpp/node/ptr.h"
+#include "yaml-cpp/node/type.h"
+
+namespace YAML {
+class Node;
+
+namespace detail {
+class node;
+class node_data;
+
+// lazy_region
+// . Where a block collection is in the input: from 'begin' (on 'line', at
+//   'column', which is 0 unless the collection starts mid-line, after a
+//   "- ") to 'end', with its entries at 'indent'.
+struct lazy_region {
+  std::size_t begin;
+  std::size_t end;
+  std::size_t line;
+  std::size_t column;
+  std::size_t indent;
+  NodeType::value type;
+};
+
+// lazy_collection
+// . A block collection that's only parsed when something first looks inside
+//   it; until then, all it has is the input, and where it is in it.
+// . It's parsed once, however many threads look at once: the first parses
+//   it while the others wait, and after that, loaded() is all they check.
+class lazy_collection {
+ public:
+  using adder = std::function<void(std::vector<node*>&)>;
+
+  lazy_collection(std::shared_ptr<const std::string> pInput,
+                  const lazy_region& region);
+  lazy_collection(const lazy_collection&) = delete;
+  lazy_collection& operator=(const lazy_collection&) = delete;
+
+  bool loaded() const { return m_loaded.load(std::memory_order_acquire); }
+
+  // Parses the collection into new nodes (which it keeps), and passes them
+  // to 'add' (for a map, each key and then its value), unless it's already
+  // loaded; the big collections among them are lazy themselves.
+  // . If it throws, nothing has changed, and it throws again next time.
+  void load(const adder& add);
+
+ private:
+  std::mutex m_mutex;
+  std::atomic<bool> m_loaded;
+  std::shared_ptr<const std::string> m_pInput;
+  lazy_region m_region;
+  shared_memory_holder m_pMemory;
+};
+
+// The lazy collections of the nodes that have them, which node_data keeps
+// apart from itself (so that it's no bigger for the nodes that don't);
+// they're safe to call from any thread.
+// . A collection that's replaced or taken is let go of outside the table's
+//   lock, since it may hold the last of the nodes it loaded, whose own ones
+//   it then takes; take_lazy_collection returns it for the caller to.
+void set_lazy_collection(const node_data& data,
+                         shared_lazy_collection pLazy);
+shared_lazy_collection lazy_collection_of(const node_data& data);
+shared_lazy_collection take_lazy_collection(const node_data& data);
+}  // namespace detail
+
+// Loads 'input' like Load, but with its big block collections lazy; or, if
+// it can't be skimmed for where they are, just like Load.
+Node LoadLazily(std::shared_ptr<const std::string> pInput);
+}  // namespace YAML
+
+#endif  // LAZYLOAD_H_62B23520_7C8E_11DE_8A39_0800200C9A66
@@ -0,0 +1,77 @@
+#include "yaml-cpp/node/load_files.h"
+
+#include <fstream>
+
+#include "inflight.h"
+#include "memorybuf.h"
+#include "parallel.h"
+#include "readfile.h"
+#include "snapshotcache.h"
+#include "yaml-cpp/exceptions.h"
+#include "yaml-cpp/node/impl.h"
+#include "yaml-cpp/node/parse.h"
+
+namespace YAML {
+namespace {
+// LoadOne
+// . Loads the file like LoadFile, but reads it whole (with one read, once
+//   there's room for it) and parses it from memory.
+Node LoadOne(const std::string& filename, const std::string& cacheDirectory,
+             InFlight& inFlight) {
+  std::ifstream fin(filename);
+  if (!fin) {
+    throw BadFile(filename);
+  }
+
+  fin.seekg(0, std::ios::end);
+  const std::streamoff end = fin.tellg();
+  fin.seekg(0);
+  if (!fin || end < 0) {
+    // (it can't be sized, e.g. a pipe; so it's read a chunk at a time, with
+    // room for each)
+    fin.clear();
+    GrowingReservation reservation(inFlight);
+    const std::size_t kChunkSize = 1 << 20;
+    std::string input;
+    while (fin) {
+      const std::size_t pos = input.size();
+      reservation.Grow(kChunkSize);
+      input.resize(pos + kChunkSize);
+      fin.read(&input[pos], static_cast<std::streamsize>(kChunkSize));
+      input.resize(pos + static_cast<std::size_t>(fin.gcount()));
+    }
+    if (fin.bad()) {
+      throw BadFile(filename);
+    }
+    return cacheDirectory.empty() ? Load(input)
+                                  : LoadCached(input, cacheDirectory);
+  }
+
+  const std::size_t size = static_cast<std::size_t>(end);
+  Reservation reservation(inFlight, size);
+  const std::string input = ReadSized(fin, size, filename);
+
+  if (!cacheDirectory.empty()) {
+    return LoadCached(input, cacheDirectory);
+  }
+  MemoryBuf buffer(input.data(), input.size());
+  std::istream stream(&buffer);
+  return Load(stream);
+}
+}  // namespace
+
+std::vector<LoadedFile> LoadFiles(const std::vector<std::string>& filenames,
+                                  const LoadFilesOptions& options) {
+  std::vector<LoadedFile> files(filenames.size());
+  const std::string cacheDirectory = SnapshotCacheDirectory();
+  InFlight inFlight(options.maxBytesInFlight);
+  ParallelFor(filenames.size(), options.numThreads, [&](std::size_t i) {
+    try {
+      files[i].document.reset(LoadOne(filenames[i], cacheDirectory, inFlight));
+    } catch (...) {
+      files[i].error = std::current_exception();
+    }
+  });
+  return files;
+}
+}  // namespace YAML
@@ -0,0 +1,26 @@
+#ifndef MEMORYBUF_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+#define MEMORYBUF_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+
+#if defined(_MSC_VER) ||                                            \
+    (defined(__GNUC__) && (__GNUC__ == 3 && __GNUC_MINOR__ >= 4) || \
+     (__GNUC__ >= 4))  // GCC supports "pragma once" correctly since 3.4
+#pragma once
+#endif
+
+#include <cstddef>
+#include <streambuf>
+
+namespace YAML {
+// MemoryBuf
+// . A read-only stream buffer over memory owned by someone else, so that it
+//   can be parsed without copying it into a std::stringstream.
+class MemoryBuf : public std::streambuf {
+ public:
+  MemoryBuf(const char* data, std::size_t size) {
+    char* begin = const_cast<char*>(data);
+    setg(begin, begin, begin + size);
+  }
+};
+}  // namespace YAML
+
+#endif  // MEMORYBUF_H_62B23520_7C8E_11DE_8A39_0800200C9A66
@@ -2,7 +2,9 @@
 #include <cassert>
 #include <iterator>
 #include <sstream>
+#include <utility>
 
+#include "lazyload.h"
 #include "yaml-cpp/exceptions.h"
 #include "yaml-cpp/node/detail/memory.h"
 #include "yaml-cpp/node/detail/node.h"  // IWYU pragma: keep
@@ -15,14 +17,34 @@ namespace YAML {
 namespace detail {
 std::atomic<size_t> node::m_amount{0};
 
+size_t node::next_index() {
+  static const size_t kBlock = 1024;
+  static thread_local size_t next = 0;
+  static thread_local size_t end = 0;
+  if (next == end) {
+    next = m_amount.fetch_add(kBlock);
+    end = next + kBlock;
+  }
+  return next++;
+}
+
 const std::string& node_data::empty_scalar() {
   static const std::string svalue;
   return svalue;
 }
 
+const Mark& node_data::no_mark() {
+  static const Mark mark = Mark::null_mark();
+  return mark;
+}
+
 node_data::node_data()
     : m_isDefined(false),
+      m_hasLazy(false),
+      m_isLazy(false),
+#ifndef YAML_CPP_NO_NODE_MARKS
       m_mark(Mark::null_mark()),
+#endif
       m_type(NodeType::Null),
       m_tag{},
       m_style(EmitterStyle::Default),
@@ -32,18 +54,28 @@ node_data::node_data()
       m_map{},
       m_undefinedPairs{} {}
 
+node_data::~node_data() {
+  if (m_hasLazy)
+    take_lazy_collection(*this);
+}
+
 void node_data::mark_defined() {
   if (m_type == NodeType::Undefined)
     m_type = NodeType::Null;
   m_isDefined = true;
 }
 
+#ifndef YAML_CPP_NO_NODE_MARKS
 void node_data::set_mark(const Mark& mark) { m_mark = mark; }
+#else
+void node_data::set_mark(const Mark& /* mark */) {}
+#endif
 
 void node_data::set_type(NodeType::value type) {
   if (type == NodeType::Undefined) {
     m_type = type;
     m_isDefined = false;
+    drop_lazy();
     return;
   }
 
@@ -52,6 +84,7 @@ void node_data::set_type(NodeType::value type) {
     return;
 
   m_type = type;
+  drop_lazy();
 
   switch (m_type) {
     case NodeType::Null:
@@ -73,23 +106,73 @@ void node_data::set_type(NodeType::value type) {
 
 void node_data::set_tag(const std::string& tag) { m_tag = tag; }
 
+void node_data::set_tag(std::string&& tag) { m_tag = std::move(tag); }
+
 void node_data::set_style(EmitterStyle::value style) { m_style = style; }
 
+void node_data::set_lazy(const shared_lazy_collection& pLazy) {
+  set_lazy_collection(*this, pLazy);
+  m_hasLazy = true;
+  m_isLazy.store(true, std::memory_order_release);
+}
+
+// The lazy collection is only marked loaded once it has parsed, so if it
+// throws, it throws the same error again the next time it's touched.
+// (This writes to the node from its const accessors, but only once, under
+// the collection's lock; the sizes are filled in too, so that readers
+// after that don't write to it either.)
+void node_data::load_lazy() const {
+  const shared_lazy_collection pLazy = lazy_collection_of(*this);
+  node_data& data = const_cast<node_data&>(*this);
+  pLazy->load([&data](std::vector<node*>& children) {
+    if (data.m_type == NodeType::Sequence) {
+      data.m_sequence = std::move(children);
+      data.compute_seq_size();
+    } else {
+      for (std::size_t i = 0; i + 1 < children.size(); i += 2)
+        data.insert_map_pair(*children[i], *children[i + 1]);
+      data.compute_map_size();
+    }
+  });
+  m_isLazy.store(false, std::memory_order_release);
+}
+
+// Drops a lazy collection that hasn't been parsed, for when its node is set
+// to something else; one that has keeps its nodes, which may still be used.
+void node_data::drop_lazy() {
+  if (m_isLazy.load(std::memory_order_relaxed) &&
+      !lazy_collection_of(*this)->loaded()) {
+    take_lazy_collection(*this);
+    m_hasLazy = false;
+    m_isLazy.store(false, std::memory_order_relaxed);
+  }
+}
+
 void node_data::set_null() {
   m_isDefined = true;
+  drop_lazy();
   m_type = NodeType::Null;
 }
 
 void node_data::set_scalar(const std::string& scalar) {
   m_isDefined = true;
+  drop_lazy();
   m_type = NodeType::Scalar;
   m_scalar = scalar;
 }
 
+void node_data::set_scalar(std::string&& scalar) {
+  m_isDefined = true;
+  drop_lazy();
+  m_type = NodeType::Scalar;
+  m_scalar = std::move(scalar);
+}
+
 // size/iterator
 std::size_t node_data::size() const {
   if (!m_isDefined)
     return 0;
+  load();
 
   switch (m_type) {
     case NodeType::Sequence:
@@ -122,6 +205,7 @@ void node_data::compute_map_size() const {
 const_node_iterator node_data::begin() const {
   if (!m_isDefined)
     return {};
+  load();
 
   switch (m_type) {
     case NodeType::Sequence:
@@ -136,6 +220,7 @@ const_node_iterator node_data::begin() const {
 node_iterator node_data::begin() {
   if (!m_isDefined)
     return {};
+  load();
 
   switch (m_type) {
     case NodeType::Sequence:
@@ -150,6 +235,7 @@ node_iterator node_data::begin() {
 const_node_iterator node_data::end() const {
   if (!m_isDefined)
     return {};
+  load();
 
   switch (m_type) {
     case NodeType::Sequence:
@@ -164,6 +250,7 @@ const_node_iterator node_data::end() const {
 node_iterator node_data::end() {
   if (!m_isDefined)
     return {};
+  load();
 
   switch (m_type) {
     case NodeType::Sequence:
@@ -178,6 +265,7 @@ node_iterator node_data::end() {
 // sequence
 void node_data::push_back(node& node,
                           const shared_memory_holder& /* pMemory */) {
+  load();
   if (m_type == NodeType::Undefined || m_type == NodeType::Null) {
     m_type = NodeType::Sequence;
     reset_sequence();
@@ -186,11 +274,16 @@ void node_data::push_back(node& node,
   if (m_type != NodeType::Sequence)
     throw BadPushback();
 
+  // (kept up to date here, so that size() doesn't write to a sequence that
+  // was built whole, as a loaded one is, and threads can read it at once)
+  if (m_seqSize == m_sequence.size() && node.is_defined())
+    m_seqSize++;
   m_sequence.push_back(&node);
 }
 
 void node_data::insert(node& key, node& value,
                        const shared_memory_holder& pMemory) {
+  load();
   switch (m_type) {
     case NodeType::Map:
       break;
@@ -200,7 +293,7 @@ void node_data::insert(node& key, node& value,
       convert_to_map(pMemory);
       break;
     case NodeType::Scalar:
-      throw BadSubscript(m_mark, key);
+      throw BadSubscript(mark(), key);
   }
 
   insert_map_pair(key, value);
@@ -209,6 +302,7 @@ void node_data::insert(node& key, node& value,
 // indexing
 node* node_data::get(node& key,
                      const shared_memory_holder& /* pMemory */) const {
+  load();
   if (m_type != NodeType::Map) {
     return nullptr;
   }
@@ -222,6 +316,7 @@ node* node_data::get(node& key,
 }
 
 node& node_data::get(node& key, const shared_memory_holder& pMemory) {
+  load();
   switch (m_type) {
     case NodeType::Map:
       break;
@@ -231,7 +326,7 @@ node& node_data::get(node& key, const shared_memory_holder& pMemory) {
       convert_to_map(pMemory);
       break;
     case NodeType::Scalar:
-      throw BadSubscript(m_mark, key);
+      throw BadSubscript(mark(), key);
   }
 
   for (const auto& it : m_map) {
@@ -245,6 +340,7 @@ node& node_data::get(node& key, const shared_memory_holder& pMemory) {
 }
 
 bool node_data::remove(node& key, const shared_memory_holder& /* pMemory */) {
+  load();
   if (m_type != NodeType::Map)
     return false;
 
@@ -1,4 +1,5 @@
 #include <cassert>
+#include <utility>
 
 #include "nodebuilder.h"
 #include "yaml-cpp/node/detail/node.h"
@@ -52,6 +53,14 @@ void NodeBuilder::OnScalar(const Mark& mark, const std::string& tag,
   Pop();
 }
 
+void NodeBuilder::OnOwnedScalar(const Mark& mark, std::string&& tag,
+                                anchor_t anchor, std::string&& value) {
+  detail::node& node = Push(mark, anchor);
+  node.set_scalar(std::move(value));
+  node.set_tag(std::move(tag));
+  Pop();
+}
+
 void NodeBuilder::OnSequenceStart(const Mark& mark, const std::string& tag,
                                   anchor_t anchor, EmitterStyle::value style) {
   detail::node& node = Push(mark, anchor);
@@ -24,7 +24,7 @@ struct Mark;
 namespace YAML {
 class Node;
 
-class NodeBuilder : public EventHandler {
+class NodeBuilder final : public EventHandler {
  public:
   NodeBuilder();
   NodeBuilder(const NodeBuilder&) = delete;
@@ -35,6 +35,11 @@ class NodeBuilder : public EventHandler {
 
   Node Root();
 
+  // The root and the memory that holds the nodes, for building on them
+  // directly (e.g., the lazy loader adds them to a collection it loads).
+  detail::node* RootNode() const { return m_pRoot; }
+  const detail::shared_memory_holder& Memory() const { return m_pMemory; }
+
   void OnDocumentStart(const Mark& mark) override;
   void OnDocumentEnd() override;
 
@@ -42,6 +47,8 @@ class NodeBuilder : public EventHandler {
   void OnAlias(const Mark& mark, anchor_t anchor) override;
   void OnScalar(const Mark& mark, const std::string& tag,
                         anchor_t anchor, const std::string& value) override;
+  void OnOwnedScalar(const Mark& mark, std::string&& tag, anchor_t anchor,
+                     std::string&& value) override;
 
   void OnSequenceStart(const Mark& mark, const std::string& tag,
                                anchor_t anchor, EmitterStyle::value style) override;
@@ -24,16 +24,7 @@ ostream_wrapper::ostream_wrapper(std::ostream& stream)
 ostream_wrapper::~ostream_wrapper() = default;
 
 void ostream_wrapper::write(const std::string& str) {
-  if (m_pStream) {
-    m_pStream->write(str.c_str(), str.size());
-  } else {
-    m_buffer.resize(std::max(m_buffer.size(), m_pos + str.size() + 1));
-    std::copy(str.begin(), str.end(), m_buffer.begin() + m_pos);
-  }
-
-  for (char ch : str) {
-    update_pos(ch);
-  }
+  write(str.data(), str.size());
 }
 
 void ostream_wrapper::write(const char* str, std::size_t size) {
@@ -44,19 +35,23 @@ void ostream_wrapper::write(const char* str, std::size_t size) {
     std::copy(str, str + size, m_buffer.begin() + m_pos);
   }
 
-  for (std::size_t i = 0; i < size; i++) {
-    update_pos(str[i]);
-  }
-}
-
-void ostream_wrapper::update_pos(char ch) {
-  m_pos++;
-  m_col++;
-
-  if (ch == '\n') {
+  // only the last line of what we wrote matters for the column
+  const char* const last = str + size;
+  const char* lineStart = str;
+  while (lineStart != last) {
+    const std::size_t remaining = static_cast<std::size_t>(last - lineStart);
+    const char* newline =
+        static_cast<const char*>(std::memchr(lineStart, '\n', remaining));
+    if (!newline) {
+      break;
+    }
     m_row++;
-    m_col = 0;
     m_comment = false;
+    lineStart = newline + 1;
   }
+
+  m_pos += size;
+  m_col = (lineStart == str ? m_col : 0) +
+          static_cast<std::size_t>(last - lineStart);
 }
 }  // namespace YAML
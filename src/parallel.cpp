@@ -0,0 +1,35 @@
+#include "parallel.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace YAML {
+unsigned ThreadCount(unsigned numThreads) {
+  if (numThreads > 0)
+    return numThreads;
+  const unsigned cores = std::thread::hardware_concurrency();
+  return cores > 0 ? cores : 1;
+}
+
+void ParallelFor(std::size_t count, unsigned numThreads,
+                 const std::function<void(std::size_t)>& fn) {
+  std::atomic<std::size_t> next(0);
+  auto work = [&]() {
+    for (std::size_t i = next++; i < count; i = next++)
+      fn(i);
+  };
+
+  std::size_t numWorkers = ThreadCount(numThreads);
+  if (numWorkers > count)
+    numWorkers = count;
+
+  std::vector<std::thread> workers;
+  workers.reserve(numWorkers > 0 ? numWorkers - 1 : 0);
+  for (std::size_t i = 1; i < numWorkers; i++)
+    workers.emplace_back(work);
+  work();
+  for (std::thread& worker : workers)
+    worker.join();
+}
+}  // namespace YAML
@@ -0,0 +1,26 @@
+#ifndef PARALLEL_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+#define PARALLEL_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+
+#if defined(_MSC_VER) ||                                            \
+    (defined(__GNUC__) && (__GNUC__ == 3 && __GNUC_MINOR__ >= 4) || \
+     (__GNUC__ >= 4))  // GCC supports "pragma once" correctly since 3.4
+#pragma once
+#endif
+
+#include <cstddef>
+#include <functional>
+
+namespace YAML {
+// The number of threads to use when asked for 'numThreads' (0 means one per
+// core).
+unsigned ThreadCount(unsigned numThreads);
+
+// ParallelFor
+// . Calls 'fn' once for each index in [0, count), on up to 'numThreads'
+//   threads (including the calling one), and returns once every call has.
+// . 'fn' must not throw.
+void ParallelFor(std::size_t count, unsigned numThreads,
+                 const std::function<void(std::size_t)>& fn);
+}  // namespace YAML
+
+#endif  // PARALLEL_H_62B23520_7C8E_11DE_8A39_0800200C9A66
@@ -1,11 +1,21 @@
 #include "yaml-cpp/node/parse.h"
 
+#include <atomic>
 #include <fstream>
+#include <iterator>
 #include <sstream>
 
+#include "docindex.h"
+#include "lazyload.h"
+#include "memorybuf.h"
 #include "nodebuilder.h"
+#include "parallel.h"
+#include "pathprojector.h"
+#include "snapshotcache.h"
+#include "yaml-cpp/mark.h"
 #include "yaml-cpp/node/impl.h"
 #include "yaml-cpp/node/node.h"
+#include "yaml-cpp/node/path.h"
 #include "yaml-cpp/parser.h"
 
 namespace YAML {
@@ -34,7 +44,45 @@ Node LoadFile(const std::string& filename) {
   if (!fin) {
     throw BadFile(filename);
   }
-  return Load(fin);
+
+  const std::string directory = SnapshotCacheDirectory();
+  if (directory.empty()) {
+    return Load(fin);
+  }
+  const std::string input((std::istreambuf_iterator<char>(fin)),
+                          std::istreambuf_iterator<char>());
+  return LoadCached(input, directory);
+}
+
+Node LoadLazy(const std::string& input) {
+  return LoadLazily(std::make_shared<const std::string>(input));
+}
+
+Node LoadFileLazy(const std::string& filename) {
+  std::ifstream fin(filename);
+  if (!fin) {
+    throw BadFile(filename);
+  }
+  return LoadLazily(std::make_shared<const std::string>(
+      (std::istreambuf_iterator<char>(fin)), std::istreambuf_iterator<char>()));
+}
+
+Node LoadProjected(const std::string& input, const std::vector<Path>& paths) {
+  return PathProjector::Project(
+      LoadLazily(std::make_shared<const std::string>(input)), paths);
+}
+
+Node LoadFileProjected(const std::string& filename,
+                       const std::vector<Path>& paths) {
+  std::ifstream fin(filename);
+  if (!fin) {
+    throw BadFile(filename);
+  }
+  return PathProjector::Project(
+      LoadLazily(std::make_shared<const std::string>(
+          (std::istreambuf_iterator<char>(fin)),
+          std::istreambuf_iterator<char>())),
+      paths);
 }
 
 std::vector<Node> LoadAll(const std::string& input) {
@@ -47,10 +95,8 @@ std::vector<Node> LoadAll(const char* input) {
   return LoadAll(stream);
 }
 
-std::vector<Node> LoadAll(std::istream& input) {
-  std::vector<Node> docs;
-
-  Parser parser(input);
+namespace {
+void LoadDocuments(Parser& parser, std::vector<Node>& docs) {
   while (true) {
     NodeBuilder builder;
     if (!parser.HandleNextDocument(builder)) {
@@ -58,6 +104,52 @@ std::vector<Node> LoadAll(std::istream& input) {
     }
     docs.push_back(builder.Root());
   }
+}
+
+// LoadAllFrom
+// . Loads the documents of 'input' (which has 'size' bytes) from 'start'
+//   until 'end', with the marks they'd have in the whole stream.
+std::vector<Node> LoadAllFrom(const char* input, std::size_t size,
+                              const DocumentStart& start, std::size_t end) {
+  const std::size_t bom = Utf8ByteOrderMarkSize(input, size);
+  const char* data = input + bom + start.pos;
+  std::size_t dataSize = end - start.pos;
+  Mark mark;
+  mark.pos = static_cast<int>(start.pos);
+  mark.line = static_cast<int>(start.line);
+
+  std::string text;
+  if (start.pos == 0) {
+    // the byte order mark is skipped (and not counted) by the stream
+    data = input;
+    dataSize += bom;
+  } else if (start.directivesSize > 0) {
+    // the directives come first, as if they'd been right before the cut
+    text.reserve(start.directivesSize + dataSize);
+    text.append(input + bom + start.directivesPos, start.directivesSize);
+    text.append(data, dataSize);
+    data = text.data();
+    dataSize = text.size();
+    mark.pos -= static_cast<int>(start.directivesSize);
+    mark.line -= static_cast<int>(start.directivesLines);
+  }
+
+  MemoryBuf buffer(data, dataSize);
+  std::istream stream(&buffer);
+  Parser parser;
+  parser.Load(stream, mark);
+
+  std::vector<Node> docs;
+  LoadDocuments(parser, docs);
+  return docs;
+}
+}  // namespace
+
+std::vector<Node> LoadAll(std::istream& input) {
+  std::vector<Node> docs;
+
+  Parser parser(input);
+  LoadDocuments(parser, docs);
 
   return docs;
 }
@@ -69,4 +161,81 @@ std::vector<Node> LoadAllFromFile(const std::string& filename) {
   }
   return LoadAll(fin);
 }
+
+// LoadAllParallel
+// . The stream is cut into batches of documents, each of which is parsed on
+//   its own (see ScanDocumentStarts for where it can be cut); there are a few
+//   batches per thread so that uneven documents still balance out.
+// . If any batch fails, the whole stream is parsed again in one piece. The
+//   cut may not have been a real document boundary, and even if it was, the
+//   scanner reads ahead (sometimes across documents), so which error LoadAll
+//   reports first isn't something the batches can tell.
+std::vector<Node> LoadAllParallel(const std::string& input,
+                                  unsigned numThreads) {
+  const unsigned threads = ThreadCount(numThreads);
+  std::vector<DocumentStart> starts;
+  if (threads == 1 ||
+      !ScanDocumentStarts(input.data(), input.size(), starts) ||
+      starts.size() == 1) {
+    return LoadAll(input);
+  }
+
+  const std::size_t size =
+      input.size() - Utf8ByteOrderMarkSize(input.data(), input.size());
+  const std::size_t batchSize = size / (threads * 4) + 1;
+  std::vector<std::size_t> batches(1, 0);
+  for (std::size_t i = 1; i < starts.size(); i++) {
+    if (starts[i].pos - starts[batches.back()].pos >= batchSize) {
+      batches.push_back(i);
+    }
+  }
+  if (batches.size() == 1) {
+    return LoadAll(input);
+  }
+
+  std::vector<std::vector<Node>> results(batches.size());
+  std::atomic<bool> failed(false);
+  ParallelFor(batches.size(), threads, [&](std::size_t batch) {
+    if (failed) {
+      return;
+    }
+    const std::size_t end =
+        batch + 1 < batches.size() ? starts[batches[batch + 1]].pos : size;
+    try {
+      results[batch] =
+          LoadAllFrom(input.data(), input.size(), starts[batches[batch]], end);
+    } catch (...) {
+      failed = true;
+    }
+  });
+  if (failed) {
+    return LoadAll(input);
+  }
+
+  std::size_t count = 0;
+  for (const std::vector<Node>& batch : results) {
+    count += batch.size();
+  }
+  std::vector<Node> docs;
+  docs.reserve(count);
+  for (const std::vector<Node>& batch : results) {
+    docs.insert(docs.end(), batch.begin(), batch.end());
+  }
+  return docs;
+}
+
+std::vector<Node> LoadAllParallel(std::istream& input, unsigned numThreads) {
+  const std::string text((std::istreambuf_iterator<char>(input)),
+                         std::istreambuf_iterator<char>());
+  return LoadAllParallel(text, numThreads);
+}
+
+std::vector<Node> LoadAllFromFileParallel(const std::string& filename,
+                                          unsigned numThreads) {
+  std::ifstream fin(filename);
+  if (!fin) {
+    throw BadFile(filename);
+  }
+  return LoadAllParallel(fin, numThreads);
+}
 }  // namespace YAML
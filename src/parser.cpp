@@ -2,15 +2,17 @@
 #include <sstream>
 
 #include "directives.h"  // IWYU pragma: keep
-#include "scanner.h"     // IWYU pragma: keep
+#include "nodebuilder.h"
+#include "scanner.h"  // IWYU pragma: keep
 #include "singledocparser.h"
+#include "tapebuilder.h"
 #include "token.h"
+#include "yaml-cpp/eventhandler.h"
 #include "yaml-cpp/exceptions.h"  // IWYU pragma: keep
+#include "yaml-cpp/nulleventhandler.h"
 #include "yaml-cpp/parser.h"
 
 namespace YAML {
-class EventHandler;
-
 Parser::Parser() : m_pScanner{}, m_pDirectives{} {}
 
 Parser::Parser(std::istream& in) : Parser() { Load(in); }
@@ -19,25 +21,44 @@ Parser::~Parser() = default;
 
 Parser::operator bool() const { return m_pScanner && !m_pScanner->empty(); }
 
-void Parser::Load(std::istream& in) {
-  m_pScanner.reset(new Scanner(in));
+void Parser::Load(std::istream& in) { Load(in, Mark()); }
+
+void Parser::Load(std::istream& in, const Mark& start) {
+  m_pScanner.reset(new Scanner(in, start));
   m_pDirectives.reset(new Directives);
 }
 
 bool Parser::HandleNextDocument(EventHandler& eventHandler) {
+  return HandleDocument(eventHandler);
+}
+
+template <typename Handler>
+bool Parser::HandleDocument(Handler& handler) {
   if (!m_pScanner)
     return false;
 
+  m_pScanner->SetBlockScalarChunkSize(handler.ScalarChunkSize());
   ParseDirectives();
   if (m_pScanner->empty()) {
     return false;
   }
 
   SingleDocParser sdp(*m_pScanner, *m_pDirectives);
-  sdp.HandleDocument(eventHandler);
+  sdp.HandleDocument(handler);
   return true;
 }
 
+template <typename Handler,
+          typename std::enable_if<IsDirectEventHandler<Handler>::value,
+                                  int>::type>
+bool Parser::HandleNextDocument(Handler& handler) {
+  return HandleDocument(handler);
+}
+
+template bool Parser::HandleNextDocument(NodeBuilder& builder);
+template bool Parser::HandleNextDocument(TapeBuilder& builder);
+template bool Parser::HandleNextDocument(NullEventHandler& handler);
+
 void Parser::ParseDirectives() {
   bool readDirective = false;
 
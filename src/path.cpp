@@ -0,0 +1,514 @@
+#include "yaml-cpp/node/path.h"
+
+#include <cstdlib>
+#include <unordered_set>
+
+#include "pathprojector.h"
+#include "yaml-cpp/exceptions.h"
+#include "yaml-cpp/node/convert.h"
+#include "yaml-cpp/node/detail/impl.h"
+#include "yaml-cpp/node/detail/memory.h"
+#include "yaml-cpp/node/detail/node.h"
+#include "yaml-cpp/node/impl.h"
+#include "yaml-cpp/node/node.h"
+#include "yaml-cpp/node/type.h"
+
+namespace YAML {
+namespace detail {
+// path_step
+// . One step of a compiled path. A filter's own path is the 'size' steps
+//   right after it.
+struct path_step {
+  enum Type { Key, Index, Wildcard, Descendants, Filter };
+  enum Test { Exists, Equal, NotEqual };
+
+  explicit path_step(Type type_)
+      : type(type_), text{}, index(0), size(0), test(Exists) {}
+
+  Type type;
+  std::string text;  // the key, or the value a filter compares with
+  long index;
+  std::size_t size;
+  Test test;
+};
+
+struct path_data {
+  path_data() : expression{}, steps{} {}
+
+  std::string expression;
+  std::vector<path_step> steps;
+};
+}  // namespace detail
+
+namespace {
+using detail::path_step;
+
+// PathCompiler
+// . Compiles an expression into steps, with a little recursive descent
+//   parser (a filter's path is compiled like any other, up to its test).
+class PathCompiler {
+ public:
+  PathCompiler(const std::string& expression, std::vector<path_step>& steps)
+      : m_expression(expression), m_pos(0), m_steps(steps) {}
+
+  void Compile() {
+    if (Peek() == '$')
+      m_pos++;
+    if (IsKeyStart(Peek()))
+      Add(path_step::Key).text = ReadKey();
+    CompileSteps();
+    if (!AtEnd())
+      Fail("unexpected '" + std::string(1, Peek()) + "'");
+  }
+
+ private:
+  path_step& Add(path_step::Type type) {
+    m_steps.push_back(path_step(type));
+    return m_steps.back();
+  }
+
+  char Peek() const { return AtEnd() ? '\0' : m_expression[m_pos]; }
+  bool AtEnd() const { return m_pos == m_expression.size(); }
+
+  static bool IsKeyStart(char ch) { return IsKeyChar(ch) && ch != '*'; }
+  static bool IsKeyChar(char ch) {
+    switch (ch) {
+      case '\0':
+      case '.':
+      case '[':
+      case ']':
+      case '(':
+      case ')':
+      case '=':
+      case '!':
+      case '\'':
+      case '"':
+      case ' ':
+      case '\t':
+        return false;
+      default:
+        return true;
+    }
+  }
+
+  void Fail(const std::string& reason) const {
+    throw BadPath(reason + " at " + std::to_string(m_pos + 1) + " in \"" +
+                  m_expression + "\"");
+  }
+
+  void Expect(char ch) {
+    if (Peek() != ch)
+      Fail("expected '" + std::string(1, ch) + "'");
+    m_pos++;
+  }
+
+  void SkipSpaces() {
+    while (Peek() == ' ' || Peek() == '\t')
+      m_pos++;
+  }
+
+  std::string ReadKey() {
+    const std::size_t begin = m_pos;
+    while (IsKeyChar(Peek()))
+      m_pos++;
+    return m_expression.substr(begin, m_pos - begin);
+  }
+
+  std::string ReadQuoted() {
+    const char quote = Peek();
+    m_pos++;
+    std::string text;
+    while (Peek() != quote) {
+      if (AtEnd())
+        Fail("unterminated string");
+      if (Peek() == '\\' && m_pos + 1 < m_expression.size())
+        m_pos++;
+      text += m_expression[m_pos++];
+    }
+    m_pos++;
+    return text;
+  }
+
+  // Compiles steps until there are no more, which is at the end, or at
+  // anything that can't start a step (e.g., a filter's test).
+  void CompileSteps() {
+    while (true) {
+      if (Peek() == '.') {
+        m_pos++;
+        if (Peek() == '.') {
+          m_pos++;
+          Add(path_step::Descendants);
+          if (Peek() == '[') {
+            CompileBracket();
+            continue;
+          }
+        }
+        if (Peek() == '*') {
+          m_pos++;
+          Add(path_step::Wildcard);
+        } else if (IsKeyStart(Peek())) {
+          Add(path_step::Key).text = ReadKey();
+        } else {
+          Fail("expected a key");
+        }
+      } else if (Peek() == '[') {
+        CompileBracket();
+      } else {
+        return;
+      }
+    }
+  }
+
+  void CompileBracket() {
+    Expect('[');
+    const char ch = Peek();
+    if (ch == '*') {
+      m_pos++;
+      Add(path_step::Wildcard);
+    } else if (ch == '\'' || ch == '"') {
+      Add(path_step::Key).text = ReadQuoted();
+    } else if (ch == '?') {
+      m_pos++;
+      CompileFilter();
+    } else if (ch == '-' || (ch >= '0' && ch <= '9')) {
+      const char* begin = m_expression.c_str() + m_pos;
+      char* end = nullptr;
+      const long index = std::strtol(begin, &end, 10);
+      if (end == begin + (ch == '-' ? 1 : 0))
+        Fail("expected an index");
+      m_pos += static_cast<std::size_t>(end - begin);
+      Add(path_step::Index).index = index;
+    } else {
+      Fail("expected an index, a quoted key, '*' or '?'");
+    }
+    Expect(']');
+  }
+
+  void CompileFilter() {
+    Expect('(');
+    SkipSpaces();
+    Expect('@');
+    const std::size_t filter = m_steps.size();
+    Add(path_step::Filter);
+    CompileSteps();
+    m_steps[filter].size = m_steps.size() - filter - 1;
+
+    SkipSpaces();
+    if (Peek() == '=' || Peek() == '!') {
+      m_steps[filter].test =
+          Peek() == '=' ? path_step::Equal : path_step::NotEqual;
+      m_pos++;
+      Expect('=');
+      SkipSpaces();
+      if (Peek() == '\'' || Peek() == '"') {
+        m_steps[filter].text = ReadQuoted();
+      } else {
+        const std::size_t begin = m_pos;
+        while (!AtEnd() && Peek() != ')' && Peek() != ' ' && Peek() != '\t')
+          m_pos++;
+        if (m_pos == begin)
+          Fail("expected a value");
+        m_steps[filter].text = m_expression.substr(begin, m_pos - begin);
+      }
+      SkipSpaces();
+    }
+    Expect(')');
+  }
+
+ private:
+  const std::string& m_expression;
+  std::size_t m_pos;
+  std::vector<path_step>& m_steps;
+};
+
+bool IsScalar(const detail::node& node, const std::string& text) {
+  return node.type() == NodeType::Scalar && node.scalar() == text;
+}
+
+// ForEachChild
+// . Calls 'visit' with each value of a map, or element of a sequence, until
+//   it returns false (and then returns false).
+template <typename Visit>
+bool ForEachChild(const detail::node& node, const Visit& visit) {
+  switch (node.type()) {
+    case NodeType::Sequence:
+      for (const auto& element : node) {
+        if (!visit(*element))
+          return false;
+      }
+      return true;
+    case NodeType::Map:
+      for (const auto& pair : node) {
+        if (!visit(*pair.second))
+          return false;
+      }
+      return true;
+    default:
+      return true;
+  }
+}
+
+// NoTrail
+// . A trail for Walk that doesn't keep anything.
+struct NoTrail {
+  void Push(const detail::node&) {}
+  void Pop() {}
+};
+
+// NodeTrail
+// . A trail for Walk that keeps the nodes on the way to the current one
+//   (not counting the one it started at).
+struct NodeTrail {
+  NodeTrail() : nodes{} {}
+
+  void Push(const detail::node& node) { nodes.push_back(&node); }
+  void Pop() { nodes.pop_back(); }
+
+  std::vector<const detail::node*> nodes;
+};
+
+// Walk
+// . Calls 'visit' with each node that the steps from 'step' to 'end' select
+//   from 'node', in document order, until it returns false (and then returns
+//   false); on the way, 'trail' is told about each node it goes down to.
+template <typename Visit, typename Trail>
+bool Walk(const detail::node& node, const path_step* step,
+          const path_step* end, const Visit& visit, Trail& trail);
+
+// WalkDown
+// . Walks from a child of the current node.
+template <typename Visit, typename Trail>
+bool WalkDown(const detail::node& child, const path_step* step,
+              const path_step* end, const Visit& visit, Trail& trail) {
+  trail.Push(child);
+  const bool more = Walk(child, step, end, visit, trail);
+  trail.Pop();
+  return more;
+}
+
+// Passes
+// . Whether 'node' passes the filter at 'step'.
+bool Passes(const detail::node& node, const path_step* step) {
+  const path_step* begin = step + 1;
+  const path_step* end = begin + step->size;
+  bool matched = false;
+  bool equal = false;
+  NoTrail trail;
+  Walk(node, begin, end,
+       [&](const detail::node& match) {
+         matched = true;
+         equal = IsScalar(match, step->text);
+         return step->test != path_step::Exists && !equal;
+       },
+       trail);
+
+  switch (step->test) {
+    case path_step::Exists:
+      return matched;
+    case path_step::Equal:
+      return equal;
+    case path_step::NotEqual:
+      return matched && !equal;
+  }
+  return false;
+}
+
+template <typename Visit, typename Trail>
+bool Walk(const detail::node& node, const path_step* step,
+          const path_step* end, const Visit& visit, Trail& trail) {
+  if (!node.is_defined())
+    return true;
+  if (step == end)
+    return visit(node);
+
+  const path_step* next = step + 1;
+  switch (step->type) {
+    case path_step::Key:
+      if (node.type() != NodeType::Map)
+        return true;
+      for (const auto& pair : node) {
+        if (IsScalar(*pair.first, step->text))
+          return WalkDown(*pair.second, next, end, visit, trail);
+      }
+      return true;
+    case path_step::Index: {
+      if (node.type() != NodeType::Sequence)
+        return true;
+      long index = step->index;
+      if (index < 0)
+        index += static_cast<long>(node.size());
+      // (the memory is only needed to add an element, which this doesn't)
+      const detail::node* element =
+          index < 0 ? nullptr
+                    : node.get(static_cast<std::size_t>(index),
+                               detail::shared_memory_holder());
+      return element ? WalkDown(*element, next, end, visit, trail) : true;
+    }
+    case path_step::Wildcard:
+      return ForEachChild(node, [&](const detail::node& child) {
+        return WalkDown(child, next, end, visit, trail);
+      });
+    case path_step::Descendants:
+      // the rest of the path from here, and then from each node under here
+      if (!Walk(node, next, end, visit, trail))
+        return false;
+      return ForEachChild(node, [&](const detail::node& child) {
+        return WalkDown(child, step, end, visit, trail);
+      });
+    case path_step::Filter: {
+      const path_step* after = next + step->size;
+      return ForEachChild(node, [&](const detail::node& child) {
+        return !Passes(child, step) ||
+               WalkDown(child, after, end, visit, trail);
+      });
+    }
+  }
+  return true;
+}
+
+// Projection
+// . Copies the maps and sequences on the way to the selected nodes, with
+//   just the entries that lead to one.
+class Projection {
+ public:
+  explicit Projection(const detail::shared_memory_holder& pMemory)
+      : m_pMemory(pMemory), m_selected{}, m_onPath{} {}
+
+  void Select(const detail::node& node, const NodeTrail& trail) {
+    m_selected.insert(&node);
+    m_onPath.insert(trail.nodes.begin(), trail.nodes.end());
+  }
+
+  detail::node& Copy(const detail::node& source) {
+    if (m_selected.count(&source))
+      return const_cast<detail::node&>(source);
+
+    detail::node& copy = m_pMemory->create_node();
+    copy.set_mark(source.mark());
+    switch (source.type()) {
+      case NodeType::Sequence: {
+        // (each element it skips is a null, so that the elements it keeps,
+        // counted from either end, are at the same index)
+        copy.set_type(NodeType::Sequence);
+        for (const auto& element : source) {
+          if (IsKept(*element)) {
+            copy.push_back(Copy(*element), m_pMemory);
+          } else {
+            detail::node& null = m_pMemory->create_node();
+            null.set_null();
+            copy.push_back(null, m_pMemory);
+          }
+        }
+        break;
+      }
+      case NodeType::Map:
+        copy.set_type(NodeType::Map);
+        for (const auto& pair : source) {
+          if (IsKept(*pair.second))
+            copy.insert(const_cast<detail::node&>(*pair.first),
+                        Copy(*pair.second), m_pMemory);
+        }
+        break;
+      default:
+        // (only the root is copied without being on the way to anything,
+        // when nothing is selected)
+        copy.set_null();
+        return copy;
+    }
+    copy.set_tag(source.tag());
+    copy.set_style(source.style());
+    return copy;
+  }
+
+ private:
+  bool IsKept(const detail::node& node) const {
+    return m_selected.count(&node) || m_onPath.count(&node);
+  }
+
+ private:
+  detail::shared_memory_holder m_pMemory;
+  std::unordered_set<const detail::node*> m_selected;
+  std::unordered_set<const detail::node*> m_onPath;
+};
+}  // namespace
+
+Path::Path(const std::string& expression) : m_pData{} {
+  std::shared_ptr<detail::path_data> pData =
+      std::make_shared<detail::path_data>();
+  pData->expression = expression;
+  PathCompiler(pData->expression, pData->steps).Compile();
+  m_pData = std::move(pData);
+}
+
+const std::string& Path::Expression() const { return m_pData->expression; }
+
+std::vector<Node> Path::Select(const Node& root) const {
+  std::vector<Node> matches;
+  Select(root, matches);
+  return matches;
+}
+
+std::size_t Path::Select(const Node& root, std::vector<Node>& matches) const {
+  if (!root.m_isValid)
+    throw InvalidNode(root.m_invalidKey);
+
+  const std::size_t size = matches.size();
+  if (!root.m_pNode) {
+    // (a null node, with nothing under it)
+    if (m_pData->steps.empty())
+      matches.push_back(root);
+    return matches.size() - size;
+  }
+
+  const std::vector<path_step>& steps = m_pData->steps;
+  NoTrail trail;
+  Walk(*root.m_pNode, steps.data(), steps.data() + steps.size(),
+       [&](const detail::node& match) {
+         matches.push_back(
+             Node(const_cast<detail::node&>(match), root.m_pMemory));
+         return true;
+       },
+       trail);
+  return matches.size() - size;
+}
+
+Node Path::SelectFirst(const Node& root) const {
+  if (!root.m_isValid)
+    throw InvalidNode(root.m_invalidKey);
+  if (!root.m_pNode)
+    return m_pData->steps.empty() ? root : Node(Node::ZombieNode, Expression());
+
+  const detail::node* first = nullptr;
+  const std::vector<path_step>& steps = m_pData->steps;
+  NoTrail trail;
+  Walk(*root.m_pNode, steps.data(), steps.data() + steps.size(),
+       [&](const detail::node& match) {
+         first = &match;
+         return false;
+       },
+       trail);
+  if (!first)
+    return Node(Node::ZombieNode, Expression());
+  return Node(const_cast<detail::node&>(*first), root.m_pMemory);
+}
+
+Node PathProjector::Project(const Node& root, const std::vector<Path>& paths) {
+  if (!root.m_isValid)
+    throw InvalidNode(root.m_invalidKey);
+  if (!root.m_pNode)
+    return root;
+
+  Projection projection(root.m_pMemory);
+  NodeTrail trail;
+  for (const Path& path : paths) {
+    const std::vector<path_step>& steps = path.m_pData->steps;
+    Walk(*root.m_pNode, steps.data(), steps.data() + steps.size(),
+         [&](const detail::node& match) {
+           projection.Select(match, trail);
+           return true;
+         },
+         trail);
+  }
+  return Node(projection.Copy(*root.m_pNode), root.m_pMemory);
+}
+}  // namespace YAML
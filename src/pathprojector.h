@@ -0,0 +1,32 @@
+#ifndef PATHPROJECTOR_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+#define PATHPROJECTOR_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+
+#if defined(_MSC_VER) ||                                            \
+    (defined(__GNUC__) && (__GNUC__ == 3 && __GNUC_MINOR__ >= 4) || \
+     (__GNUC__ >= 4))  // GCC supports "pragma once" correctly since 3.4
+#pragma once
+#endif
+
+#include <vector>
+
+namespace YAML {
+class Node;
+class Path;
+
+// PathProjector
+// . Cuts a document down to what some paths select from it (see
+//   LoadProjected).
+class PathProjector {
+ public:
+  // Returns what the paths select from 'root' (each with everything under
+  // it), in the maps and sequences on the way there, which keep just the
+  // entries that lead to something selected; a sequence keeps its elements'
+  // indices and its length, with nulls for those it skips.
+  // . The selected nodes aren't copied, and the maps and sequences are made
+  //   in root's memory, so 'root' should be a document that's only loaded
+  //   for this.
+  static Node Project(const Node& root, const std::vector<Path>& paths);
+};
+}  // namespace YAML
+
+#endif  // PATHPROJECTOR_H_62B23520_7C8E_11DE_8A39_0800200C9A66
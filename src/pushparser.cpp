@@ -0,0 +1,37 @@
+#include "yaml-cpp/pushparser.h"
+
+#include "resumableparser.h"
+
+namespace YAML {
+PushParser::PushParser(EventHandler& handler)
+    : m_handler(handler), m_pParser(new ResumableParser), m_done(false) {}
+
+PushParser::~PushParser() = default;
+
+std::size_t PushParser::feed(const char* data, std::size_t size) {
+  if (m_done)
+    return 0;
+
+  m_pParser->Feed(data, size);
+  return Parse();
+}
+
+std::size_t PushParser::finish() {
+  if (m_done)
+    return 0;
+
+  m_pParser->Finish();
+  const std::size_t documents = Parse();
+  m_done = true;
+  return documents;
+}
+
+std::size_t PushParser::Parse() {
+  try {
+    return m_pParser->Parse(m_handler);
+  } catch (...) {
+    m_done = true;
+    throw;
+  }
+}
+}  // namespace YAML
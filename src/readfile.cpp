@@ -0,0 +1,23 @@
+#include "readfile.h"
+
+#include <istream>
+#include <iterator>
+
+#include "yaml-cpp/exceptions.h"
+
+namespace YAML {
+std::string ReadSized(std::istream& input, std::size_t size,
+                      const std::string& filename) {
+  std::string text(size, '\0');
+  if (size > 0) {
+    input.read(&text[0], static_cast<std::streamsize>(size));
+    if (input.bad()) {
+      throw BadFile(filename);
+    }
+    text.resize(static_cast<std::size_t>(input.gcount()));
+  }
+  text.append(std::istreambuf_iterator<char>(input.rdbuf()),
+              std::istreambuf_iterator<char>());
+  return text;
+}
+}  // namespace YAML
@@ -0,0 +1,26 @@
+#ifndef READFILE_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+#define READFILE_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+
+#if defined(_MSC_VER) ||                                            \
+    (defined(__GNUC__) && (__GNUC__ == 3 && __GNUC_MINOR__ >= 4) || \
+     (__GNUC__ >= 4))  // GCC supports "pragma once" correctly since 3.4
+#pragma once
+#endif
+
+#include <cstddef>
+#include <iosfwd>
+#include <string>
+
+namespace YAML {
+// ReadSized
+// . Reads the rest of 'input', the file 'filename', which has 'size' bytes
+//   as far as the caller knows: with one read, into a string of that size,
+//   and then whatever's after that, if the file has grown since it was
+//   sized. (Text mode can read fewer characters than the file has bytes,
+//   so it can be shorter.)
+// . Throws BadFile if the file can't be read.
+std::string ReadSized(std::istream& input, std::size_t size,
+                      const std::string& filename);
+}  // namespace YAML
+
+#endif  // READFILE_H_62B23520_7C8E_11DE_8A39_0800200C9A66
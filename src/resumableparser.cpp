@@ -0,0 +1,602 @@
+#include "resumableparser.h"
+
+#include <utility>
+
+#include "directives.h"
+#include "scanner.h"
+#include "scanscalar.h"
+#include "stream.h"
+#include "tag.h"
+#include "token.h"
+#include "yaml-cpp/depthguard.h"
+#include "yaml-cpp/emitterstyle.h"
+#include "yaml-cpp/eventhandler.h"
+#include "yaml-cpp/exceptions.h"  // IWYU pragma: keep
+#include "yaml-cpp/null.h"
+
+namespace YAML {
+namespace {
+class ScalarChunkForwarder : public ScalarChunkSink {
+ public:
+  explicit ScalarChunkForwarder(EventHandler& handler) : m_handler(handler) {}
+  void OnChunk(const char* data, std::size_t size) override {
+    m_handler.OnScalarChunk(data, size);
+  }
+
+ private:
+  EventHandler& m_handler;
+};
+
+// ScalarChunkRecorder
+// . Holds the chunks of a block scalar, to hand them on once it's been
+//   scanned whole.
+class ScalarChunkRecorder : public ScalarChunkSink {
+ public:
+  ScalarChunkRecorder() : m_data{}, m_sizes{} {}
+  void OnChunk(const char* data, std::size_t size) override {
+    m_data.append(data, size);
+    m_sizes.push_back(size);
+  }
+
+  void Replay(EventHandler& handler) const {
+    std::size_t offset = 0;
+    for (std::size_t size : m_sizes) {
+      handler.OnScalarChunk(m_data.data() + offset, size);
+      offset += size;
+    }
+  }
+
+ private:
+  std::string m_data;
+  std::vector<std::size_t> m_sizes;
+};
+}  // namespace
+
+ResumableParser::ResumableParser()
+    : m_input{},
+      m_buffer(nullptr, 0),
+      m_stream(&m_buffer),
+      m_complete(false),
+      m_fed(0),
+      m_wanted(0),
+      m_parser{},
+      m_state(NEXT_DOCUMENT),
+      m_readDirective(false),
+      m_documents(0),
+      m_frames{},
+      m_collectionStack{},
+      m_anchors{},
+      m_curAnchor(0),
+      m_tag{},
+      m_anchor(NullAnchor),
+      m_anchorName{} {}
+
+ResumableParser::~ResumableParser() = default;
+
+// Feed
+// . The bytes the stream has read are dropped first (it holds on to what it
+//   needs of them).
+void ResumableParser::Feed(const char* data, std::size_t size) {
+  if (m_parser.m_pScanner) {
+    const std::size_t unread =
+        static_cast<std::size_t>(m_buffer.in_avail());
+    m_input.erase(0, m_input.size() - unread);
+  }
+  m_input.append(data, size);
+  m_fed += size;
+
+  // (this clears the stream's eof, too)
+  m_buffer = MemoryBuf(m_input.data(), m_input.size());
+  m_stream.rdbuf(&m_buffer);
+}
+
+void ResumableParser::Finish() {
+  m_complete = true;
+  if (m_parser.m_pScanner)
+    m_parser.m_pScanner->Complete();
+}
+
+std::size_t ResumableParser::Parse(EventHandler& handler) {
+  m_documents = 0;
+  if (!m_complete && m_fed < m_wanted)
+    return 0;
+  m_fed = 0;
+  m_wanted = 0;
+
+  if (!m_parser.m_pScanner && !Start())
+    return 0;
+
+  try {
+    while (Step(handler)) {
+    }
+  } catch (const NeedMoreInput&) {
+    // this is as far as we can go for now
+    m_wanted = m_parser.m_pScanner->rewound();
+  }
+  return m_documents;
+}
+
+// Start
+// . The stream reads up to four bytes to tell the encoding, so until there
+//   are enough, it starts again from the start of the input each time.
+bool ResumableParser::Start() {
+  if (m_input.empty() && !m_complete)
+    return false;
+
+  m_buffer = MemoryBuf(m_input.data(), m_input.size());
+  m_stream.rdbuf(&m_buffer);
+  try {
+    m_parser.m_pScanner.reset(new Scanner(m_stream, Mark(), !m_complete));
+  } catch (const NeedMoreInput&) {
+    return false;
+  }
+  m_parser.m_pDirectives.reset(new Directives);
+  return true;
+}
+
+bool ResumableParser::Step(EventHandler& handler) {
+  if (m_state != IN_DOCUMENT)
+    return StepBetweenDocuments(handler);
+
+  if (m_frames.empty()) {
+    handler.OnDocumentEnd();
+    m_documents++;
+    m_state = DOCUMENT_ENDS;
+  } else if (m_frames.back().state <= CONTENT) {
+    StepNode(handler);
+  } else {
+    StepCollection(handler);
+  }
+  return true;
+}
+
+// StepBetweenDocuments
+// . As Parser::HandleNextDocument reads the directives and starts a document,
+//   and SingleDocParser::HandleDocument ends it.
+bool ResumableParser::StepBetweenDocuments(EventHandler& handler) {
+  Scanner& scanner = *m_parser.m_pScanner;
+
+  switch (m_state) {
+    case NEXT_DOCUMENT:
+      scanner.SetBlockScalarChunkSize(handler.ScalarChunkSize());
+      m_readDirective = false;
+      m_state = DIRECTIVES;
+      return true;
+    case DIRECTIVES: {
+      if (scanner.empty()) {
+        m_state = END;
+        return false;
+      }
+
+      Token& token = scanner.peek();
+      if (token.type == Token::DIRECTIVE) {
+        // we keep the directives from the last document if none are
+        // specified; but if any directives are specific, then we reset them
+        if (!m_readDirective)
+          m_parser.m_pDirectives.reset(new Directives);
+        m_readDirective = true;
+        m_parser.HandleDirective(token);
+        scanner.pop();
+        return true;
+      }
+
+      handler.OnDocumentStart(token.mark);
+
+      // eat doc start
+      if (token.type == Token::DOC_START)
+        scanner.pop();
+
+      m_anchors.clear();
+      m_curAnchor = 0;
+      m_state = IN_DOCUMENT;
+      PushNode();
+      return true;
+    }
+    case DOCUMENT_ENDS:
+      // eat any doc ends we see
+      if (!scanner.empty() && scanner.peek().type == Token::DOC_END)
+        scanner.pop();
+      else
+        m_state = NEXT_DOCUMENT;
+      return true;
+    default:
+      return false;
+  }
+}
+
+// StepNode
+// . As SingleDocParser::HandleNode starts a node: first any properties (a
+//   token a step), and then its content.
+void ResumableParser::StepNode(EventHandler& handler) {
+  Scanner& scanner = *m_parser.m_pScanner;
+  Frame& frame = m_frames.back();
+
+  switch (frame.state) {
+    case NODE: {
+      // an empty node *is* a possibility
+      if (scanner.empty()) {
+        handler.OnNull(scanner.mark(), NullAnchor);
+        PopNode();
+        return;
+      }
+
+      Token& token = scanner.peek();
+      frame.mark = token.mark;
+
+      // special case: a value node by itself must be a map, with no header
+      if (token.type == Token::VALUE) {
+        handler.OnMapStart(frame.mark, "?", NullAnchor, EmitterStyle::Default);
+        m_collectionStack.PushCollectionType(CollectionType::CompactMap);
+        handler.OnNull(frame.mark, NullAnchor);
+        scanner.pop();
+        frame.state = COMPACT_MAP_END;
+        PushNode();
+        return;
+      }
+
+      // special case: an alias node
+      if (token.type == Token::ALIAS) {
+        handler.OnAlias(frame.mark, LookupAnchor(frame.mark, token.value));
+        scanner.pop();
+        PopNode();
+        return;
+      }
+
+      m_tag.clear();
+      m_anchor = NullAnchor;
+      m_anchorName.clear();
+      frame.state = PROPERTIES;
+      return;
+    }
+    case PROPERTIES:
+      if (!scanner.empty()) {
+        Token& token = scanner.peek();
+        if (token.type == Token::TAG) {
+          ParseTag(token);
+          scanner.pop();
+          return;
+        }
+        if (token.type == Token::ANCHOR) {
+          ParseAnchor(token);
+          scanner.pop();
+          return;
+        }
+      }
+
+      if (!m_anchorName.empty())
+        handler.OnAnchor(frame.mark, m_anchorName);
+      frame.state = CONTENT;
+      return;
+    default:
+      break;
+  }
+
+  // after parsing properties, an empty node is again a possibility
+  if (scanner.empty()) {
+    handler.OnNull(frame.mark, m_anchor);
+    PopNode();
+    return;
+  }
+
+  Token& token = scanner.peek();
+  const Mark mark = frame.mark;
+
+  // add non-specific tags
+  if (m_tag.empty())
+    m_tag = (token.type == Token::NON_PLAIN_SCALAR ? "!" : "?");
+
+  if (token.type == Token::PLAIN_SCALAR && m_tag == "?" &&
+      IsNullString(token.value)) {
+    handler.OnNull(mark, m_anchor);
+    scanner.pop();
+    PopNode();
+    return;
+  }
+
+  // a block scalar goes in pieces, if the handler asked for them
+  if (token.type == Token::NON_PLAIN_SCALAR &&
+      token.data == Token::BLOCK_SCALAR &&
+      scanner.GetBlockScalarChunkSize() > 0) {
+    HandleBlockScalarChunks(handler, mark, m_tag);
+    scanner.pop();
+    PopNode();
+    return;
+  }
+
+  // now split based on what kind of node we should be
+  switch (token.type) {
+    case Token::PLAIN_SCALAR:
+    case Token::NON_PLAIN_SCALAR:
+      handler.OnOwnedScalar(mark, std::move(m_tag), m_anchor,
+                            std::move(token.value));
+      scanner.pop();
+      PopNode();
+      return;
+    case Token::FLOW_SEQ_START:
+      handler.OnSequenceStart(mark, m_tag, m_anchor, EmitterStyle::Flow);
+      scanner.pop();
+      m_collectionStack.PushCollectionType(CollectionType::FlowSeq);
+      frame.state = FLOW_SEQ_ENTRY;
+      return;
+    case Token::BLOCK_SEQ_START:
+      handler.OnSequenceStart(mark, m_tag, m_anchor, EmitterStyle::Block);
+      scanner.pop();
+      m_collectionStack.PushCollectionType(CollectionType::BlockSeq);
+      frame.state = BLOCK_SEQ_ENTRY;
+      return;
+    case Token::FLOW_MAP_START:
+      handler.OnMapStart(mark, m_tag, m_anchor, EmitterStyle::Flow);
+      scanner.pop();
+      m_collectionStack.PushCollectionType(CollectionType::FlowMap);
+      frame.state = FLOW_MAP_KEY;
+      return;
+    case Token::BLOCK_MAP_START:
+      handler.OnMapStart(mark, m_tag, m_anchor, EmitterStyle::Block);
+      scanner.pop();
+      m_collectionStack.PushCollectionType(CollectionType::BlockMap);
+      frame.state = BLOCK_MAP_KEY;
+      return;
+    case Token::KEY:
+      // compact maps can only go in a flow sequence
+      if (m_collectionStack.GetCurCollectionType() ==
+          CollectionType::FlowSeq) {
+        handler.OnMapStart(mark, m_tag, m_anchor, EmitterStyle::Flow);
+        m_collectionStack.PushCollectionType(CollectionType::CompactMap);
+        frame.mark = token.mark;
+        scanner.pop();
+        frame.state = COMPACT_MAP_VALUE;
+        PushNode();
+        return;
+      }
+      break;
+    default:
+      break;
+  }
+
+  if (m_tag == "?")
+    handler.OnNull(mark, m_anchor);
+  else
+    handler.OnOwnedScalar(mark, std::move(m_tag), m_anchor, std::string());
+  PopNode();
+}
+
+// StepCollection
+// . As SingleDocParser's loops over a collection's entries go, but a step at
+//   a time: each entry's node gets a frame of its own, and the collection
+//   goes on from the state it's left in once that's popped.
+void ResumableParser::StepCollection(EventHandler& handler) {
+  Scanner& scanner = *m_parser.m_pScanner;
+  Frame& frame = m_frames.back();
+
+  switch (frame.state) {
+    case BLOCK_SEQ_ENTRY: {
+      if (scanner.empty())
+        throw ParserException(scanner.mark(), ErrorMsg::END_OF_SEQ);
+
+      const Token::TYPE type = scanner.peek().type;
+      if (type != Token::BLOCK_ENTRY && type != Token::BLOCK_SEQ_END)
+        throw ParserException(scanner.peek().mark, ErrorMsg::END_OF_SEQ);
+
+      scanner.pop();
+      if (type == Token::BLOCK_SEQ_END)
+        EndCollection(handler, CollectionType::BlockSeq);
+      else
+        frame.state = BLOCK_SEQ_NODE;
+      return;
+    }
+    case BLOCK_SEQ_NODE:
+      // check for null
+      if (!scanner.empty()) {
+        const Token& token = scanner.peek();
+        if (token.type == Token::BLOCK_ENTRY ||
+            token.type == Token::BLOCK_SEQ_END) {
+          handler.OnNull(token.mark, NullAnchor);
+          frame.state = BLOCK_SEQ_ENTRY;
+          return;
+        }
+      }
+
+      frame.state = BLOCK_SEQ_ENTRY;
+      PushNode();
+      return;
+    case FLOW_SEQ_ENTRY:
+      if (scanner.empty())
+        throw ParserException(scanner.mark(), ErrorMsg::END_OF_SEQ_FLOW);
+
+      // first check for end
+      if (scanner.peek().type == Token::FLOW_SEQ_END) {
+        scanner.pop();
+        EndCollection(handler, CollectionType::FlowSeq);
+        return;
+      }
+
+      // then read the node
+      frame.state = FLOW_SEQ_SEPARATOR;
+      PushNode();
+      return;
+    case FLOW_SEQ_SEPARATOR: {
+      if (scanner.empty())
+        throw ParserException(scanner.mark(), ErrorMsg::END_OF_SEQ_FLOW);
+
+      // now eat the separator (or could be a sequence end, which we ignore -
+      // but if it's neither, then it's a bad node)
+      Token& token = scanner.peek();
+      if (token.type == Token::FLOW_ENTRY)
+        scanner.pop();
+      else if (token.type != Token::FLOW_SEQ_END)
+        throw ParserException(token.mark, ErrorMsg::END_OF_SEQ_FLOW);
+      frame.state = FLOW_SEQ_ENTRY;
+      return;
+    }
+    case BLOCK_MAP_KEY: {
+      if (scanner.empty())
+        throw ParserException(scanner.mark(), ErrorMsg::END_OF_MAP);
+
+      Token& token = scanner.peek();
+      const Token::TYPE type = token.type;
+      const Mark mark = token.mark;
+      if (type != Token::KEY && type != Token::VALUE &&
+          type != Token::BLOCK_MAP_END)
+        throw ParserException(mark, ErrorMsg::END_OF_MAP);
+
+      if (type == Token::BLOCK_MAP_END) {
+        scanner.pop();
+        EndCollection(handler, CollectionType::BlockMap);
+        return;
+      }
+
+      // grab key (if non-null)
+      frame.mark = mark;
+      frame.state = BLOCK_MAP_VALUE;
+      if (type == Token::KEY) {
+        scanner.pop();
+        PushNode();
+      } else {
+        handler.OnNull(mark, NullAnchor);
+      }
+      return;
+    }
+    case FLOW_MAP_KEY: {
+      if (scanner.empty())
+        throw ParserException(scanner.mark(), ErrorMsg::END_OF_MAP_FLOW);
+
+      Token& token = scanner.peek();
+      const Mark mark = token.mark;
+      // first check for end
+      if (token.type == Token::FLOW_MAP_END) {
+        scanner.pop();
+        EndCollection(handler, CollectionType::FlowMap);
+        return;
+      }
+
+      // grab key (if non-null)
+      frame.mark = mark;
+      frame.state = FLOW_MAP_VALUE;
+      if (token.type == Token::KEY) {
+        scanner.pop();
+        PushNode();
+      } else {
+        handler.OnNull(mark, NullAnchor);
+      }
+      return;
+    }
+    case BLOCK_MAP_VALUE:
+    case FLOW_MAP_VALUE:
+    case COMPACT_MAP_VALUE: {
+      // now grab value (optional)
+      const bool value =
+          !scanner.empty() && scanner.peek().type == Token::VALUE;
+
+      frame.state = frame.state == BLOCK_MAP_VALUE
+                        ? BLOCK_MAP_KEY
+                        : frame.state == FLOW_MAP_VALUE ? FLOW_MAP_SEPARATOR
+                                                        : COMPACT_MAP_END;
+      if (value) {
+        scanner.pop();
+        PushNode();
+      } else {
+        handler.OnNull(frame.mark, NullAnchor);
+      }
+      return;
+    }
+    case FLOW_MAP_SEPARATOR: {
+      if (scanner.empty())
+        throw ParserException(scanner.mark(), ErrorMsg::END_OF_MAP_FLOW);
+
+      // now eat the separator (or could be a map end, which we ignore - but
+      // if it's neither, then it's a bad node)
+      Token& token = scanner.peek();
+      if (token.type == Token::FLOW_ENTRY)
+        scanner.pop();
+      else if (token.type != Token::FLOW_MAP_END)
+        throw ParserException(token.mark, ErrorMsg::END_OF_MAP_FLOW);
+      frame.state = FLOW_MAP_KEY;
+      return;
+    }
+    case COMPACT_MAP_END:
+      EndCollection(handler, CollectionType::CompactMap);
+      return;
+    default:
+      return;
+  }
+}
+
+// PushNode
+// . The frame may be the 500th, which is as deep as SingleDocParser goes.
+void ResumableParser::PushNode() {
+  int depth = static_cast<int>(m_frames.size());
+  DepthGuard<500> depthguard(depth, m_parser.m_pScanner->mark(),
+                             ErrorMsg::BAD_FILE);
+  m_frames.push_back(Frame{NODE, Mark()});
+}
+
+void ResumableParser::PopNode() { m_frames.pop_back(); }
+
+void ResumableParser::EndCollection(EventHandler& handler,
+                                    CollectionType::value type) {
+  m_collectionStack.PopCollectionType(type);
+  if (type == CollectionType::BlockSeq || type == CollectionType::FlowSeq)
+    handler.OnSequenceEnd();
+  else
+    handler.OnMapEnd();
+  PopNode();
+}
+
+// HandleBlockScalarChunks
+// . Over partial input, the scan may run out of it, and be tried again; so
+//   the chunks are held until it's done, or until it fails, and then they
+//   go first, as they would have.
+void ResumableParser::HandleBlockScalarChunks(EventHandler& handler,
+                                              const Mark& mark,
+                                              const std::string& tag) {
+  Scanner& scanner = *m_parser.m_pScanner;
+
+  if (m_complete) {
+    handler.OnScalarStart(mark, tag, m_anchor);
+    ScalarChunkForwarder forwarder(handler);
+    scanner.ScanBlockScalarChunks(forwarder);
+    handler.OnScalarEnd();
+    return;
+  }
+
+  ScalarChunkRecorder recorder;
+  try {
+    scanner.ScanBlockScalarChunks(recorder);
+  } catch (const NeedMoreInput&) {
+    throw;
+  } catch (...) {
+    handler.OnScalarStart(mark, tag, m_anchor);
+    recorder.Replay(handler);
+    throw;
+  }
+  handler.OnScalarStart(mark, tag, m_anchor);
+  recorder.Replay(handler);
+  handler.OnScalarEnd();
+}
+
+void ResumableParser::ParseTag(const Token& token) {
+  if (!m_tag.empty())
+    throw ParserException(token.mark, ErrorMsg::MULTIPLE_TAGS);
+
+  Tag tagInfo(token);
+  m_tag = tagInfo.Translate(*m_parser.m_pDirectives);
+}
+
+void ResumableParser::ParseAnchor(const Token& token) {
+  if (m_anchor)
+    throw ParserException(token.mark, ErrorMsg::MULTIPLE_ANCHORS);
+
+  m_anchorName = token.value;
+  m_anchor = token.value.empty() ? NullAnchor
+                                 : (m_anchors[token.value] = ++m_curAnchor);
+}
+
+anchor_t ResumableParser::LookupAnchor(const Mark& mark,
+                                       const std::string& name) const {
+  auto it = m_anchors.find(name);
+  if (it == m_anchors.end())
+    throw ParserException(mark, ErrorMsg::UNKNOWN_ANCHOR);
+
+  return it->second;
+}
+}  // namespace YAML
@@ -0,0 +1,157 @@
+#ifndef RESUMABLEPARSER_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+#define RESUMABLEPARSER_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+
+#if defined(_MSC_VER) ||                                            \
+    (defined(__GNUC__) && (__GNUC__ == 3 && __GNUC_MINOR__ >= 4) || \
+     (__GNUC__ >= 4))  // GCC supports "pragma once" correctly since 3.4
+#pragma once
+#endif
+
+#include <cstddef>
+#include <istream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "collectionstack.h"
+#include "memorybuf.h"
+#include "yaml-cpp/anchor.h"
+#include "yaml-cpp/mark.h"
+#include "yaml-cpp/parser.h"
+
+namespace YAML {
+class EventHandler;
+class Scanner;
+struct Token;
+
+// ResumableParser
+// . Parses input that comes in pieces (for PushParser), sending the same
+//   events, and throwing the same errors, as Parser and SingleDocParser do
+//   over the whole input.
+// . It goes a token at a time, keeping where it is in the document on a
+//   stack of its own, rather than in recursive calls; so when the scanner
+//   runs out of input (and puts itself back as it was; see Scanner), it
+//   stops, and it carries on from there once there's more, without looking
+//   at anything twice.
+// . It holds just the input the stream hasn't read yet, and the stream holds
+//   what's been read of the token it's on.
+class ResumableParser {
+ public:
+  ResumableParser();
+  ResumableParser(const ResumableParser&) = delete;
+  ResumableParser(ResumableParser&&) = delete;
+  ResumableParser& operator=(const ResumableParser&) = delete;
+  ResumableParser& operator=(ResumableParser&&) = delete;
+  ~ResumableParser();
+
+  // Adds 'size' bytes of input, copying them.
+  void Feed(const char* data, std::size_t size);
+
+  // Marks the end of the input.
+  void Finish();
+
+  // Parses as far as the input goes, sending the events to 'handler', and
+  // returns the number of documents it ended.
+  // . A token that runs out of input is scanned again from its start; so
+  //   lest a long one be scanned over and over, this waits to try it again
+  //   until as much input has come in since as it had got through.
+  // . Throws a ParserException on error (after which it mustn't be called
+  //   again).
+  std::size_t Parse(EventHandler& handler);
+
+ private:
+  // where the parser is: between documents, or, in a document, in the
+  // node on top of the stack (named for the part of SingleDocParser it's in)
+  enum State {
+    // between documents (HandleNextDocument)
+    NEXT_DOCUMENT,
+    DIRECTIVES,
+    IN_DOCUMENT,
+    DOCUMENT_ENDS,
+    END,
+
+    // in a node (HandleNode)
+    NODE,
+    PROPERTIES,
+    CONTENT,
+
+    // in a collection
+    BLOCK_SEQ_ENTRY,
+    BLOCK_SEQ_NODE,
+    FLOW_SEQ_ENTRY,
+    FLOW_SEQ_SEPARATOR,
+    BLOCK_MAP_KEY,
+    BLOCK_MAP_VALUE,
+    FLOW_MAP_KEY,
+    FLOW_MAP_VALUE,
+    FLOW_MAP_SEPARATOR,
+    COMPACT_MAP_VALUE,
+    COMPACT_MAP_END
+  };
+
+  // a node that's being parsed: what it's in the middle of, and the mark
+  // it uses next (its own, until it starts a collection; then that of the
+  // key it's on, for a null key or value)
+  struct Frame {
+    State state;
+    Mark mark;
+  };
+
+  // Starts the scanner, once there's enough input to tell its encoding;
+  // returns whether it did.
+  bool Start();
+
+  // Takes the next step: one event, or a few that the same tokens decide,
+  // after any scanning it needs (which, if it runs out of input, throws
+  // NeedMoreInput before the step changes anything). Returns false at the
+  // end of the stream.
+  bool Step(EventHandler& handler);
+  bool StepBetweenDocuments(EventHandler& handler);
+  void StepNode(EventHandler& handler);
+  void StepCollection(EventHandler& handler);
+
+  // Starts parsing a node (with a new frame, as HandleNode would be called),
+  // and ends it.
+  void PushNode();
+  void PopNode();
+
+  // Ends the collection that the node on top started, and the node.
+  void EndCollection(EventHandler& handler, CollectionType::value type);
+
+  void HandleBlockScalarChunks(EventHandler& handler, const Mark& mark,
+                               const std::string& tag);
+
+  void ParseTag(const Token& token);
+  void ParseAnchor(const Token& token);
+  anchor_t LookupAnchor(const Mark& mark, const std::string& name) const;
+
+ private:
+  // the input that the stream hasn't read yet, and it to read from
+  std::string m_input;
+  MemoryBuf m_buffer;
+  std::istream m_stream;
+  bool m_complete;
+  std::size_t m_fed;     // how much has come in since the last try
+  std::size_t m_wanted;  // and how much the next one waits for
+
+  // (the parser holds the scanner and the directives)
+  Parser m_parser;
+  State m_state;
+  bool m_readDirective;
+  std::size_t m_documents;
+
+  // the document
+  std::vector<Frame> m_frames;
+  CollectionStack m_collectionStack;
+  using Anchors = std::map<std::string, anchor_t>;
+  Anchors m_anchors;
+  anchor_t m_curAnchor;
+
+  // the properties of the node that's starting
+  std::string m_tag;
+  anchor_t m_anchor;
+  std::string m_anchorName;
+};
+}  // namespace YAML
+
+#endif  // RESUMABLEPARSER_H_62B23520_7C8E_11DE_8A39_0800200C9A66
@@ -1,5 +1,4 @@
 #include <cassert>
-#include <memory>
 
 #include "exp.h"
 #include "scanner.h"
@@ -7,8 +6,13 @@
 #include "yaml-cpp/exceptions.h"  // IWYU pragma: keep
 
 namespace YAML {
-Scanner::Scanner(std::istream& in)
-    : INPUT(in),
+Scanner::Scanner(std::istream& in) : Scanner(in, Mark()) {}
+
+Scanner::Scanner(std::istream& in, const Mark& start)
+    : Scanner(in, start, false) {}
+
+Scanner::Scanner(std::istream& in, const Mark& start, bool partial)
+    : INPUT(in, start, partial),
       m_tokens{},
       m_startedStream(false),
       m_endedStream(false),
@@ -16,11 +20,30 @@ Scanner::Scanner(std::istream& in)
       m_canBeJSONFlow(false),
       m_simpleKeys{},
       m_indents{},
-      m_indentRefs{},
-      m_flows{} {}
+      m_flows{},
+      m_blockScalarChunkSize(0),
+      m_pDeferredScalar(nullptr),
+      m_deferredParams{},
+      m_chunkBuffer{},
+      m_rewindPoint{},
+      m_rewound(0) {}
 
 Scanner::~Scanner() = default;
 
+template <typename Scan>
+void Scanner::ScanOrRewind(Scan scan) {
+  if (!INPUT.partial())
+    return scan();
+
+  SetRewindPoint();
+  try {
+    scan();
+  } catch (const NeedMoreInput&) {
+    Rewind();
+    throw;
+  }
+}
+
 bool Scanner::empty() {
   EnsureTokensInQueue();
   return m_tokens.empty();
@@ -28,8 +51,13 @@ bool Scanner::empty() {
 
 void Scanner::pop() {
   EnsureTokensInQueue();
-  if (!m_tokens.empty())
-    m_tokens.pop();
+  if (m_tokens.empty())
+    return;
+
+  // (a block scalar's content has to be scanned before what's after it)
+  if (&m_tokens.front() == m_pDeferredScalar)
+    ScanOrRewind([this] { ScanDeferredBlockScalar(nullptr); });
+  m_tokens.pop();
 }
 
 Token& Scanner::peek() {
@@ -50,6 +78,34 @@ Token& Scanner::peek() {
 
 Mark Scanner::mark() const { return INPUT.mark(); }
 
+void Scanner::SetBlockScalarChunkSize(std::size_t size) {
+  m_blockScalarChunkSize = size;
+  if (size == 0 && m_pDeferredScalar)
+    ScanOrRewind([this] { ScanDeferredBlockScalar(nullptr); });
+}
+
+void Scanner::ScanBlockScalarChunks(ScalarChunkSink& sink) {
+  assert(m_blockScalarChunkSize > 0);
+  Token& token = peek();
+  if (&token == m_pDeferredScalar) {
+    ScanOrRewind([this, &sink] { ScanDeferredBlockScalar(&sink); });
+  } else {
+    // (it was scanned whole, before the chunk size was set)
+    WriteChunks(sink, token.value.data(), token.value.size(),
+                m_blockScalarChunkSize);
+  }
+}
+
+void Scanner::ScanDeferredBlockScalar(ScalarChunkSink* sink) {
+  Token& token = *m_pDeferredScalar;
+  m_pDeferredScalar = nullptr;
+
+  ScanScalarParams& params = m_deferredParams;
+  params.sink = sink;
+  params.chunkSize = m_blockScalarChunkSize;
+  ScanScalar(INPUT, params, sink ? m_chunkBuffer : token.value);
+}
+
 void Scanner::EnsureTokensInQueue() {
   while (true) {
     if (!m_tokens.empty()) {
@@ -75,11 +131,15 @@ void Scanner::EnsureTokensInQueue() {
     }
 
     // no? then scan...
-    ScanNextToken();
+    ScanOrRewind([this] { ScanNextToken(); });
   }
 }
 
 void Scanner::ScanNextToken() {
+  if (m_pDeferredScalar) {
+    return ScanDeferredBlockScalar(nullptr);
+  }
+
   if (m_endedStream) {
     return;
   }
@@ -245,10 +305,7 @@ const RegEx& Scanner::GetValueRegex() const {
 void Scanner::StartStream() {
   m_startedStream = true;
   m_simpleKeyAllowed = true;
-  std::unique_ptr<IndentMarker> pIndent(
-      new IndentMarker(-1, IndentMarker::NONE));
-  m_indentRefs.push_back(std::move(pIndent));
-  m_indents.push(&m_indentRefs.back());
+  m_indents.push_back(IndentMarker(-1, IndentMarker::NONE));
 }
 
 void Scanner::EndStream() {
@@ -265,8 +322,7 @@ void Scanner::EndStream() {
 }
 
 Token* Scanner::PushToken(Token::TYPE type) {
-  m_tokens.push(Token(type, INPUT.mark()));
-  return &m_tokens.back();
+  return &m_tokens.push(type, INPUT.mark());
 }
 
 Token::TYPE Scanner::GetStartTokenFor(IndentMarker::INDENT_TYPE type) const {
@@ -290,9 +346,8 @@ Scanner::IndentMarker* Scanner::PushIndentTo(int column,
     return nullptr;
   }
 
-  std::unique_ptr<IndentMarker> pIndent(new IndentMarker(column, type));
-  IndentMarker& indent = *pIndent;
-  const IndentMarker& lastIndent = *m_indents.top();
+  IndentMarker indent(column, type);
+  const IndentMarker& lastIndent = m_indents.back();
 
   // is this actually an indentation?
   if (indent.column < lastIndent.column) {
@@ -308,9 +363,8 @@ Scanner::IndentMarker* Scanner::PushIndentTo(int column,
   indent.pStartToken = PushToken(GetStartTokenFor(type));
 
   // and then the indent
-  m_indents.push(&indent);
-  m_indentRefs.push_back(std::move(pIndent));
-  return &m_indentRefs.back();
+  m_indents.push_back(indent);
+  return &m_indents.back();
 }
 
 void Scanner::PopIndentToHere() {
@@ -321,7 +375,7 @@ void Scanner::PopIndentToHere() {
 
   // now pop away
   while (!m_indents.empty()) {
-    const IndentMarker& indent = *m_indents.top();
+    const IndentMarker& indent = m_indents.back();
     if (indent.column < INPUT.column()) {
       break;
     }
@@ -335,7 +389,7 @@ void Scanner::PopIndentToHere() {
   }
 
   while (!m_indents.empty() &&
-         m_indents.top()->status == IndentMarker::INVALID) {
+         m_indents.back().status == IndentMarker::INVALID) {
     PopIndent();
   }
 }
@@ -348,7 +402,7 @@ void Scanner::PopAllIndents() {
 
   // now pop away
   while (!m_indents.empty()) {
-    const IndentMarker& indent = *m_indents.top();
+    const IndentMarker& indent = m_indents.back();
     if (indent.type == IndentMarker::NONE) {
       break;
     }
@@ -358,18 +412,21 @@ void Scanner::PopAllIndents() {
 }
 
 void Scanner::PopIndent() {
-  const IndentMarker& indent = *m_indents.top();
-  m_indents.pop();
+  const IndentMarker indent = m_indents.back();
 
+  // (an unsettled indent belongs to the simple key, so settle that while the
+  // indent is still on the stack)
   if (indent.status != IndentMarker::VALID) {
     InvalidateSimpleKey();
+    m_indents.pop_back();
     return;
   }
 
+  m_indents.pop_back();
   if (indent.type == IndentMarker::SEQ) {
-    m_tokens.push(Token(Token::BLOCK_SEQ_END, INPUT.mark()));
+    m_tokens.push(Token::BLOCK_SEQ_END, INPUT.mark());
   } else if (indent.type == IndentMarker::MAP) {
-    m_tokens.push(Token(Token::BLOCK_MAP_END, INPUT.mark()));
+    m_tokens.push(Token::BLOCK_MAP_END, INPUT.mark());
   }
 }
 
@@ -377,7 +434,54 @@ int Scanner::GetTopIndent() const {
   if (m_indents.empty()) {
     return 0;
   }
-  return m_indents.top()->column;
+  return m_indents.back().column;
+}
+
+// SetRewindPoint
+// . (Assigning to the vectors that are kept reuses their memory, so this
+//   doesn't allocate once they've grown to fit.)
+void Scanner::SetRewindPoint() {
+  INPUT.SetRewindPoint();
+
+  RewindPoint& point = m_rewindPoint;
+  point.tokens = m_tokens.size();
+  point.startedStream = m_startedStream;
+  point.endedStream = m_endedStream;
+  point.simpleKeyAllowed = m_simpleKeyAllowed;
+  point.canBeJSONFlow = m_canBeJSONFlow;
+  point.simpleKeys = m_simpleKeys;
+  point.keyStatuses.clear();
+  for (const SimpleKey& key : m_simpleKeys) {
+    point.keyStatuses.push_back(key.pMapStart ? key.pMapStart->status
+                                              : Token::VALID);
+    point.keyStatuses.push_back(key.pKey ? key.pKey->status : Token::VALID);
+  }
+  point.indents = m_indents;
+  point.flows = m_flows;
+  point.pDeferredScalar = m_pDeferredScalar;
+  point.deferredParams = m_deferredParams;
+}
+
+void Scanner::Rewind() {
+  m_rewound = INPUT.Rewind();
+
+  const RewindPoint& point = m_rewindPoint;
+  m_tokens.truncate(point.tokens);
+  m_startedStream = point.startedStream;
+  m_endedStream = point.endedStream;
+  m_simpleKeyAllowed = point.simpleKeyAllowed;
+  m_canBeJSONFlow = point.canBeJSONFlow;
+  m_simpleKeys = point.simpleKeys;
+  for (std::size_t i = 0; i < m_simpleKeys.size(); i++) {
+    if (m_simpleKeys[i].pMapStart)
+      m_simpleKeys[i].pMapStart->status = point.keyStatuses[2 * i];
+    if (m_simpleKeys[i].pKey)
+      m_simpleKeys[i].pKey->status = point.keyStatuses[2 * i + 1];
+  }
+  m_indents = point.indents;
+  m_flows = point.flows;
+  m_pDeferredScalar = point.pDeferredScalar;
+  m_deferredParams = point.deferredParams;
 }
 
 void Scanner::ThrowParserException(const std::string& msg) const {
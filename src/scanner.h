@@ -10,14 +10,14 @@
 #include <cstddef>
 #include <ios>
 #include <map>
-#include <queue>
 #include <set>
-#include <stack>
 #include <string>
+#include <vector>
 
-#include "ptr_vector.h"
+#include "scanscalar.h"
 #include "stream.h"
 #include "token.h"
+#include "tokenqueue.h"
 #include "yaml-cpp/mark.h"
 
 namespace YAML {
@@ -30,6 +30,11 @@ class RegEx;
 class Scanner {
  public:
   explicit Scanner(std::istream &in);
+  Scanner(std::istream &in, const Mark &start);
+  // (over input that may go on past its end; see Stream)
+  Scanner(std::istream &in, const Mark &start, bool partial);
+  Scanner(const Scanner &) = delete;
+  Scanner &operator=(const Scanner &) = delete;
   ~Scanner();
 
   /** Returns true if there are no more tokens to be read. */
@@ -44,6 +49,41 @@ class Scanner {
   /** Returns the current mark in the input stream. */
   Mark mark() const;
 
+  /**
+   * Marks partial input (see Stream) as complete, so that its end ends the
+   * stream.
+   */
+  void Complete() { INPUT.Complete(); }
+
+  /**
+   * How many characters the last scan of partial input had read when it ran
+   * out of it, and was undone.
+   */
+  std::size_t rewound() const { return m_rewound; }
+
+  // (for tests: how many tokens, indents, simple keys and flow levels the
+  // scanner has room for, which shouldn't grow with the input's length)
+  std::size_t capacity() const {
+    return m_tokens.capacity() + m_simpleKeys.capacity() +
+           m_indents.capacity() + m_flows.capacity();
+  }
+
+  /**
+   * Sets the size of the pieces that block scalars are handed over in, by
+   * {@link #ScanBlockScalarChunks}; from then on, the scanner leaves their
+   * content in the input until it's asked for. Zero (the default) means
+   * they're scanned whole, into their token's value.
+   */
+  void SetBlockScalarChunkSize(std::size_t size);
+  std::size_t GetBlockScalarChunkSize() const { return m_blockScalarChunkSize; }
+
+  /**
+   * Hands the value of the block scalar at the front of the queue to
+   * {@code sink}, in pieces of at most the chunk size (which must be set);
+   * if its content is still in the input, it's scanned as it goes.
+   */
+  void ScanBlockScalarChunks(ScalarChunkSink& sink);
+
  private:
   struct IndentMarker {
     enum INDENT_TYPE { MAP, SEQ, NONE };
@@ -96,7 +136,8 @@ class Scanner {
    * Pushes an indentation onto the stack, and enqueues the proper token
    * (sequence start or mapping start).
    *
-   * @return the indent marker it generates (if any).
+   * @return the indent marker it generates (if any), which is only valid
+   *         until the stack next changes.
    */
   IndentMarker *PushIndentTo(int column, IndentMarker::INDENT_TYPE type);
 
@@ -141,12 +182,15 @@ class Scanner {
   struct SimpleKey {
     SimpleKey(const Mark &mark_, std::size_t flowLevel_);
 
-    void Validate();
-    void Invalidate();
+    // . The indent is found by its place on the stack (0, the base indent, if
+    //   the key didn't start one), since markers move as the stack grows. It's
+    //   still there when the key is settled: popping it settles the key.
+    void Validate(std::vector<IndentMarker> &indents);
+    void Invalidate(std::vector<IndentMarker> &indents);
 
     Mark mark;
     std::size_t flowLevel;
-    IndentMarker *pIndent;
+    std::size_t indent;
     Token *pMapStart, *pKey;
   };
 
@@ -169,21 +213,63 @@ class Scanner {
   void ScanQuotedScalar();
   void ScanBlockScalar();
 
+  /**
+   * Scans the content of the block scalar that was left in the input, to
+   * {@code sink}, or into its token's value if there's no sink.
+   */
+  void ScanDeferredBlockScalar(ScalarChunkSink* sink);
+
+  /**
+   * Calls {@code scan}. Over partial input, if it runs out of input, this
+   * puts the scanner back as it was, and passes NeedMoreInput on, so that
+   * the scan can be tried again once there's more; so between scans, the
+   * scanner never holds half a token.
+   */
+  template <typename Scan>
+  void ScanOrRewind(Scan scan);
+
+  void SetRewindPoint();
+  void Rewind();
+
  private:
   // the stream
   Stream INPUT;
 
   // the output (tokens)
-  std::queue<Token> m_tokens;
+  TokenQueue m_tokens;
 
   // state info
   bool m_startedStream, m_endedStream;
   bool m_simpleKeyAllowed;
   bool m_canBeJSONFlow;
-  std::stack<SimpleKey> m_simpleKeys;
-  std::stack<IndentMarker *> m_indents;
-  ptr_vector<IndentMarker> m_indentRefs;  // for "garbage collection"
-  std::stack<FLOW_MARKER> m_flows;
+  // (these are stacks, kept in vectors so their memory is reused)
+  std::vector<SimpleKey> m_simpleKeys;
+  std::vector<IndentMarker> m_indents;
+  std::vector<FLOW_MARKER> m_flows;
+
+  // block scalars handed over in pieces
+  std::size_t m_blockScalarChunkSize;
+  Token* m_pDeferredScalar;  // the one whose content is still in the input
+  ScanScalarParams m_deferredParams;
+  std::string m_chunkBuffer;
+
+  // the state to go back to if a scan of partial input runs out of it (but
+  // the stream's, which it keeps); a scan only adds tokens to the queue, and
+  // changes the status of the ones that simple keys point to
+  struct RewindPoint {
+    std::size_t tokens = 0;
+    bool startedStream = false, endedStream = false;
+    bool simpleKeyAllowed = false;
+    bool canBeJSONFlow = false;
+    std::vector<SimpleKey> simpleKeys{};
+    std::vector<Token::STATUS> keyStatuses{};  // (two per simple key)
+    std::vector<IndentMarker> indents{};
+    std::vector<FLOW_MARKER> flows{};
+    Token* pDeferredScalar = nullptr;
+    ScanScalarParams deferredParams{};
+  };
+  RewindPoint m_rewindPoint;
+  std::size_t m_rewound;
 };
 }
 
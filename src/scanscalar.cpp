@@ -8,6 +8,46 @@
 #include "yaml-cpp/exceptions.h"  // IWYU pragma: keep
 
 namespace YAML {
+namespace {
+void WriteBreaks(ScalarChunkSink& sink, std::size_t count,
+                 std::size_t chunkSize) {
+  const std::string breaks(std::min(count, chunkSize), '\n');
+  while (count > 0) {
+    const std::size_t n = std::min(count, breaks.size());
+    sink.OnChunk(breaks.data(), n);
+    count -= n;
+  }
+}
+
+// FlushChunk
+// . Hands what's been scanned so far to the sink, except for the line breaks
+//   at the end, which chomping may still remove; those are only counted (in
+//   'heldBreaks'), so a long run of empty lines doesn't pile up either.
+void FlushChunk(const ScanScalarParams& params, std::string& scalar,
+                std::size_t& heldBreaks, bool& flushedContent) {
+  const std::size_t pos = scalar.find_last_not_of('\n');
+  if (pos == std::string::npos) {
+    heldBreaks += scalar.size();
+  } else {
+    WriteBreaks(*params.sink, heldBreaks, params.chunkSize);
+    WriteChunks(*params.sink, scalar.data(), pos + 1, params.chunkSize);
+    heldBreaks = scalar.size() - pos - 1;
+    flushedContent = true;
+  }
+  scalar.clear();
+}
+}  // namespace
+
+void WriteChunks(ScalarChunkSink& sink, const char* data, std::size_t size,
+                 std::size_t chunkSize) {
+  while (size > 0) {
+    const std::size_t n = std::min(size, chunkSize);
+    sink.OnChunk(data, n);
+    data += n;
+    size -= n;
+  }
+}
+
 // ScanScalar
 // . This is where the scalar magic happens.
 //
@@ -18,14 +58,19 @@ namespace YAML {
 //
 // . Depending on the parameters given, we store or stop
 //   and different places in the above flow.
-std::string ScanScalar(Stream& INPUT, ScanScalarParams& params) {
+//
+// . With a sink, we flush 'scalar' to it whenever it reaches the chunk size,
+//   and chomp the line breaks we've held back at the end.
+void ScanScalar(Stream& INPUT, ScanScalarParams& params, std::string& scalar) {
   bool foundNonEmptyLine = false;
   bool pastOpeningBreak = (params.fold == FOLD_FLOW);
   bool emptyLine = false, moreIndented = false;
   int foldedNewlineCount = 0;
   bool foldedNewlineStartedMoreIndented = false;
   std::size_t lastEscapedChar = std::string::npos;
-  std::string scalar;
+  std::size_t heldBreaks = 0;
+  bool flushedContent = false;
+  scalar.clear();
   params.leadingSpaces = false;
 
   if (!params.end) {
@@ -80,6 +125,9 @@ std::string ScanScalar(Stream& INPUT, ScanScalarParams& params) {
       if (ch != ' ' && ch != '\t') {
         lastNonWhitespaceChar = scalar.size();
       }
+      if (params.sink && scalar.size() >= params.chunkSize) {
+        FlushChunk(params, scalar, heldBreaks, flushedContent);
+      }
     }
 
     // eof? if we're looking to eat something, then we throw
@@ -195,14 +243,34 @@ std::string ScanScalar(Stream& INPUT, ScanScalarParams& params) {
     moreIndented = nextMoreIndented;
     pastOpeningBreak = true;
 
+    if (params.sink && scalar.size() >= params.chunkSize) {
+      FlushChunk(params, scalar, heldBreaks, flushedContent);
+    }
+
     // are we done via indentation?
     if (!emptyLine && INPUT.column() < params.indent) {
       params.leadingSpaces = true;
       break;
     }
+
+    // eof after a line break? that's still eof in the scalar
+    if (!INPUT && params.eatEnd) {
+      throw ParserException(INPUT.mark(), ErrorMsg::EOF_IN_SCALAR);
+    }
   }
 
   // post-processing
+  if (params.sink) {
+    FlushChunk(params, scalar, heldBreaks, flushedContent);
+    if (params.chomp == STRIP || (params.chomp == CLIP && !flushedContent)) {
+      heldBreaks = 0;
+    } else if (params.chomp == CLIP) {
+      heldBreaks = std::min<std::size_t>(heldBreaks, 1);
+    }
+    WriteBreaks(*params.sink, heldBreaks, params.chunkSize);
+    return;
+  }
+
   if (params.trimTrailingSpaces) {
     std::size_t pos = scalar.find_last_not_of(" \t");
     if (lastEscapedChar != std::string::npos) {
@@ -245,7 +313,5 @@ std::string ScanScalar(Stream& INPUT, ScanScalarParams& params) {
     default:
       break;
   }
-
-  return scalar;
 }
 }  // namespace YAML
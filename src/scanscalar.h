@@ -7,6 +7,7 @@
 #pragma once
 #endif
 
+#include <cstddef>
 #include <string>
 
 #include "regex_yaml.h"
@@ -17,6 +18,14 @@ enum CHOMP { STRIP = -1, CLIP, KEEP };
 enum ACTION { NONE, BREAK, THROW };
 enum FOLD { DONT_FOLD, FOLD_BLOCK, FOLD_FLOW };
 
+// ScalarChunkSink
+// . Takes a scalar in pieces, as it's scanned (see ScanScalarParams::sink).
+class ScalarChunkSink {
+ public:
+  virtual ~ScalarChunkSink() = default;
+  virtual void OnChunk(const char* data, std::size_t size) = 0;
+};
+
 struct ScanScalarParams {
   ScanScalarParams()
       : end(nullptr),
@@ -30,6 +39,8 @@ struct ScanScalarParams {
         chomp(CLIP),
         onDocIndicator(NONE),
         onTabInIndentation(NONE),
+        sink(nullptr),
+        chunkSize(0),
         leadingSpaces(false) {}
 
   // input:
@@ -52,12 +63,23 @@ struct ScanScalarParams {
   ACTION onDocIndicator;      // what do we do if we see a document indicator?
   ACTION onTabInIndentation;  // what do we do if we see a tab where we should
                               // be seeing indentation spaces
+  ScalarChunkSink* sink;  // if set, the scalar goes here as it's scanned, in
+                          // pieces of at most 'chunkSize' bytes, and 'scalar'
+                          // is only a buffer; unowned. (only for block
+                          // scalars, which don't trim trailing spaces)
+  std::size_t chunkSize;
 
   // output:
   bool leadingSpaces;
 };
 
-std::string ScanScalar(Stream& INPUT, ScanScalarParams& params);
+// Scans a scalar into 'scalar' (replacing what's there, but reusing its
+// memory).
+void ScanScalar(Stream& INPUT, ScanScalarParams& params, std::string& scalar);
+
+// Hands 'size' bytes of 'data' to 'sink' in pieces of at most 'chunkSize'.
+void WriteChunks(ScalarChunkSink& sink, const char* data, std::size_t size,
+                 std::size_t chunkSize);
 }
 
 #endif  // SCANSCALAR_H_62B23520_7C8E_11DE_8A39_0800200C9A66
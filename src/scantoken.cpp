@@ -1,4 +1,5 @@
 #include <sstream>
+#include <utility>
 
 #include "exp.h"
 #include "regex_yaml.h"
@@ -29,7 +30,7 @@ void Scanner::ScanDirective() {
   m_canBeJSONFlow = false;
 
   // store pos and eat indicator
-  Token token(Token::DIRECTIVE, INPUT.mark());
+  Token& token = m_tokens.prepare(Token::DIRECTIVE, INPUT.mark());
   INPUT.eat(1);
 
   // read name
@@ -51,10 +52,10 @@ void Scanner::ScanDirective() {
     while (INPUT && !Exp::BlankOrBreak().Matches(INPUT))
       param += INPUT.get();
 
-    token.params.push_back(param);
+    token.params.push_back(std::move(param));
   }
 
-  m_tokens.push(token);
+  m_tokens.commit();
 }
 
 // DocStart
@@ -67,7 +68,7 @@ void Scanner::ScanDocStart() {
   // eat
   Mark mark = INPUT.mark();
   INPUT.eat(3);
-  m_tokens.push(Token(Token::DOC_START, mark));
+  m_tokens.push(Token::DOC_START, mark);
 }
 
 // DocEnd
@@ -80,7 +81,7 @@ void Scanner::ScanDocEnd() {
   // eat
   Mark mark = INPUT.mark();
   INPUT.eat(3);
-  m_tokens.push(Token(Token::DOC_END, mark));
+  m_tokens.push(Token::DOC_END, mark);
 }
 
 // FlowStart
@@ -94,10 +95,10 @@ void Scanner::ScanFlowStart() {
   Mark mark = INPUT.mark();
   char ch = INPUT.get();
   FLOW_MARKER flowType = (ch == Keys::FlowSeqStart ? FLOW_SEQ : FLOW_MAP);
-  m_flows.push(flowType);
+  m_flows.push_back(flowType);
   Token::TYPE type =
       (flowType == FLOW_SEQ ? Token::FLOW_SEQ_START : Token::FLOW_MAP_START);
-  m_tokens.push(Token(type, mark));
+  m_tokens.push(type, mark);
 }
 
 // FlowEnd
@@ -107,9 +108,9 @@ void Scanner::ScanFlowEnd() {
 
   // we might have a solo entry in the flow context
   if (InFlowContext()) {
-    if (m_flows.top() == FLOW_MAP && VerifySimpleKey())
-      m_tokens.push(Token(Token::VALUE, INPUT.mark()));
-    else if (m_flows.top() == FLOW_SEQ)
+    if (m_flows.back() == FLOW_MAP && VerifySimpleKey())
+      m_tokens.push(Token::VALUE, INPUT.mark());
+    else if (m_flows.back() == FLOW_SEQ)
       InvalidateSimpleKey();
   }
 
@@ -122,21 +123,21 @@ void Scanner::ScanFlowEnd() {
 
   // check that it matches the start
   FLOW_MARKER flowType = (ch == Keys::FlowSeqEnd ? FLOW_SEQ : FLOW_MAP);
-  if (m_flows.top() != flowType)
+  if (m_flows.back() != flowType)
     throw ParserException(mark, ErrorMsg::FLOW_END);
-  m_flows.pop();
+  m_flows.pop_back();
 
   Token::TYPE type = (flowType ? Token::FLOW_SEQ_END : Token::FLOW_MAP_END);
-  m_tokens.push(Token(type, mark));
+  m_tokens.push(type, mark);
 }
 
 // FlowEntry
 void Scanner::ScanFlowEntry() {
   // we might have a solo entry in the flow context
   if (InFlowContext()) {
-    if (m_flows.top() == FLOW_MAP && VerifySimpleKey())
-      m_tokens.push(Token(Token::VALUE, INPUT.mark()));
-    else if (m_flows.top() == FLOW_SEQ)
+    if (m_flows.back() == FLOW_MAP && VerifySimpleKey())
+      m_tokens.push(Token::VALUE, INPUT.mark());
+    else if (m_flows.back() == FLOW_SEQ)
       InvalidateSimpleKey();
   }
 
@@ -146,7 +147,7 @@ void Scanner::ScanFlowEntry() {
   // eat
   Mark mark = INPUT.mark();
   INPUT.eat(1);
-  m_tokens.push(Token(Token::FLOW_ENTRY, mark));
+  m_tokens.push(Token::FLOW_ENTRY, mark);
 }
 
 // BlockEntry
@@ -166,7 +167,7 @@ void Scanner::ScanBlockEntry() {
   // eat
   Mark mark = INPUT.mark();
   INPUT.eat(1);
-  m_tokens.push(Token(Token::BLOCK_ENTRY, mark));
+  m_tokens.push(Token::BLOCK_ENTRY, mark);
 }
 
 // Key
@@ -185,7 +186,7 @@ void Scanner::ScanKey() {
   // eat
   Mark mark = INPUT.mark();
   INPUT.eat(1);
-  m_tokens.push(Token(Token::KEY, mark));
+  m_tokens.push(Token::KEY, mark);
 }
 
 // Value
@@ -214,13 +215,12 @@ void Scanner::ScanValue() {
   // eat
   Mark mark = INPUT.mark();
   INPUT.eat(1);
-  m_tokens.push(Token(Token::VALUE, mark));
+  m_tokens.push(Token::VALUE, mark);
 }
 
 // AnchorOrAlias
 void Scanner::ScanAnchorOrAlias() {
   bool alias;
-  std::string name;
 
   // insert a potential simple key
   InsertPotentialSimpleKey();
@@ -231,6 +231,8 @@ void Scanner::ScanAnchorOrAlias() {
   Mark mark = INPUT.mark();
   char indicator = INPUT.get();
   alias = (indicator == Keys::Alias);
+  Token& token = m_tokens.prepare(alias ? Token::ALIAS : Token::ANCHOR, mark);
+  std::string& name = token.value;
 
   // now eat the content
   while (INPUT && Exp::Anchor().Matches(INPUT))
@@ -247,9 +249,7 @@ void Scanner::ScanAnchorOrAlias() {
                                               : ErrorMsg::CHAR_IN_ANCHOR);
 
   // and we're done
-  Token token(alias ? Token::ALIAS : Token::ANCHOR, mark);
-  token.value = name;
-  m_tokens.push(token);
+  m_tokens.commit();
 }
 
 // Tag
@@ -259,7 +259,7 @@ void Scanner::ScanTag() {
   m_simpleKeyAllowed = false;
   m_canBeJSONFlow = false;
 
-  Token token(Token::TAG, INPUT.mark());
+  Token& token = m_tokens.prepare(Token::TAG, INPUT.mark());
 
   // eat the indicator
   INPUT.get();
@@ -288,13 +288,11 @@ void Scanner::ScanTag() {
     }
   }
 
-  m_tokens.push(token);
+  m_tokens.commit();
 }
 
 // PlainScalar
 void Scanner::ScanPlainScalar() {
-  std::string scalar;
-
   // set up the scanning parameters
   ScanScalarParams params;
   params.end =
@@ -311,8 +309,8 @@ void Scanner::ScanPlainScalar() {
   // insert a potential simple key
   InsertPotentialSimpleKey();
 
-  Mark mark = INPUT.mark();
-  scalar = ScanScalar(INPUT, params);
+  Token& token = m_tokens.prepare(Token::PLAIN_SCALAR, INPUT.mark());
+  ScanScalar(INPUT, params, token.value);
 
   // can have a simple key only if we ended the scalar by starting a new line
   m_simpleKeyAllowed = params.leadingSpaces;
@@ -322,15 +320,11 @@ void Scanner::ScanPlainScalar() {
   // if(Exp::IllegalCharInScalar.Matches(INPUT))
   //	throw ParserException(INPUT.mark(), ErrorMsg::CHAR_IN_SCALAR);
 
-  Token token(Token::PLAIN_SCALAR, mark);
-  token.value = scalar;
-  m_tokens.push(token);
+  m_tokens.commit();
 }
 
 // QuotedScalar
 void Scanner::ScanQuotedScalar() {
-  std::string scalar;
-
   // peek at single or double quote (don't eat because we need to preserve (for
   // the time being) the input position)
   char quote = INPUT.peek();
@@ -338,8 +332,8 @@ void Scanner::ScanQuotedScalar() {
 
   // setup the scanning parameters
   ScanScalarParams params;
-  RegEx end = (single ? RegEx(quote) & !Exp::EscSingleQuote() : RegEx(quote));
-  params.end = &end;
+  params.end = (single ? &Exp::EndSingleQuotedScalar()
+                        : &Exp::EndDoubleQuotedScalar());
   params.eatEnd = true;
   params.escape = (single ? '\'' : '\\');
   params.indent = 0;
@@ -352,19 +346,17 @@ void Scanner::ScanQuotedScalar() {
   // insert a potential simple key
   InsertPotentialSimpleKey();
 
-  Mark mark = INPUT.mark();
+  Token& token = m_tokens.prepare(Token::NON_PLAIN_SCALAR, INPUT.mark());
 
   // now eat that opening quote
   INPUT.get();
 
   // and scan
-  scalar = ScanScalar(INPUT, params);
+  ScanScalar(INPUT, params, token.value);
   m_simpleKeyAllowed = false;
   m_canBeJSONFlow = true;
 
-  Token token(Token::NON_PLAIN_SCALAR, mark);
-  token.value = scalar;
-  m_tokens.push(token);
+  m_tokens.commit();
 }
 
 // BlockScalarToken
@@ -373,8 +365,6 @@ void Scanner::ScanQuotedScalar() {
 // of the scalar),
 //   and then we need to figure out what level of indentation we'll be using.
 void Scanner::ScanBlockScalar() {
-  std::string scalar;
-
   ScanScalarParams params;
   params.indent = 1;
   params.detectIndent = true;
@@ -423,15 +413,21 @@ void Scanner::ScanBlockScalar() {
   params.trimTrailingSpaces = false;
   params.onTabInIndentation = THROW;
 
-  scalar = ScanScalar(INPUT, params);
+  Token& token = m_tokens.prepare(Token::NON_PLAIN_SCALAR, mark);
+  token.data = Token::BLOCK_SCALAR;
+  if (m_blockScalarChunkSize > 0) {
+    // leave the content for ScanBlockScalarChunks
+    m_pDeferredScalar = &token;
+    m_deferredParams = params;
+  } else {
+    ScanScalar(INPUT, params, token.value);
+  }
 
   // simple keys always ok after block scalars (since we're gonna start a new
   // line anyways)
   m_simpleKeyAllowed = true;
   m_canBeJSONFlow = false;
 
-  Token token(Token::NON_PLAIN_SCALAR, mark);
-  token.value = scalar;
-  m_tokens.push(token);
+  m_tokens.commit();
 }
 }  // namespace YAML
@@ -8,92 +8,94 @@
 #endif
 
 #include "yaml-cpp/noexcept.h"
-#include <memory>
-#include <utility>
+#include <cstddef>
+#include <type_traits>
 #include <vector>
 
 namespace YAML {
 
-class SettingChangeBase {
- public:
-  virtual ~SettingChangeBase() = default;
-  virtual void pop() = 0;
-};
-
 template <typename T>
 class Setting {
  public:
+  // Every emitter setting is an enum or an integer, which lets a change be
+  // recorded by value (see SettingChange) instead of through a heap node.
+  static_assert(std::is_integral<T>::value || std::is_enum<T>::value,
+                "settings must be integral or enum types");
+  static_assert(sizeof(T) <= sizeof(std::size_t),
+                "settings must fit in a std::size_t");
+
   Setting() : m_value() {}
-  Setting(const T& value) : m_value() { set(value); }
+  Setting(const T& value) : m_value(value) {}
 
   const T get() const { return m_value; }
-  std::unique_ptr<SettingChangeBase> set(const T& value);
-  void restore(const Setting<T>& oldSetting) { m_value = oldSetting.get(); }
+  void set(const T& value) { m_value = value; }
 
  private:
   T m_value;
 };
 
-template <typename T>
-class SettingChange : public SettingChangeBase {
+// SettingChange
+// . Records the value a setting had before it was changed, so the change can
+//   be undone later.
+// . It's a trivially copyable value type; the setting's type is recovered
+//   through a per-type restore function.
+class SettingChange {
  public:
-  SettingChange(Setting<T>* pSetting)
-      : m_pCurSetting(pSetting),
-        m_oldSetting(*pSetting)  // copy old setting to save its state
-  {}
-  SettingChange(const SettingChange&) = delete;
-  SettingChange(SettingChange&&) = delete;
-  SettingChange& operator=(const SettingChange&) = delete;
-  SettingChange& operator=(SettingChange&&) = delete;
+  template <typename T>
+  explicit SettingChange(Setting<T>* pSetting)
+      : m_pSetting(pSetting),
+        m_oldValue(static_cast<std::size_t>(pSetting->get())),
+        m_restore(&Restore<T>) {}
 
-  void pop() override { m_pCurSetting->restore(m_oldSetting); }
+  void pop() const { m_restore(m_pSetting, m_oldValue); }
 
  private:
-  Setting<T>* m_pCurSetting;
-  Setting<T> m_oldSetting;
-};
+  template <typename T>
+  static void Restore(void* pSetting, std::size_t oldValue) {
+    static_cast<Setting<T>*>(pSetting)->set(static_cast<T>(oldValue));
+  }
 
-template <typename T>
-inline std::unique_ptr<SettingChangeBase> Setting<T>::set(const T& value) {
-  std::unique_ptr<SettingChangeBase> pChange(new SettingChange<T>(this));
-  m_value = value;
-  return pChange;
-}
+  void* m_pSetting;
+  std::size_t m_oldValue;
+  void (*m_restore)(void*, std::size_t);
+};
 
+// SettingChanges
+// . A flat log of setting changes. Storage is kept when the log is unwound,
+//   so steady-state use doesn't allocate.
 class SettingChanges {
  public:
   SettingChanges() : m_settingChanges{} {}
   SettingChanges(const SettingChanges&) = delete;
   SettingChanges(SettingChanges&&) YAML_CPP_NOEXCEPT = default;
   SettingChanges& operator=(const SettingChanges&) = delete;
-  SettingChanges& operator=(SettingChanges&& rhs) YAML_CPP_NOEXCEPT {
-    if (this == &rhs)
-      return *this;
+  SettingChanges& operator=(SettingChanges&&) YAML_CPP_NOEXCEPT = default;
+  ~SettingChanges() = default;
 
-    clear();
-    std::swap(m_settingChanges, rhs.m_settingChanges);
-
-    return *this;
-  }
-  ~SettingChanges() { clear(); }
+  std::size_t size() const { return m_settingChanges.size(); }
 
-  void clear() YAML_CPP_NOEXCEPT {
-    restore();
-    m_settingChanges.clear();
+  template <typename T>
+  void push(Setting<T>& setting) {
+    m_settingChanges.push_back(SettingChange(&setting));
   }
 
-  void restore() YAML_CPP_NOEXCEPT {
-    for (const auto& setting : m_settingChanges)
-      setting->pop();
+  // undoes (newest first) every change made since the log had size 'mark',
+  // and drops them from the log
+  void unwind(std::size_t mark) YAML_CPP_NOEXCEPT {
+    while (m_settingChanges.size() > mark) {
+      m_settingChanges.back().pop();
+      m_settingChanges.pop_back();
+    }
   }
 
-  void push(std::unique_ptr<SettingChangeBase> pSettingChange) {
-    m_settingChanges.push_back(std::move(pSettingChange));
+  // re-applies every recorded value, oldest first
+  void replay() const YAML_CPP_NOEXCEPT {
+    for (const SettingChange& change : m_settingChanges)
+      change.pop();
   }
 
  private:
-  using setting_changes = std::vector<std::unique_ptr<SettingChangeBase>>;
-  setting_changes m_settingChanges;
+  std::vector<SettingChange> m_settingChanges;
 };
 }  // namespace YAML
 
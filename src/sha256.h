@@ -0,0 +1,24 @@
+#ifndef SHA256_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+#define SHA256_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+
+#if defined(_MSC_VER) ||                                            \
+    (defined(__GNUC__) && (__GNUC__ == 3 && __GNUC_MINOR__ >= 4) || \
+     (__GNUC__ >= 4))  // GCC supports "pragma once" correctly since 3.4
+#pragma once
+#endif
+
+#include <array>
+#include <cstddef>
+#include <string>
+
+namespace YAML {
+using Sha256Digest = std::array<unsigned char, 32>;
+
+// The SHA-256 digest (FIPS 180-4) of the 'size' bytes at 'data'.
+Sha256Digest Sha256(const char* data, std::size_t size);
+
+// The digest in lowercase hex, as sha256sum writes it.
+std::string ToHex(const Sha256Digest& digest);
+}  // namespace YAML
+
+#endif  // SHA256_H_62B23520_7C8E_11DE_8A39_0800200C9A66
@@ -7,25 +7,22 @@ struct Mark;
 Scanner::SimpleKey::SimpleKey(const Mark& mark_, std::size_t flowLevel_)
     : mark(mark_),
       flowLevel(flowLevel_),
-      pIndent(nullptr),
+      indent(0),
       pMapStart(nullptr),
       pKey(nullptr) {}
 
-void Scanner::SimpleKey::Validate() {
-  // Note: pIndent will *not* be garbage here;
-  //       we "garbage collect" them so we can
-  //       always refer to them
-  if (pIndent)
-    pIndent->status = IndentMarker::VALID;
+void Scanner::SimpleKey::Validate(std::vector<IndentMarker>& indents) {
+  if (indent > 0 && indent < indents.size())
+    indents[indent].status = IndentMarker::VALID;
   if (pMapStart)
     pMapStart->status = Token::VALID;
   if (pKey)
     pKey->status = Token::VALID;
 }
 
-void Scanner::SimpleKey::Invalidate() {
-  if (pIndent)
-    pIndent->status = IndentMarker::INVALID;
+void Scanner::SimpleKey::Invalidate(std::vector<IndentMarker>& indents) {
+  if (indent > 0 && indent < indents.size())
+    indents[indent].status = IndentMarker::INVALID;
   if (pMapStart)
     pMapStart->status = Token::INVALID;
   if (pKey)
@@ -48,7 +45,7 @@ bool Scanner::ExistsActiveSimpleKey() const {
   if (m_simpleKeys.empty())
     return false;
 
-  const SimpleKey& key = m_simpleKeys.top();
+  const SimpleKey& key = m_simpleKeys.back();
   return key.flowLevel == GetFlowLevel();
 }
 
@@ -63,20 +60,20 @@ void Scanner::InsertPotentialSimpleKey() {
 
   // first add a map start, if necessary
   if (InBlockContext()) {
-    key.pIndent = PushIndentTo(INPUT.column(), IndentMarker::MAP);
-    if (key.pIndent) {
-      key.pIndent->status = IndentMarker::UNKNOWN;
-      key.pMapStart = key.pIndent->pStartToken;
+    IndentMarker* pIndent = PushIndentTo(INPUT.column(), IndentMarker::MAP);
+    if (pIndent) {
+      pIndent->status = IndentMarker::UNKNOWN;
+      key.indent = m_indents.size() - 1;
+      key.pMapStart = pIndent->pStartToken;
       key.pMapStart->status = Token::UNVERIFIED;
     }
   }
 
   // then add the (now unverified) key
-  m_tokens.push(Token(Token::KEY, INPUT.mark()));
-  key.pKey = &m_tokens.back();
+  key.pKey = &m_tokens.push(Token::KEY, INPUT.mark());
   key.pKey->status = Token::UNVERIFIED;
 
-  m_simpleKeys.push(key);
+  m_simpleKeys.push_back(key);
 }
 
 // InvalidateSimpleKey
@@ -86,12 +83,12 @@ void Scanner::InvalidateSimpleKey() {
     return;
 
   // grab top key
-  SimpleKey& key = m_simpleKeys.top();
+  SimpleKey& key = m_simpleKeys.back();
   if (key.flowLevel != GetFlowLevel())
     return;
 
-  key.Invalidate();
-  m_simpleKeys.pop();
+  key.Invalidate(m_indents);
+  m_simpleKeys.pop_back();
 }
 
 // VerifySimpleKey
@@ -102,13 +99,13 @@ bool Scanner::VerifySimpleKey() {
     return false;
 
   // grab top key
-  SimpleKey key = m_simpleKeys.top();
+  SimpleKey key = m_simpleKeys.back();
 
   // only validate if we're in the correct flow level
   if (key.flowLevel != GetFlowLevel())
     return false;
 
-  m_simpleKeys.pop();
+  m_simpleKeys.pop_back();
 
   bool isValid = true;
 
@@ -118,15 +115,14 @@ bool Scanner::VerifySimpleKey() {
 
   // invalidate key
   if (isValid)
-    key.Validate();
+    key.Validate(m_indents);
   else
-    key.Invalidate();
+    key.Invalidate(m_indents);
 
   return isValid;
 }
 
 void Scanner::PopAllSimpleKeys() {
-  while (!m_simpleKeys.empty())
-    m_simpleKeys.pop();
+  m_simpleKeys.clear();
 }
 }  // namespace YAML
@@ -1,11 +1,15 @@
 #include <algorithm>
 #include <cstdio>
 #include <sstream>
+#include <utility>
 
 #include "collectionstack.h"  // IWYU pragma: keep
+#include "nodebuilder.h"
 #include "scanner.h"
+#include "scanscalar.h"
 #include "singledocparser.h"
 #include "tag.h"
+#include "tapebuilder.h"
 #include "token.h"
 #include "yaml-cpp/depthguard.h"
 #include "yaml-cpp/emitterstyle.h"
@@ -13,8 +17,23 @@
 #include "yaml-cpp/exceptions.h"  // IWYU pragma: keep
 #include "yaml-cpp/mark.h"
 #include "yaml-cpp/null.h"
+#include "yaml-cpp/nulleventhandler.h"
 
 namespace YAML {
+namespace {
+template <typename Handler>
+class ScalarChunkForwarder : public ScalarChunkSink {
+ public:
+  explicit ScalarChunkForwarder(Handler& handler) : m_handler(handler) {}
+  void OnChunk(const char* data, std::size_t size) override {
+    m_handler.OnScalarChunk(data, size);
+  }
+
+ private:
+  Handler& m_handler;
+};
+}  // namespace
+
 SingleDocParser::SingleDocParser(Scanner& scanner, const Directives& directives)
     : m_scanner(scanner),
       m_directives(directives),
@@ -27,7 +46,8 @@ SingleDocParser::~SingleDocParser() = default;
 // HandleDocument
 // . Handles the next document
 // . Throws a ParserException on error.
-void SingleDocParser::HandleDocument(EventHandler& eventHandler) {
+template <typename Handler>
+void SingleDocParser::HandleDocument(Handler& eventHandler) {
   assert(!m_scanner.empty());  // guaranteed that there are tokens
   assert(!m_curAnchor);
 
@@ -47,7 +67,8 @@ void SingleDocParser::HandleDocument(EventHandler& eventHandler) {
     m_scanner.pop();
 }
 
-void SingleDocParser::HandleNode(EventHandler& eventHandler) {
+template <typename Handler>
+void SingleDocParser::HandleNode(Handler& eventHandler) {
   DepthGuard<500> depthguard(depth, m_scanner.mark(), ErrorMsg::BAD_FILE);
 
   // an empty node *is* a possibility
@@ -88,7 +109,7 @@ void SingleDocParser::HandleNode(EventHandler& eventHandler) {
     return;
   }
 
-  const Token& token = m_scanner.peek();
+  Token& token = m_scanner.peek();
 
   // add non-specific tags
   if (tag.empty())
@@ -101,11 +122,25 @@ void SingleDocParser::HandleNode(EventHandler& eventHandler) {
     return;
   }
 
+  // a block scalar goes in pieces, if the handler asked for them
+  if (token.type == Token::NON_PLAIN_SCALAR &&
+      token.data == Token::BLOCK_SCALAR &&
+      m_scanner.GetBlockScalarChunkSize() > 0) {
+    eventHandler.OnScalarStart(mark, tag, anchor);
+    ScalarChunkForwarder<Handler> sink(eventHandler);
+    m_scanner.ScanBlockScalarChunks(sink);
+    eventHandler.OnScalarEnd();
+    m_scanner.pop();
+    return;
+  }
+
   // now split based on what kind of node we should be
   switch (token.type) {
     case Token::PLAIN_SCALAR:
     case Token::NON_PLAIN_SCALAR:
-      eventHandler.OnScalar(mark, tag, anchor, token.value);
+      // (the token is popped right after, so its value can be handed over)
+      eventHandler.OnOwnedScalar(mark, std::move(tag), anchor,
+                                 std::move(token.value));
       m_scanner.pop();
       return;
     case Token::FLOW_SEQ_START:
@@ -145,10 +180,11 @@ void SingleDocParser::HandleNode(EventHandler& eventHandler) {
   if (tag == "?")
     eventHandler.OnNull(mark, anchor);
   else
-    eventHandler.OnScalar(mark, tag, anchor, "");
+    eventHandler.OnOwnedScalar(mark, std::move(tag), anchor, std::string());
 }
 
-void SingleDocParser::HandleSequence(EventHandler& eventHandler) {
+template <typename Handler>
+void SingleDocParser::HandleSequence(Handler& eventHandler) {
   // split based on start token
   switch (m_scanner.peek().type) {
     case Token::BLOCK_SEQ_START:
@@ -162,7 +198,8 @@ void SingleDocParser::HandleSequence(EventHandler& eventHandler) {
   }
 }
 
-void SingleDocParser::HandleBlockSequence(EventHandler& eventHandler) {
+template <typename Handler>
+void SingleDocParser::HandleBlockSequence(Handler& eventHandler) {
   // eat start token
   m_scanner.pop();
   m_pCollectionStack->PushCollectionType(CollectionType::BlockSeq);
@@ -171,12 +208,13 @@ void SingleDocParser::HandleBlockSequence(EventHandler& eventHandler) {
     if (m_scanner.empty())
       throw ParserException(m_scanner.mark(), ErrorMsg::END_OF_SEQ);
 
-    Token token = m_scanner.peek();
-    if (token.type != Token::BLOCK_ENTRY && token.type != Token::BLOCK_SEQ_END)
-      throw ParserException(token.mark, ErrorMsg::END_OF_SEQ);
+    // (the token's slot may be reused once it's popped, so we keep its type)
+    const Token::TYPE type = m_scanner.peek().type;
+    if (type != Token::BLOCK_ENTRY && type != Token::BLOCK_SEQ_END)
+      throw ParserException(m_scanner.peek().mark, ErrorMsg::END_OF_SEQ);
 
     m_scanner.pop();
-    if (token.type == Token::BLOCK_SEQ_END)
+    if (type == Token::BLOCK_SEQ_END)
       break;
 
     // check for null
@@ -195,7 +233,8 @@ void SingleDocParser::HandleBlockSequence(EventHandler& eventHandler) {
   m_pCollectionStack->PopCollectionType(CollectionType::BlockSeq);
 }
 
-void SingleDocParser::HandleFlowSequence(EventHandler& eventHandler) {
+template <typename Handler>
+void SingleDocParser::HandleFlowSequence(Handler& eventHandler) {
   // eat start token
   m_scanner.pop();
   m_pCollectionStack->PushCollectionType(CollectionType::FlowSeq);
@@ -228,7 +267,8 @@ void SingleDocParser::HandleFlowSequence(EventHandler& eventHandler) {
   m_pCollectionStack->PopCollectionType(CollectionType::FlowSeq);
 }
 
-void SingleDocParser::HandleMap(EventHandler& eventHandler) {
+template <typename Handler>
+void SingleDocParser::HandleMap(Handler& eventHandler) {
   // split based on start token
   switch (m_scanner.peek().type) {
     case Token::BLOCK_MAP_START:
@@ -248,7 +288,8 @@ void SingleDocParser::HandleMap(EventHandler& eventHandler) {
   }
 }
 
-void SingleDocParser::HandleBlockMap(EventHandler& eventHandler) {
+template <typename Handler>
+void SingleDocParser::HandleBlockMap(Handler& eventHandler) {
   // eat start token
   m_scanner.pop();
   m_pCollectionStack->PushCollectionType(CollectionType::BlockMap);
@@ -257,22 +298,24 @@ void SingleDocParser::HandleBlockMap(EventHandler& eventHandler) {
     if (m_scanner.empty())
       throw ParserException(m_scanner.mark(), ErrorMsg::END_OF_MAP);
 
-    Token token = m_scanner.peek();
-    if (token.type != Token::KEY && token.type != Token::VALUE &&
-        token.type != Token::BLOCK_MAP_END)
-      throw ParserException(token.mark, ErrorMsg::END_OF_MAP);
+    Token& token = m_scanner.peek();
+    const Token::TYPE type = token.type;
+    const Mark mark = token.mark;
+    if (type != Token::KEY && type != Token::VALUE &&
+        type != Token::BLOCK_MAP_END)
+      throw ParserException(mark, ErrorMsg::END_OF_MAP);
 
-    if (token.type == Token::BLOCK_MAP_END) {
+    if (type == Token::BLOCK_MAP_END) {
       m_scanner.pop();
       break;
     }
 
     // grab key (if non-null)
-    if (token.type == Token::KEY) {
+    if (type == Token::KEY) {
       m_scanner.pop();
       HandleNode(eventHandler);
     } else {
-      eventHandler.OnNull(token.mark, NullAnchor);
+      eventHandler.OnNull(mark, NullAnchor);
     }
 
     // now grab value (optional)
@@ -280,14 +323,15 @@ void SingleDocParser::HandleBlockMap(EventHandler& eventHandler) {
       m_scanner.pop();
       HandleNode(eventHandler);
     } else {
-      eventHandler.OnNull(token.mark, NullAnchor);
+      eventHandler.OnNull(mark, NullAnchor);
     }
   }
 
   m_pCollectionStack->PopCollectionType(CollectionType::BlockMap);
 }
 
-void SingleDocParser::HandleFlowMap(EventHandler& eventHandler) {
+template <typename Handler>
+void SingleDocParser::HandleFlowMap(Handler& eventHandler) {
   // eat start token
   m_scanner.pop();
   m_pCollectionStack->PushCollectionType(CollectionType::FlowMap);
@@ -336,7 +380,8 @@ void SingleDocParser::HandleFlowMap(EventHandler& eventHandler) {
 }
 
 // . Single "key: value" pair in a flow sequence
-void SingleDocParser::HandleCompactMap(EventHandler& eventHandler) {
+template <typename Handler>
+void SingleDocParser::HandleCompactMap(Handler& eventHandler) {
   m_pCollectionStack->PushCollectionType(CollectionType::CompactMap);
 
   // grab key
@@ -356,7 +401,8 @@ void SingleDocParser::HandleCompactMap(EventHandler& eventHandler) {
 }
 
 // . Single ": value" pair in a flow sequence
-void SingleDocParser::HandleCompactMapWithNoKey(EventHandler& eventHandler) {
+template <typename Handler>
+void SingleDocParser::HandleCompactMapWithNoKey(Handler& eventHandler) {
   m_pCollectionStack->PushCollectionType(CollectionType::CompactMap);
 
   // null key
@@ -429,4 +475,9 @@ anchor_t SingleDocParser::LookupAnchor(const Mark& mark,
 
   return it->second;
 }
+
+template void SingleDocParser::HandleDocument(EventHandler& eventHandler);
+template void SingleDocParser::HandleDocument(NodeBuilder& eventHandler);
+template void SingleDocParser::HandleDocument(NullEventHandler& eventHandler);
+template void SingleDocParser::HandleDocument(TapeBuilder& eventHandler);
 }  // namespace YAML
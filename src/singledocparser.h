@@ -32,20 +32,35 @@ class SingleDocParser {
   SingleDocParser& operator=(SingleDocParser&&) = delete;
   ~SingleDocParser();
 
-  void HandleDocument(EventHandler& eventHandler);
+  // HandleDocument
+  // . Instantiated (in singledocparser.cpp) for each handler type the library
+  //   parses with: EventHandler, which calls through its virtual methods, and
+  //   the final handlers NodeBuilder and NullEventHandler, which are called
+  //   directly.
+  template <typename Handler>
+  void HandleDocument(Handler& eventHandler);
 
  private:
-  void HandleNode(EventHandler& eventHandler);
+  template <typename Handler>
+  void HandleNode(Handler& eventHandler);
 
-  void HandleSequence(EventHandler& eventHandler);
-  void HandleBlockSequence(EventHandler& eventHandler);
-  void HandleFlowSequence(EventHandler& eventHandler);
+  template <typename Handler>
+  void HandleSequence(Handler& eventHandler);
+  template <typename Handler>
+  void HandleBlockSequence(Handler& eventHandler);
+  template <typename Handler>
+  void HandleFlowSequence(Handler& eventHandler);
 
-  void HandleMap(EventHandler& eventHandler);
-  void HandleBlockMap(EventHandler& eventHandler);
-  void HandleFlowMap(EventHandler& eventHandler);
-  void HandleCompactMap(EventHandler& eventHandler);
-  void HandleCompactMapWithNoKey(EventHandler& eventHandler);
+  template <typename Handler>
+  void HandleMap(Handler& eventHandler);
+  template <typename Handler>
+  void HandleBlockMap(Handler& eventHandler);
+  template <typename Handler>
+  void HandleFlowMap(Handler& eventHandler);
+  template <typename Handler>
+  void HandleCompactMap(Handler& eventHandler);
+  template <typename Handler>
+  void HandleCompactMapWithNoKey(Handler& eventHandler);
 
   void ParseProperties(std::string& tag, anchor_t& anchor,
                        std::string& anchor_name);
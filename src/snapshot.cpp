@@ -0,0 +1,503 @@
+#include "yaml-cpp/snapshot.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <istream>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <ostream>
+#include <sstream>
+#include <vector>
+
+#include "memorybuf.h"
+#include "sha256.h"
+#include "snapshotcache.h"
+#include "yaml-cpp/emitterstyle.h"
+#include "yaml-cpp/exceptions.h"
+#include "yaml-cpp/node/node.h"
+#include "yaml-cpp/node/type.h"
+
+namespace YAML {
+// TapeSnapshot
+// . Gets at a Tape's data, for reading and writing snapshots of it.
+class TapeSnapshot {
+ public:
+  static const detail::tape_data* Data(const Tape& tape) {
+    return tape.m_pData.get();
+  }
+  static Tape Make(std::shared_ptr<const detail::tape_data> pData) {
+    return Tape(std::move(pData));
+  }
+};
+
+namespace {
+// A snapshot is a header and then the payload, with every number in it
+// little-endian:
+// . The header is kMagic, then the version and flags (32 bits each), then
+//   the key (32 bytes), then the size of the source, the number of entries,
+//   the size of the arena, the number of tags, the size of the payload, and
+//   its checksum (64 bits each).
+// . The payload is the entries (kEntrySize bytes each, and kMarkSize more
+//   with kWithMarks), then the arena as is, then the tags (each its size, in
+//   32 bits, and its bytes), and then, with kWithMarks, the lines (kLineSize
+//   bytes each) to the end.
+// The key and the size of the source are for the cache, to tell which file a
+// snapshot is of (the key is the SHA-256 digest of its contents); they're 0
+// otherwise.
+const char kMagic[8] = {'Y', 'A', 'M', 'L', 'T', 'A', 'P', 'E'};
+const std::uint32_t kVersion = 3;
+const std::uint32_t kWithMarks = 1;
+const std::size_t kHeaderSize = 8 + 2 * 4 + 32 + 6 * 8;
+const std::size_t kEntrySize = 28;
+const std::size_t kMarkSize = 4;
+const std::size_t kLineSize = 8;
+
+struct SnapshotHeader {
+  std::uint32_t version;
+  std::uint32_t flags;
+  Sha256Digest key;
+  std::uint64_t sourceSize;
+  std::uint64_t entries;
+  std::uint64_t arenaSize;
+  std::uint64_t tags;
+  std::uint64_t payloadSize;
+  std::uint64_t checksum;
+};
+
+// FNV-1a, continuing from 'hash' (for the checksum, which is only there to
+// catch damage).
+const std::uint64_t kHashStart = 14695981039346656037ull;
+
+std::uint64_t Hash(std::uint64_t hash, const char* data, std::size_t size) {
+  for (std::size_t i = 0; i < size; i++) {
+    hash ^= static_cast<unsigned char>(data[i]);
+    hash *= 1099511628211ull;
+  }
+  return hash;
+}
+
+void Put32(std::string& out, std::uint32_t value) {
+  for (int i = 0; i < 4; i++)
+    out.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+}
+
+void Put64(std::string& out, std::uint64_t value) {
+  for (int i = 0; i < 8; i++)
+    out.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+}
+
+std::uint32_t Get32(const char* p) {
+  std::uint32_t value = 0;
+  for (int i = 3; i >= 0; i--)
+    value = (value << 8) | static_cast<unsigned char>(p[i]);
+  return value;
+}
+
+std::uint64_t Get64(const char* p) {
+  std::uint64_t value = 0;
+  for (int i = 7; i >= 0; i--)
+    value = (value << 8) | static_cast<unsigned char>(p[i]);
+  return value;
+}
+
+void Write(const detail::tape_data* pData, std::ostream& output,
+           bool withMarks, const Sha256Digest& key,
+           std::uint64_t sourceSize) {
+  static const detail::tape_data empty;
+  const detail::tape_data& data = pData ? *pData : empty;
+
+  std::string payload;
+  payload.reserve(data.entries.size() *
+                      (kEntrySize + (withMarks ? kMarkSize : 0)) +
+                  data.arena.size() +
+                  (withMarks ? data.lines.size() * kLineSize : 0));
+  for (const detail::tape_entry& entry : data.entries) {
+    payload.push_back(static_cast<char>(entry.type));
+    payload.push_back(static_cast<char>(entry.style));
+    payload.push_back(entry.anchored ? 1 : 0);
+    payload.push_back(0);
+    Put32(payload, entry.tag);
+    Put32(payload, entry.size);
+    Put32(payload, entry.skip);
+    Put64(payload, entry.value);
+    Put32(payload, entry.length);
+    if (withMarks)
+      Put32(payload, entry.pos);
+  }
+  payload += data.arena;
+  for (const std::string& tag : data.tags) {
+    Put32(payload, static_cast<std::uint32_t>(tag.size()));
+    payload += tag;
+  }
+  if (withMarks) {
+    for (const detail::tape_line& line : data.lines) {
+      Put32(payload, line.start);
+      Put32(payload, line.line);
+    }
+  }
+
+  std::string header(kMagic, sizeof(kMagic));
+  Put32(header, kVersion);
+  Put32(header, withMarks ? kWithMarks : 0);
+  header.append(reinterpret_cast<const char*>(key.data()), key.size());
+  Put64(header, sourceSize);
+  Put64(header, data.entries.size());
+  Put64(header, data.arena.size());
+  Put64(header, data.tags.size());
+  Put64(header, payload.size());
+  Put64(header, Hash(kHashStart, payload.data(), payload.size()));
+
+  output.write(header.data(), static_cast<std::streamsize>(header.size()));
+  output.write(payload.data(), static_cast<std::streamsize>(payload.size()));
+}
+
+void ReadExactly(std::istream& input, char* data, std::size_t size) {
+  input.read(data, static_cast<std::streamsize>(size));
+  if (static_cast<std::size_t>(input.gcount()) != size)
+    throw BadSnapshot("it is truncated");
+}
+
+// ReadInto
+// . Reads 'size' bytes into 'out' a block at a time, so that a damaged size
+//   runs out of input before it can allocate much more than there is.
+void ReadInto(std::istream& input, std::string& out, std::uint64_t size) {
+  const std::size_t kBlockSize = 1 << 20;
+  out.clear();
+  while (size > 0) {
+    const std::size_t block =
+        static_cast<std::size_t>(std::min<std::uint64_t>(size, kBlockSize));
+    const std::size_t pos = out.size();
+    out.resize(pos + block);
+    ReadExactly(input, &out[pos], block);
+    size -= block;
+  }
+}
+
+SnapshotHeader ReadHeader(std::istream& input) {
+  char buffer[kHeaderSize];
+  ReadExactly(input, buffer, kHeaderSize);
+  if (std::memcmp(buffer, kMagic, sizeof(kMagic)) != 0)
+    throw BadSnapshot("it is not a snapshot");
+
+  const char* p = buffer + sizeof(kMagic);
+  SnapshotHeader header;
+  header.version = Get32(p);
+  header.flags = Get32(p + 4);
+  p += 8;
+  std::memcpy(header.key.data(), p, header.key.size());
+  p += header.key.size();
+  header.sourceSize = Get64(p);
+  header.entries = Get64(p + 8);
+  header.arenaSize = Get64(p + 16);
+  header.tags = Get64(p + 24);
+  header.payloadSize = Get64(p + 32);
+  header.checksum = Get64(p + 40);
+
+  if (header.version != kVersion)
+    throw BadSnapshot("it is of version " + std::to_string(header.version) +
+                      ", not " + std::to_string(kVersion));
+  if ((header.flags & ~kWithMarks) != 0)
+    throw BadSnapshot("it has unknown flags");
+  return header;
+}
+
+// Validate
+// . Checks that the entries make a tape that TapeNode can walk without going
+//   out of bounds: that each subtree holds exactly its children, that
+//   scalars are in the arena, and that links go back to anchored entries;
+//   and that the lines are in order, with each mark on one of them.
+bool Validate(const detail::tape_data& data) {
+  const std::vector<detail::tape_line>& lines = data.lines;
+  for (std::size_t i = 1; i < lines.size(); i++) {
+    if (lines[i].start <= lines[i - 1].start)
+      return false;
+  }
+
+  const std::vector<detail::tape_entry>& entries = data.entries;
+  const std::size_t count = entries.size();
+  if (count == 0)
+    return true;
+  if (entries[0].skip != count)
+    return false;
+
+  std::size_t children = 0;
+  for (std::size_t i = 0; i < count; i++) {
+    const detail::tape_entry& entry = entries[i];
+    if (entry.tag >= data.tags.size() || entry.skip == 0 ||
+        entry.skip > count - i || entry.style > EmitterStyle::Flow)
+      return false;
+    if (entry.pos != detail::tape_entry::NO_POS &&
+        (lines.empty() || entry.pos < lines.front().start))
+      return false;
+
+    switch (entry.type) {
+      case NodeType::Null:
+        if (entry.skip != 1)
+          return false;
+        break;
+      case NodeType::Scalar:
+        if (entry.skip != 1 || entry.value >= data.arena.size() ||
+            entry.length >= data.arena.size() - entry.value ||
+            data.arena[entry.value + entry.length] != '\0')
+          return false;
+        break;
+      case NodeType::Sequence:
+      case NodeType::Map: {
+        const std::size_t end = i + entry.skip;
+        const std::size_t size =
+            entry.type == NodeType::Map ? 2 * std::size_t(entry.size)
+                                        : entry.size;
+        std::size_t child = i + 1;
+        for (std::size_t n = 0; n < size; n++) {
+          // (a valid tape has each entry but the root as a child once)
+          if (child >= end || ++children >= count)
+            return false;
+          child += entries[child].skip;
+        }
+        if (child != end)
+          return false;
+        break;
+      }
+      case detail::tape_entry::LINK:
+        if (entry.skip != 1 || entry.size >= i ||
+            entries[entry.size].type == detail::tape_entry::LINK ||
+            !entries[entry.size].anchored)
+          return false;
+        break;
+      default:
+        return false;
+    }
+  }
+  return true;
+}
+
+std::shared_ptr<const detail::tape_data> Read(std::istream& input,
+                                              SnapshotHeader& header) {
+  header = ReadHeader(input);
+
+  // the sizes are checked against the payload's before anything is allocated
+  const std::size_t entrySize =
+      kEntrySize + ((header.flags & kWithMarks) ? kMarkSize : 0);
+  if (header.entries > std::numeric_limits<std::uint32_t>::max() ||
+      header.entries > header.payloadSize / entrySize ||
+      header.arenaSize > header.payloadSize - header.entries * entrySize ||
+      header.tags > (header.payloadSize - header.entries * entrySize -
+                     header.arenaSize) /
+                        4)
+    throw BadSnapshot("it is damaged");
+  const std::uint64_t entryBytes = header.entries * entrySize;
+  // (the tags, and then the lines)
+  const std::uint64_t tailBytes =
+      header.payloadSize - entryBytes - header.arenaSize;
+
+  std::shared_ptr<detail::tape_data> pData =
+      std::make_shared<detail::tape_data>();
+  std::string buffer;
+  ReadInto(input, buffer, entryBytes);
+  std::uint64_t checksum = Hash(kHashStart, buffer.data(), buffer.size());
+
+  pData->entries.reserve(static_cast<std::size_t>(header.entries));
+  for (const char* p = buffer.data(); p != buffer.data() + buffer.size();
+       p += entrySize) {
+    const std::uint32_t pos = (header.flags & kWithMarks)
+                                  ? Get32(p + kEntrySize)
+                                  : std::uint32_t(detail::tape_entry::NO_POS);
+    pData->entries.emplace_back(static_cast<unsigned char>(p[0]), pos);
+    detail::tape_entry& entry = pData->entries.back();
+    entry.style = static_cast<unsigned char>(p[1]);
+    entry.anchored = p[2] != 0;
+    entry.tag = Get32(p + 4);
+    entry.size = Get32(p + 8);
+    entry.skip = Get32(p + 12);
+    entry.value = static_cast<std::size_t>(Get64(p + 16));
+    entry.length = Get32(p + 24);
+  }
+
+  std::string& arena = pData->arena;
+  ReadInto(input, arena, header.arenaSize);
+  checksum = Hash(checksum, arena.data(), arena.size());
+
+  ReadInto(input, buffer, tailBytes);
+  checksum = Hash(checksum, buffer.data(), buffer.size());
+  if (checksum != header.checksum)
+    throw BadSnapshot("its checksum doesn't match");
+
+  std::size_t pos = 0;
+  for (std::uint64_t i = 0; i < header.tags; i++) {
+    if (buffer.size() - pos < 4)
+      throw BadSnapshot("it is damaged");
+    const std::size_t size = Get32(buffer.data() + pos);
+    pos += 4;
+    if (buffer.size() - pos < size)
+      throw BadSnapshot("it is damaged");
+    pData->tags.emplace_back(buffer, pos, size);
+    pos += size;
+  }
+  if ((buffer.size() - pos) % kLineSize != 0 ||
+      (!(header.flags & kWithMarks) && pos != buffer.size()))
+    throw BadSnapshot("it is damaged");
+  pData->lines.reserve((buffer.size() - pos) / kLineSize);
+  for (; pos != buffer.size(); pos += kLineSize) {
+    const detail::tape_line line = {Get32(buffer.data() + pos),
+                                    Get32(buffer.data() + pos + 4)};
+    pData->lines.push_back(line);
+  }
+  if (!Validate(*pData))
+    throw BadSnapshot("it is damaged");
+
+  if (pData->entries.empty())
+    return nullptr;
+  return pData;
+}
+
+std::mutex& CacheMutex() {
+  static std::mutex mutex;
+  return mutex;
+}
+
+// (LoadFile reads the directory without locking: each one set is kept for
+// good, since a reader may still have it, and only the pointer changes)
+std::atomic<const std::string*>& CacheDirectory() {
+  static std::atomic<const std::string*> directory(nullptr);
+  return directory;
+}
+
+std::vector<std::unique_ptr<const std::string>>& CacheDirectories() {
+  static std::vector<std::unique_ptr<const std::string>> directories;
+  return directories;
+}
+
+// TemporaryName
+// . A name next to 'filename' that no other writer uses: a random number
+//   for this process, and a count of the names it's made.
+std::string TemporaryName(const std::string& filename) {
+  static const std::uint64_t process =
+      (std::uint64_t(std::random_device()()) << 32) ^
+      std::uint64_t(
+          std::chrono::steady_clock::now().time_since_epoch().count());
+  static std::atomic<std::uint64_t> count(0);
+  std::ostringstream name;
+  name << filename << ".tmp." << std::hex << process << "." << count++;
+  return name.str();
+}
+
+// WriteCacheFile
+// . Writes the snapshot to a temporary file of its own, and then moves it
+//   into place, so that another process never reads a partial one (and two
+//   writers of the same file don't write into each other's).
+void WriteCacheFile(const Tape& tape, const std::string& filename,
+                    const Sha256Digest& key, std::uint64_t sourceSize) {
+  const std::string temporary = TemporaryName(filename);
+  {
+    std::ofstream fout(temporary, std::ios::binary);
+    if (!fout)
+      return;
+    Write(TapeSnapshot::Data(tape), fout, true, key, sourceSize);
+    if (!fout) {
+      fout.close();
+      std::remove(temporary.c_str());
+      return;
+    }
+  }
+
+  if (std::rename(temporary.c_str(), filename.c_str()) != 0) {
+    // (which it does on Windows if there's already a file there)
+    std::remove(filename.c_str());
+    if (std::rename(temporary.c_str(), filename.c_str()) != 0)
+      std::remove(temporary.c_str());
+  }
+}
+}  // namespace
+
+void SaveSnapshot(const Tape& tape, std::ostream& output, bool withMarks) {
+  Write(TapeSnapshot::Data(tape), output, withMarks, Sha256Digest(), 0);
+}
+
+void SaveSnapshotFile(const Tape& tape, const std::string& filename,
+                      bool withMarks) {
+  std::ofstream fout(filename, std::ios::binary);
+  if (!fout) {
+    throw BadFile(filename);
+  }
+  SaveSnapshot(tape, fout, withMarks);
+  if (!fout) {
+    throw BadFile(filename);
+  }
+}
+
+Tape LoadSnapshot(std::istream& input) {
+  SnapshotHeader header;
+  return TapeSnapshot::Make(Read(input, header));
+}
+
+Tape LoadSnapshot(const char* data, std::size_t size) {
+  MemoryBuf buffer(data, size);
+  std::istream stream(&buffer);
+  return LoadSnapshot(stream);
+}
+
+Tape LoadSnapshotFile(const std::string& filename) {
+  std::ifstream fin(filename, std::ios::binary);
+  if (!fin) {
+    throw BadFile(filename);
+  }
+  return LoadSnapshot(fin);
+}
+
+void SetSnapshotCacheDirectory(const std::string& directory) {
+  std::lock_guard<std::mutex> lock(CacheMutex());
+  std::vector<std::unique_ptr<const std::string>>& directories =
+      CacheDirectories();
+  for (const std::unique_ptr<const std::string>& kept : directories) {
+    if (*kept == directory) {
+      CacheDirectory().store(kept.get(), std::memory_order_release);
+      return;
+    }
+  }
+  directories.emplace_back(new std::string(directory));
+  CacheDirectory().store(directories.back().get(), std::memory_order_release);
+}
+
+std::string SnapshotCacheDirectory() {
+  const std::string* directory =
+      CacheDirectory().load(std::memory_order_acquire);
+  return directory ? *directory : std::string();
+}
+
+Sha256Digest ContentHash(const std::string& input) {
+  return Sha256(input.data(), input.size());
+}
+
+Node LoadCached(const std::string& input, const std::string& directory) {
+  const Sha256Digest key = ContentHash(input);
+  const std::string filename = directory + "/" + ToHex(key) + ".snapshot";
+
+  std::ifstream fin(filename, std::ios::binary);
+  if (fin) {
+    try {
+      SnapshotHeader header;
+      std::shared_ptr<const detail::tape_data> pData = Read(fin, header);
+      if (header.key == key && header.sourceSize == input.size()) {
+        const Tape tape = TapeSnapshot::Make(std::move(pData));
+        return tape.Root() ? tape.Root().ToNode() : Node();
+      }
+    } catch (const BadSnapshot&) {
+      // it's replaced below
+    }
+    fin.close();
+  }
+
+  MemoryBuf buffer(input.data(), input.size());
+  std::istream stream(&buffer);
+  const Tape tape = LoadTape(stream);
+  WriteCacheFile(tape, filename, key, input.size());
+  return tape.Root() ? tape.Root().ToNode() : Node();
+}
+}  // namespace YAML
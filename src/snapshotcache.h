@@ -0,0 +1,32 @@
+#ifndef SNAPSHOTCACHE_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+#define SNAPSHOTCACHE_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+
+#if defined(_MSC_VER) ||                                            \
+    (defined(__GNUC__) && (__GNUC__ == 3 && __GNUC_MINOR__ >= 4) || \
+     (__GNUC__ >= 4))  // GCC supports "pragma once" correctly since 3.4
+#pragma once
+#endif
+
+#include <string>
+
+#include "sha256.h"
+
+namespace YAML {
+class Node;
+
+// The key LoadCached names a file's snapshot for: the SHA-256 digest of its
+// contents, since a snapshot is taken to be of any file with that key (and
+// a plain hash's collisions can be made on purpose).
+Sha256Digest ContentHash(const std::string& input);
+
+// The directory set by SetSnapshotCacheDirectory (or an empty string).
+std::string SnapshotCacheDirectory();
+
+// LoadCached
+// . Loads 'input' (the contents of a file) like Load, from its snapshot in
+//   'directory' if there is a good one, and otherwise by parsing it and then
+//   writing its snapshot there.
+Node LoadCached(const std::string& input, const std::string& directory);
+}  // namespace YAML
+
+#endif  // SNAPSHOTCACHE_H_62B23520_7C8E_11DE_8A39_0800200C9A66
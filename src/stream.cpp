@@ -1,3 +1,4 @@
+#include <cstring>
 #include <iostream>
 
 #include "stream.h"
@@ -182,14 +183,29 @@ inline void QueueUnicodeCodepoint(std::deque<char>& q, unsigned long ch) {
   }
 }
 
-Stream::Stream(std::istream& input)
+Stream::Stream(std::istream& input) : Stream(input, Mark()) {}
+
+Stream::Stream(std::istream& input, const Mark& start)
+    : Stream(input, start, false) {}
+
+Stream::Stream(std::istream& input, const Mark& start, bool partial)
     : m_input(input),
-      m_mark{},
+      m_partial(partial),
+      m_pos(start.pos),
+      m_line(start.line),
+      m_lineStart(start.pos - start.column),
+      m_lineBreaks{},
+      m_rewindPos(start.pos),
+      m_rewindLine(start.line),
+      m_rewindLineStart(start.pos - start.column),
+      m_sinceRewindPoint{},
       m_charSet{},
       m_readahead{},
       m_pPrefetched(new unsigned char[YAML_PREFETCH_SIZE]),
       m_nPrefetchedAvailable(0),
-      m_nPrefetchedUsed(0) {
+      m_nPrefetchedUsed(0),
+      m_nDecodeStart(0),
+      m_nDecodeQueued(0) {
   using char_traits = std::istream::traits_type;
 
   if (!input)
@@ -202,6 +218,10 @@ Stream::Stream(std::istream& input)
   UtfIntroState state = uis_start;
   for (; !s_introFinalState[state];) {
     std::istream::int_type ch = input.get();
+    if (m_partial && ch == char_traits::eof()) {
+      delete[] m_pPrefetched;
+      throw NeedMoreInput();
+    }
     intro[nIntroUsed++] = ch;
     UtfIntroCharType charType = IntroCharTypeOf(ch);
     UtfIntroState newState = s_introTransitions[state][charType];
@@ -237,7 +257,12 @@ Stream::Stream(std::istream& input)
       break;
   }
 
-  ReadAheadTo(0);
+  try {
+    ReadAheadTo(0);
+  } catch (const NeedMoreInput&) {
+    delete[] m_pPrefetched;
+    throw;
+  }
 }
 
 Stream::~Stream() { delete[] m_pPrefetched; }
@@ -255,18 +280,20 @@ Stream::operator bool() const {
          (!m_readahead.empty() && m_readahead[0] != Stream::eof());
 }
 
+const Mark Stream::mark() const {
+  PassLineBreaks();
+  Mark mark;
+  mark.pos = m_pos;
+  mark.line = m_line;
+  mark.column = m_pos - m_lineStart;
+  return mark;
+}
+
 // get
 // . Extracts a character from the stream and updates our position
 char Stream::get() {
   char ch = peek();
   AdvanceCurrent();
-  m_mark.column++;
-
-  if (ch == '\n') {
-    m_mark.column = 0;
-    m_mark.line++;
-  }
-
   return ch;
 }
 
@@ -291,13 +318,46 @@ void Stream::eat(int n) {
 
 void Stream::AdvanceCurrent() {
   if (!m_readahead.empty()) {
+    if (m_partial)
+      m_sinceRewindPoint.push_back(m_readahead[0]);
     m_readahead.pop_front();
-    m_mark.pos++;
+    m_pos++;
   }
 
   ReadAheadTo(0);
 }
 
+// SetRewindPoint
+// . Notes where the stream is, for Rewind()
+void Stream::SetRewindPoint() {
+  PassLineBreaks();
+  m_rewindPos = m_pos;
+  m_rewindLine = m_line;
+  m_rewindLineStart = m_lineStart;
+  m_sinceRewindPoint.clear();
+}
+
+// Rewind
+// . Goes back to the rewind point: the characters read since go back in front
+//   of the readahead, and their line breaks in front of the ones queued (which
+//   are all further on, once the ones passed are gone)
+std::size_t Stream::Rewind() {
+  PassLineBreaks();
+  const std::size_t size = m_sinceRewindPoint.size();
+  for (std::size_t i = m_sinceRewindPoint.size(); i-- > 0;) {
+    if (m_sinceRewindPoint[i] == '\n')
+      m_lineBreaks.push_front(m_rewindPos + static_cast<int>(i));
+  }
+  m_readahead.insert(m_readahead.begin(), m_sinceRewindPoint.begin(),
+                     m_sinceRewindPoint.end());
+  m_sinceRewindPoint.clear();
+
+  m_pos = m_rewindPos;
+  m_line = m_rewindLine;
+  m_lineStart = m_rewindLineStart;
+  return size;
+}
+
 bool Stream::_ReadAheadTo(size_t i) const {
   while (m_input.good() && (m_readahead.size() <= i)) {
     switch (m_charSet) {
@@ -319,18 +379,48 @@ bool Stream::_ReadAheadTo(size_t i) const {
     }
   }
 
-  // signal end of stream
-  if (!m_input.good())
+  // signal end of stream (or, if the input may go on, that we need more)
+  if (!m_input.good()) {
+    if (m_partial) {
+      if (m_readahead.size() <= i)
+        throw NeedMoreInput();
+      return true;
+    }
     m_readahead.push_back(Stream::eof());
+  }
 
   return m_readahead.size() > i;
 }
 
+inline char* ReadBuffer(unsigned char* pBuffer) {
+  return reinterpret_cast<char*>(pBuffer);
+}
+
+// QueueLineBreaks
+// . Notes the line breaks in 'text', which is about to be added to the end of
+//   the readahead
+void Stream::QueueLineBreaks(const char* text, std::size_t size) const {
+  const int pos = m_pos + static_cast<int>(m_readahead.size());
+  for (const char *p = text, *end = text + size;
+       (p = static_cast<const char*>(std::memchr(p, '\n', end - p))) != 0;
+       ++p)
+    m_lineBreaks.push_back(pos + static_cast<int>(p - text));
+}
+
+// StreamInUtf8
+// . UTF-8 goes into the readahead as it is, so the whole prefetched block is
+//   moved over at once
 void Stream::StreamInUtf8() const {
-  unsigned char b = GetNextByte();
-  if (m_input.good()) {
-    m_readahead.push_back(static_cast<char>(b));
+  m_nDecodeStart = m_nPrefetchedAvailable;
+  if (!PrefetchBytes()) {
+    return;
   }
+
+  const char* text = ReadBuffer(m_pPrefetched) + m_nPrefetchedUsed;
+  const std::size_t size = m_nPrefetchedAvailable - m_nPrefetchedUsed;
+  QueueLineBreaks(text, size);
+  m_readahead.insert(m_readahead.end(), text, text + size);
+  m_nPrefetchedUsed = m_nPrefetchedAvailable;
 }
 
 void Stream::StreamInUtf16() const {
@@ -338,9 +428,12 @@ void Stream::StreamInUtf16() const {
   unsigned char bytes[2];
   int nBigEnd = (m_charSet == utf16be) ? 0 : 1;
 
+  m_nDecodeStart = m_nPrefetchedUsed;
+  m_nDecodeQueued = m_readahead.size();
   bytes[0] = GetNextByte();
   bytes[1] = GetNextByte();
   if (!m_input.good()) {
+    CutOff();
     return;
   }
   ch = (static_cast<unsigned long>(bytes[nBigEnd]) << 8) |
@@ -362,7 +455,9 @@ void Stream::StreamInUtf16() const {
       bytes[0] = GetNextByte();
       bytes[1] = GetNextByte();
       if (!m_input.good()) {
-        QueueUnicodeCodepoint(m_readahead, CP_REPLACEMENT_CHARACTER);
+        if (!CutOff()) {
+          QueueUnicodeCodepoint(m_readahead, CP_REPLACEMENT_CHARACTER);
+        }
         return;
       }
       unsigned long chLow = (static_cast<unsigned long>(bytes[nBigEnd]) << 8) |
@@ -378,8 +473,11 @@ void Stream::StreamInUtf16() const {
           QueueUnicodeCodepoint(m_readahead, ch);
           return;
         }
-        // Start the loop over with the new high surrogate
+        // Start the loop over with the new high surrogate (which is all
+        // that's left to cut off)
         ch = chLow;
+        m_nDecodeStart = m_nPrefetchedUsed - 2;
+        m_nDecodeQueued = m_readahead.size();
         continue;
       }
 
@@ -396,26 +494,59 @@ void Stream::StreamInUtf16() const {
     }
   }
 
+  if (ch == '\n') {
+    m_lineBreaks.push_back(m_pos + static_cast<int>(m_readahead.size()));
+  }
   QueueUnicodeCodepoint(m_readahead, ch);
 }
 
-inline char* ReadBuffer(unsigned char* pBuffer) {
-  return reinterpret_cast<char*>(pBuffer);
-}
-
-unsigned char Stream::GetNextByte() const {
+// PrefetchBytes
+// . Makes sure there are prefetched bytes left, and returns false (and sets
+//   eof on the input) if there aren't any more
+// . Over partial input, the bytes of the character being decoded are kept,
+//   in case it's cut off (see CutOff)
+bool Stream::PrefetchBytes() const {
   if (m_nPrefetchedUsed >= m_nPrefetchedAvailable) {
+    std::size_t nKept = 0;
+    if (m_partial && m_nDecodeStart < m_nPrefetchedAvailable) {
+      nKept = m_nPrefetchedAvailable - m_nDecodeStart;
+      std::memmove(m_pPrefetched, m_pPrefetched + m_nDecodeStart, nKept);
+    }
+    m_nDecodeStart = 0;
+
     std::streambuf* pBuf = m_input.rdbuf();
-    m_nPrefetchedAvailable = static_cast<std::size_t>(
-        pBuf->sgetn(ReadBuffer(m_pPrefetched), YAML_PREFETCH_SIZE));
-    m_nPrefetchedUsed = 0;
-    if (!m_nPrefetchedAvailable) {
+    const std::size_t nRead = static_cast<std::size_t>(
+        pBuf->sgetn(ReadBuffer(m_pPrefetched) + nKept,
+                    static_cast<std::streamsize>(YAML_PREFETCH_SIZE - nKept)));
+    m_nPrefetchedAvailable = nKept + nRead;
+    m_nPrefetchedUsed = nKept;
+    if (!nRead) {
       m_input.setstate(std::ios_base::eofbit);
+      return false;
     }
+  }
 
-    if (0 == m_nPrefetchedAvailable) {
-      return 0;
-    }
+  return true;
+}
+
+// CutOff
+// . Over partial input, puts back the bytes of a UTF-16 or UTF-32 character
+//   that the input so far ends in the middle of (and anything queued for
+//   them), so that it's decoded whole once the rest of it comes in; returns
+//   whether it did
+bool Stream::CutOff() const {
+  if (!m_partial) {
+    return false;
+  }
+
+  m_nPrefetchedUsed = m_nDecodeStart;
+  m_readahead.resize(m_nDecodeQueued);
+  return true;
+}
+
+unsigned char Stream::GetNextByte() const {
+  if (!PrefetchBytes()) {
+    return 0;
   }
 
   return m_pPrefetched[m_nPrefetchedUsed++];
@@ -428,11 +559,14 @@ void Stream::StreamInUtf32() const {
   unsigned char bytes[4];
   int* pIndexes = (m_charSet == utf32be) ? indexes[1] : indexes[0];
 
+  m_nDecodeStart = m_nPrefetchedUsed;
+  m_nDecodeQueued = m_readahead.size();
   bytes[0] = GetNextByte();
   bytes[1] = GetNextByte();
   bytes[2] = GetNextByte();
   bytes[3] = GetNextByte();
   if (!m_input.good()) {
+    CutOff();
     return;
   }
 
@@ -441,6 +575,9 @@ void Stream::StreamInUtf32() const {
     ch |= bytes[pIndexes[i]];
   }
 
+  if (ch == '\n') {
+    m_lineBreaks.push_back(m_pos + static_cast<int>(m_readahead.size()));
+  }
   QueueUnicodeCodepoint(m_readahead, ch);
 }
 }  // namespace YAML
@@ -19,11 +19,23 @@ namespace YAML {
 
 class StreamCharSource;
 
+// NeedMoreInput
+// . Thrown by a Stream over partial input (see below) when it's asked for
+//   more than it has been given so far.
+class NeedMoreInput {};
+
 class Stream {
  public:
   friend class StreamCharSource;
 
   Stream(std::istream& input);
+  // . 'start' is the position of the input's first character, for input that
+  //   was cut from a larger stream
+  Stream(std::istream& input, const Mark& start);
+  // . 'partial' is whether the input may go on past its end, as it does for
+  //   input that's pushed to the parser: then, reading past its end throws
+  //   NeedMoreInput, rather than ending the stream
+  Stream(std::istream& input, const Mark& start, bool partial);
   Stream(const Stream&) = delete;
   Stream(Stream&&) = delete;
   Stream& operator=(const Stream&) = delete;
@@ -40,17 +52,50 @@ class Stream {
 
   static char eof() { return 0x04; }
 
-  const Mark mark() const { return m_mark; }
-  int pos() const { return m_mark.pos; }
-  int line() const { return m_mark.line; }
-  int column() const { return m_mark.column; }
-  void ResetColumn() { m_mark.column = 0; }
+  const Mark mark() const;
+  int pos() const { return m_pos; }
+  int line() const {
+    PassLineBreaks();
+    return m_line;
+  }
+  int column() const {
+    PassLineBreaks();
+    return m_pos - m_lineStart;
+  }
+  void ResetColumn() {
+    PassLineBreaks();
+    m_lineStart = m_pos;
+  }
+
+  // partial input
+  // . SetRewindPoint() notes where the stream is, and Rewind() goes back
+  //   there, putting back the characters read since (and returning how many
+  //   there were); so a scan that runs out of input can be tried again once
+  //   there's more
+  // . Complete() marks the input as complete: then its end ends the stream
+  bool partial() const { return m_partial; }
+  void SetRewindPoint();
+  std::size_t Rewind();
+  void Complete() { m_partial = false; }
 
  private:
   enum CharacterSet { utf8, utf16le, utf16be, utf32le, utf32be };
 
   std::istream& m_input;
-  Mark m_mark;
+  bool m_partial;
+
+  // only the position is kept up to date as characters are read; the line and
+  // column are worked out from where the line breaks that were read ahead are
+  int m_pos;
+  mutable int m_line;
+  mutable int m_lineStart;
+  mutable std::deque<int> m_lineBreaks;
+
+  // where Rewind() goes back to, and what's been read since
+  int m_rewindPos;
+  int m_rewindLine;
+  int m_rewindLineStart;
+  std::string m_sinceRewindPoint;
 
   CharacterSet m_charSet;
   mutable std::deque<char> m_readahead;
@@ -58,7 +103,16 @@ class Stream {
   mutable size_t m_nPrefetchedAvailable;
   mutable size_t m_nPrefetchedUsed;
 
+  // the character being decoded from UTF-16 or UTF-32: where its bytes start,
+  // and how much readahead there was before it (to put back, over partial
+  // input, if it's cut off)
+  mutable size_t m_nDecodeStart;
+  mutable size_t m_nDecodeQueued;
+
   void AdvanceCurrent();
+  bool CutOff() const;
+  void PassLineBreaks() const;
+  void QueueLineBreaks(const char* text, std::size_t size) const;
   char CharAt(size_t i) const;
   bool ReadAheadTo(size_t i) const;
   bool _ReadAheadTo(size_t i) const;
@@ -66,12 +120,23 @@ class Stream {
   void StreamInUtf16() const;
   void StreamInUtf32() const;
   unsigned char GetNextByte() const;
+  bool PrefetchBytes() const;
 };
 
 // CharAt
 // . Unchecked access
 inline char Stream::CharAt(size_t i) const { return m_readahead[i]; }
 
+// PassLineBreaks
+// . Moves the line (and its start) up to the current position
+inline void Stream::PassLineBreaks() const {
+  while (!m_lineBreaks.empty() && m_lineBreaks.front() < m_pos) {
+    m_line++;
+    m_lineStart = m_lineBreaks.front() + 1;
+    m_lineBreaks.pop_front();
+  }
+}
+
 inline bool Stream::ReadAheadTo(size_t i) const {
   if (m_readahead.size() > i)
     return true;
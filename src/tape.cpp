@@ -0,0 +1,289 @@
+#include "yaml-cpp/tape.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <unordered_map>
+
+#include "nodebuilder.h"
+#include "tapebuilder.h"
+#include "yaml-cpp/eventhandler.h"
+#include "yaml-cpp/parser.h"
+
+namespace YAML {
+namespace {
+// TapeEmitter
+// . Replays a subtree of a tape as events (for ToNode). An entry with links
+//   to it gets an anchor the first time it's emitted, and the links after
+//   that are aliases of it; a link to an entry outside the subtree is
+//   emitted as a copy of it.
+class TapeEmitter {
+ public:
+  TapeEmitter(const detail::tape_data& data, EventHandler& handler)
+      : m_data(data), m_handler(handler), m_anchors{}, m_nextAnchor(0) {}
+
+  void Emit(std::size_t index) {
+    const detail::tape_entry& entry = m_data.entries[index];
+    if (entry.type == detail::tape_entry::LINK) {
+      auto it = m_anchors.find(entry.size);
+      if (it != m_anchors.end()) {
+        m_handler.OnAlias(m_data.mark(entry), it->second);
+      } else {
+        Emit(entry.size);
+      }
+      return;
+    }
+
+    anchor_t anchor = NullAnchor;
+    if (entry.anchored) {
+      anchor = ++m_nextAnchor;
+      m_anchors.emplace(index, anchor);
+    }
+
+    const std::string& tag = m_data.tags[entry.tag];
+    const Mark mark = m_data.mark(entry);
+    switch (entry.type) {
+      case NodeType::Null:
+        m_handler.OnNull(mark, anchor);
+        break;
+      case NodeType::Scalar:
+        m_handler.OnScalar(
+            mark, tag, anchor,
+            std::string(m_data.arena.data() + entry.value, entry.length));
+        break;
+      case NodeType::Sequence:
+        m_handler.OnSequenceStart(mark, tag, anchor,
+                                  EmitterStyle::value(entry.style));
+        EmitChildren(index, entry.size);
+        m_handler.OnSequenceEnd();
+        break;
+      case NodeType::Map:
+        m_handler.OnMapStart(mark, tag, anchor,
+                             EmitterStyle::value(entry.style));
+        EmitChildren(index, entry.size * 2);
+        m_handler.OnMapEnd();
+        break;
+      default:
+        break;
+    }
+  }
+
+ private:
+  void EmitChildren(std::size_t index, std::size_t count) {
+    std::size_t child = index + 1;
+    for (std::size_t i = 0; i < count; i++) {
+      Emit(child);
+      child += m_data.entries[child].skip;
+    }
+  }
+
+ private:
+  const detail::tape_data& m_data;
+  EventHandler& m_handler;
+  std::unordered_map<std::size_t, anchor_t> m_anchors;
+  anchor_t m_nextAnchor;
+};
+}  // namespace
+
+namespace detail {
+Mark tape_data::mark(const tape_entry& entry) const {
+  if (entry.pos == tape_entry::NO_POS)
+    return Mark::null_mark();
+
+  // (the last line that starts at or before it)
+  auto it = std::upper_bound(lines.begin(), lines.end(), entry.pos,
+                             [](std::uint32_t pos, const tape_line& line) {
+                               return pos < line.start;
+                             });
+  Mark result;
+  result.pos = static_cast<int>(entry.pos);
+  if (it != lines.begin()) {
+    --it;
+    result.line = static_cast<int>(it->line);
+    result.column = static_cast<int>(entry.pos - it->start);
+  }
+  return result;
+}
+}  // namespace detail
+
+TapeNode::TapeNode(const detail::tape_data* pData, std::size_t index)
+    : m_pData(pData), m_index(index) {
+  const detail::tape_entry& entry = m_pData->entries[m_index];
+  if (entry.type == detail::tape_entry::LINK)
+    m_index = entry.size;
+}
+
+const detail::tape_entry& TapeNode::entry() const {
+  if (!m_pData)
+    throw InvalidNode(std::string());
+  return m_pData->entries[m_index];
+}
+
+NodeType::value TapeNode::Type() const {
+  return m_pData ? NodeType::value(entry().type) : NodeType::Undefined;
+}
+
+Mark TapeNode::Mark() const {
+  const detail::tape_entry& e = entry();
+  return m_pData->mark(e);
+}
+
+const std::string& TapeNode::Tag() const {
+  return m_pData->tags[entry().tag];
+}
+
+EmitterStyle::value TapeNode::Style() const {
+  return EmitterStyle::value(entry().style);
+}
+
+std::string TapeNode::Scalar() const {
+  const detail::tape_entry& e = entry();
+  if (e.type != NodeType::Scalar)
+    return std::string();
+  return std::string(m_pData->arena.data() + e.value, e.length);
+}
+
+const char* TapeNode::ScalarData() const {
+  const detail::tape_entry& e = entry();
+  if (e.type != NodeType::Scalar)
+    return "";
+  return m_pData->arena.data() + e.value;
+}
+
+std::size_t TapeNode::ScalarSize() const {
+  const detail::tape_entry& e = entry();
+  return e.type == NodeType::Scalar ? e.length : 0;
+}
+
+std::size_t TapeNode::size() const {
+  if (!m_pData)
+    return 0;
+
+  const detail::tape_entry& e = entry();
+  return e.type == NodeType::Sequence || e.type == NodeType::Map ? e.size : 0;
+}
+
+TapeNode TapeNode::at(std::size_t index) const {
+  if (!m_pData)
+    return TapeNode();
+
+  const detail::tape_entry& e = entry();
+  if (e.type != NodeType::Sequence || index >= e.size)
+    return TapeNode();
+
+  std::size_t child = m_index + 1;
+  for (std::size_t i = 0; i < index; i++)
+    child += m_pData->entries[child].skip;
+  return TapeNode(m_pData, child);
+}
+
+TapeNode TapeNode::find(const char* key, std::size_t size) const {
+  if (!m_pData)
+    return TapeNode();
+
+  const detail::tape_entry& e = entry();
+  if (e.type != NodeType::Map)
+    return TapeNode();
+
+  const std::vector<detail::tape_entry>& entries = m_pData->entries;
+  std::size_t child = m_index + 1;
+  for (std::size_t i = 0; i < e.size; i++) {
+    const TapeNode node(m_pData, child);
+    const detail::tape_entry& k = entries[node.m_index];
+    child += entries[child].skip;
+    if (k.type == NodeType::Scalar && k.length == size &&
+        std::memcmp(m_pData->arena.data() + k.value, key, size) == 0)
+      return TapeNode(m_pData, child);
+    child += entries[child].skip;
+  }
+  return TapeNode();
+}
+
+TapeNode TapeNode::find(const char* key) const {
+  return find(key, std::strlen(key));
+}
+
+TapeIterator TapeNode::begin() const {
+  if (!m_pData)
+    return TapeIterator();
+
+  const detail::tape_entry& e = entry();
+  if (e.type != NodeType::Sequence && e.type != NodeType::Map)
+    return TapeIterator();
+  return TapeIterator(m_pData, m_index + 1, e.type == NodeType::Map);
+}
+
+TapeIterator TapeNode::end() const {
+  if (!m_pData)
+    return TapeIterator();
+
+  const detail::tape_entry& e = entry();
+  if (e.type != NodeType::Sequence && e.type != NodeType::Map)
+    return TapeIterator();
+  return TapeIterator(m_pData, m_index + e.skip, e.type == NodeType::Map);
+}
+
+Node TapeNode::ToNode() const {
+  if (!m_pData)
+    return Node(NodeType::Undefined);
+
+  NodeBuilder builder;
+  TapeEmitter(*m_pData, builder).Emit(m_index);
+  return builder.Root();
+}
+
+TapeValue TapeIterator::operator*() const {
+  if (!m_map)
+    return TapeValue(TapeNode(m_pData, m_index));
+
+  const std::size_t value = m_index + m_pData->entries[m_index].skip;
+  return TapeValue(TapeNode(m_pData, m_index), TapeNode(m_pData, value));
+}
+
+TapeIterator& TapeIterator::operator++() {
+  m_index += m_pData->entries[m_index].skip;
+  if (m_map)
+    m_index += m_pData->entries[m_index].skip;
+  return *this;
+}
+
+Tape::Tape() : m_pData{} {}
+
+Tape::Tape(std::shared_ptr<const detail::tape_data> pData)
+    : m_pData(std::move(pData)) {}
+
+TapeNode Tape::Root() const {
+  if (!m_pData)
+    return TapeNode();
+  return TapeNode(m_pData.get(), 0);
+}
+
+Tape LoadTape(const std::string& input) {
+  std::stringstream stream(input);
+  return LoadTape(stream);
+}
+
+Tape LoadTape(const char* input) {
+  std::stringstream stream(input);
+  return LoadTape(stream);
+}
+
+Tape LoadTape(std::istream& input) {
+  Parser parser(input);
+  TapeBuilder builder;
+  if (!parser.HandleNextDocument(builder)) {
+    return Tape();
+  }
+
+  return builder.Root();
+}
+
+Tape LoadTapeFile(const std::string& filename) {
+  std::ifstream fin(filename);
+  if (!fin) {
+    throw BadFile(filename);
+  }
+  return LoadTape(fin);
+}
+}  // namespace YAML
@@ -0,0 +1,135 @@
+#include "tapebuilder.h"
+
+#include <algorithm>
+#include <cassert>
+
+#include "yaml-cpp/mark.h"
+
+namespace YAML {
+TapeBuilder::TapeBuilder()
+    : m_pData(new detail::tape_data), m_stack{}, m_anchors{}, m_tags{} {
+  m_anchors.push_back(0);  // since the anchors start at 1
+}
+
+TapeBuilder::~TapeBuilder() = default;
+
+Tape TapeBuilder::Root() {
+  if (m_pData->entries.empty())
+    return Tape();
+
+  return Tape(std::move(m_pData));
+}
+
+void TapeBuilder::OnDocumentStart(const Mark&) {}
+
+void TapeBuilder::OnDocumentEnd() {}
+
+void TapeBuilder::OnNull(const Mark& mark, anchor_t anchor) {
+  Push(NodeType::Null, mark, std::string(), anchor);
+}
+
+void TapeBuilder::OnAlias(const Mark& mark, anchor_t anchor) {
+  const std::size_t target = m_anchors[anchor];
+  detail::tape_entry& entry =
+      Push(detail::tape_entry::LINK, mark, std::string(), NullAnchor);
+  entry.size = static_cast<std::uint32_t>(target);
+  m_pData->entries[target].anchored = true;
+}
+
+void TapeBuilder::OnScalar(const Mark& mark, const std::string& tag,
+                           anchor_t anchor, const std::string& value) {
+  std::string& arena = m_pData->arena;
+  detail::tape_entry& entry = Push(NodeType::Scalar, mark, tag, anchor);
+  entry.value = arena.size();
+  entry.length = static_cast<std::uint32_t>(value.size());
+  arena.append(value);
+  arena.push_back('\0');
+}
+
+void TapeBuilder::OnSequenceStart(const Mark& mark, const std::string& tag,
+                                  anchor_t anchor, EmitterStyle::value style) {
+  Push(NodeType::Sequence, mark, tag, anchor).style =
+      static_cast<unsigned char>(style);
+  m_stack.push_back(m_pData->entries.size() - 1);
+}
+
+void TapeBuilder::OnSequenceEnd() { Pop(); }
+
+void TapeBuilder::OnMapStart(const Mark& mark, const std::string& tag,
+                             anchor_t anchor, EmitterStyle::value style) {
+  Push(NodeType::Map, mark, tag, anchor).style =
+      static_cast<unsigned char>(style);
+  m_stack.push_back(m_pData->entries.size() - 1);
+}
+
+void TapeBuilder::OnMapEnd() {
+  detail::tape_entry& map = m_pData->entries[m_stack.back()];
+  map.size /= 2;  // (it counted keys and values)
+  Pop();
+}
+
+detail::tape_entry& TapeBuilder::Push(unsigned char type, const Mark& mark,
+                                      const std::string& tag,
+                                      anchor_t anchor) {
+  std::vector<detail::tape_entry>& entries = m_pData->entries;
+  if (!m_stack.empty())
+    entries[m_stack.back()].size++;
+
+  if (anchor) {
+    assert(anchor == m_anchors.size());
+    m_anchors.push_back(entries.size());
+  }
+
+  entries.emplace_back(type, Pos(mark));
+  entries.back().tag = TagIndex(tag);
+  return entries.back();
+}
+
+void TapeBuilder::Pop() {
+  std::vector<detail::tape_entry>& entries = m_pData->entries;
+  const std::size_t index = m_stack.back();
+  m_stack.pop_back();
+  entries[index].skip = static_cast<std::uint32_t>(entries.size() - index);
+}
+
+// Pos
+// . Records the line 'mark' is on, if it's a new one, and returns where it
+//   is; the nodes come in the order they're in the input, so that's almost
+//   always just a look at the last line.
+std::uint32_t TapeBuilder::Pos(const Mark& mark) {
+  if (mark.is_null())
+    return detail::tape_entry::NO_POS;
+
+  std::vector<detail::tape_line>& lines = m_pData->lines;
+  const detail::tape_line line = {
+      static_cast<std::uint32_t>(mark.pos - mark.column),
+      static_cast<std::uint32_t>(mark.line)};
+  if (lines.empty() || line.start > lines.back().start) {
+    lines.push_back(line);
+  } else if (line.start != lines.back().start) {
+    auto it = std::lower_bound(
+        lines.begin(), lines.end(), line,
+        [](const detail::tape_line& a, const detail::tape_line& b) {
+          return a.start < b.start;
+        });
+    if (it->start != line.start)
+      lines.insert(it, line);
+  }
+  return static_cast<std::uint32_t>(mark.pos);
+}
+
+// TagIndex
+// . A document has only a few different tags (most nodes have "?" or "!"),
+//   so each is kept once.
+std::uint32_t TapeBuilder::TagIndex(const std::string& tag) {
+  std::vector<std::string>& tags = m_pData->tags;
+  auto it = m_tags.find(tag);
+  if (it != m_tags.end())
+    return it->second;
+
+  const std::uint32_t index = static_cast<std::uint32_t>(tags.size());
+  tags.push_back(tag);
+  m_tags.emplace(tag, index);
+  return index;
+}
+}  // namespace YAML
@@ -0,0 +1,72 @@
+#ifndef TAPEBUILDER_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+#define TAPEBUILDER_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+
+#if defined(_MSC_VER) ||                                            \
+    (defined(__GNUC__) && (__GNUC__ == 3 && __GNUC_MINOR__ >= 4) || \
+     (__GNUC__ >= 4))  // GCC supports "pragma once" correctly since 3.4
+#pragma once
+#endif
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "yaml-cpp/anchor.h"
+#include "yaml-cpp/emitterstyle.h"
+#include "yaml-cpp/eventhandler.h"
+#include "yaml-cpp/node/type.h"
+#include "yaml-cpp/tape.h"
+
+namespace YAML {
+struct Mark;
+
+// TapeBuilder
+// . Builds a Tape from the events of one document, as NodeBuilder does a
+//   Node: each node is appended to the tape as it starts, and a collection's
+//   size and skip are filled in when it ends.
+class TapeBuilder final : public EventHandler {
+ public:
+  TapeBuilder();
+  TapeBuilder(const TapeBuilder&) = delete;
+  TapeBuilder(TapeBuilder&&) = delete;
+  TapeBuilder& operator=(const TapeBuilder&) = delete;
+  TapeBuilder& operator=(TapeBuilder&&) = delete;
+  ~TapeBuilder() override;
+
+  Tape Root();
+
+  void OnDocumentStart(const Mark& mark) override;
+  void OnDocumentEnd() override;
+
+  void OnNull(const Mark& mark, anchor_t anchor) override;
+  void OnAlias(const Mark& mark, anchor_t anchor) override;
+  void OnScalar(const Mark& mark, const std::string& tag, anchor_t anchor,
+                const std::string& value) override;
+
+  void OnSequenceStart(const Mark& mark, const std::string& tag,
+                       anchor_t anchor, EmitterStyle::value style) override;
+  void OnSequenceEnd() override;
+
+  void OnMapStart(const Mark& mark, const std::string& tag, anchor_t anchor,
+                  EmitterStyle::value style) override;
+  void OnMapEnd() override;
+
+ private:
+  detail::tape_entry& Push(unsigned char type, const Mark& mark,
+                           const std::string& tag, anchor_t anchor);
+  void Pop();
+  std::uint32_t Pos(const Mark& mark);
+  std::uint32_t TagIndex(const std::string& tag);
+
+ private:
+  std::shared_ptr<detail::tape_data> m_pData;
+  std::vector<std::size_t> m_stack;    // the collections that are open
+  std::vector<std::size_t> m_anchors;  // the entry of each anchor
+  std::unordered_map<std::string, std::uint32_t> m_tags;
+};
+}  // namespace YAML
+
+#endif  // TAPEBUILDER_H_62B23520_7C8E_11DE_8A39_0800200C9A66
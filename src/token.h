@@ -46,6 +46,8 @@ struct Token {
     PLAIN_SCALAR,
     NON_PLAIN_SCALAR
   };
+  // what 'data' is for a NON_PLAIN_SCALAR
+  enum SCALAR_STYLE { QUOTED_SCALAR, BLOCK_SCALAR };
 
   // data
   Token(TYPE type_, const Mark& mark_)
@@ -60,6 +62,8 @@ struct Token {
 
   STATUS status;
   TYPE type;
+  // (resolved as the token is scanned, from the line breaks Stream finds
+  // as it reads ahead, since they're let go of as it goes on)
   Mark mark;
   std::string value;
   std::vector<std::string> params;
@@ -0,0 +1,135 @@
+#ifndef TOKENQUEUE_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+#define TOKENQUEUE_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+
+#if defined(_MSC_VER) ||                                            \
+    (defined(__GNUC__) && (__GNUC__ == 3 && __GNUC_MINOR__ >= 4) || \
+     (__GNUC__ >= 4))  // GCC supports "pragma once" correctly since 3.4
+#pragma once
+#endif
+
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+#include "token.h"
+#include "yaml-cpp/mark.h"
+
+namespace YAML {
+// TokenQueue
+// . The scanner's output: a FIFO of tokens, kept in a ring of fixed-size
+//   blocks.
+// . A slot is reused once its token is popped, along with the memory of its
+//   value and params, so scanning doesn't allocate once the queue (and its
+//   strings) have grown to fit the input.
+// . A token stays where it is until it's popped (the scanner keeps pointers
+//   to the ones it hasn't verified yet), so the ring grows by adding blocks,
+//   and never moves tokens.
+class TokenQueue {
+ public:
+  TokenQueue() : m_blocks{}, m_frontBlock(0), m_frontIndex(0), m_size(0) {}
+  TokenQueue(const TokenQueue&) = delete;
+  TokenQueue& operator=(const TokenQueue&) = delete;
+
+  bool empty() const { return m_size == 0; }
+  std::size_t size() const { return m_size; }
+  // the number of tokens it has room for
+  std::size_t capacity() const { return m_blocks.size() * BLOCK_SIZE; }
+
+  Token& front() {
+    assert(!empty());
+    return At(0);
+  }
+  const Token& front() const {
+    assert(!empty());
+    return At(0);
+  }
+  Token& back() {
+    assert(!empty());
+    return At(m_size - 1);
+  }
+
+  // prepare
+  // . Returns the slot the next token goes in, reset to a token of the given
+  //   type (with empty, but not deallocated, value and params); it's only
+  //   added to the queue by commit(), so nothing is left in the queue if the
+  //   token can't be finished.
+  Token& prepare(Token::TYPE type, const Mark& mark) {
+    if (m_frontIndex + m_size == m_blocks.size() * BLOCK_SIZE) {
+      Grow();
+    }
+
+    Token& token = At(m_size);
+    token.status = Token::VALID;
+    token.type = type;
+    token.mark = mark;
+    token.value.clear();
+    token.params.clear();
+    token.data = 0;
+    return token;
+  }
+  void commit() { m_size++; }
+
+  Token& push(Token::TYPE type, const Mark& mark) {
+    Token& token = prepare(type, mark);
+    commit();
+    return token;
+  }
+
+  void pop() {
+    assert(!empty());
+    m_size--;
+    if (m_size == 0) {
+      m_frontIndex = 0;
+    } else if (++m_frontIndex == BLOCK_SIZE) {
+      m_frontIndex = 0;
+      m_frontBlock = (m_frontBlock + 1) % m_blocks.size();
+    }
+  }
+
+  // truncate
+  // . Drops the tokens after the first 'size' (e.g., the ones pushed by a
+  //   scan that's undone); their slots are reused, as popped ones are.
+  void truncate(std::size_t size) {
+    assert(size <= m_size);
+    m_size = size;
+    if (m_size == 0) {
+      m_frontIndex = 0;
+    }
+  }
+
+ private:
+  static const std::size_t BLOCK_SIZE = 32;
+  using Block = std::vector<Token>;
+
+  const Token& At(std::size_t i) const {
+    const std::size_t offset = m_frontIndex + i;
+    const std::size_t block =
+        (m_frontBlock + offset / BLOCK_SIZE) % m_blocks.size();
+    return m_blocks[block][offset % BLOCK_SIZE];
+  }
+  Token& At(std::size_t i) {
+    return const_cast<Token&>(static_cast<const TokenQueue&>(*this).At(i));
+  }
+
+  // Grow
+  // . Adds a block after the last one in use, i.e., just before the front
+  //   block (the queue is full, so all of them are in use). Moving a block
+  //   doesn't move its tokens.
+  void Grow() {
+    m_blocks.insert(
+        m_blocks.begin() + static_cast<std::ptrdiff_t>(m_frontBlock),
+        Block(BLOCK_SIZE, Token(Token::DIRECTIVE, Mark())));
+    if (m_blocks.size() > 1) {
+      m_frontBlock++;
+    }
+  }
+
+ private:
+  std::vector<Block> m_blocks;
+  std::size_t m_frontBlock;
+  std::size_t m_frontIndex;
+  std::size_t m_size;
+};
+}  // namespace YAML
+
+#endif  // TOKENQUEUE_H_62B23520_7C8E_11DE_8A39_0800200C9A66
@@ -0,0 +1,33 @@
+#include "config.h"
+#include "config_no_marks.h"
+#include "yaml-cpp/node/emit.h"
+#include "yaml-cpp/node/parse.h"
+#include "yaml-cpp/tape.h"
+
+#include "gtest/gtest.h"
+
+namespace YAML {
+namespace {
+TEST(EmbedTest, EmbedsTheDocument) {
+  const TapeNode root = test::config().Root();
+
+  ASSERT_TRUE(root.IsMap());
+  EXPECT_EQ("server", root.find("name").Scalar());
+  EXPECT_EQ(443, root.find("ports").at(1).as<int>());
+  EXPECT_EQ(20, root.find("limits").find("burst").as<int>());
+  EXPECT_EQ("server", root.find("alias").Scalar());
+  EXPECT_EQ(3, root.find("limits").find("rps").Mark().line);
+  EXPECT_EQ(Dump(LoadFile(YAML_CPP_EMBED_TEST_INPUT)), Dump(root.ToNode()));
+
+  // (it's loaded once)
+  EXPECT_EQ(&test::config(), &test::config());
+}
+
+TEST(EmbedTest, WithoutMarks) {
+  const TapeNode root = config_no_marks().Root();
+
+  EXPECT_TRUE(root.find("limits").Mark().is_null());
+  EXPECT_EQ(Dump(test::config().Root().ToNode()), Dump(root.ToNode()));
+}
+}  // namespace
+}  // namespace YAML
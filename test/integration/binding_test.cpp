@@ -0,0 +1,194 @@
+#include "yaml-cpp/yaml.h"  // IWYU pragma: keep
+
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace {
+struct Endpoint {
+  std::string host;
+  int port = 80;
+};
+
+struct Service {
+  std::string name;
+  bool enabled = false;
+  double timeout = 1.5;
+  Endpoint primary;
+  std::vector<Endpoint> replicas;
+  std::map<std::string, int> limits;
+  std::vector<std::string> tags;
+};
+}  // namespace
+
+namespace YAML {
+template <>
+struct binding<Endpoint> {
+  static void Describe(Fields<Endpoint>& fields) {
+    fields.Required("host", &Endpoint::host).Optional("port", &Endpoint::port);
+  }
+};
+
+template <>
+struct binding<Service> {
+  static void Describe(Fields<Service>& fields) {
+    fields.Required("name", &Service::name)
+        .Optional("enabled", &Service::enabled)
+        .Optional("timeout", &Service::timeout)
+        .Required("primary", &Service::primary)
+        .Optional("replicas", &Service::replicas)
+        .Optional("limits", &Service::limits)
+        .Optional("tags", &Service::tags);
+  }
+};
+
+namespace {
+TEST(BindingTest, FillsInNestedStructs) {
+  Service service;
+  ASSERT_TRUE(LoadInto(
+      "name: api\n"
+      "enabled: yes\n"
+      "primary: {host: a.example, port: 8080}\n"
+      "replicas:\n"
+      "  - host: b.example\n"
+      "  - {port: 9000, host: c.example}\n"
+      "limits: {rps: 100, burst: 20}\n"
+      "tags: [x, y]\n",
+      service));
+
+  EXPECT_EQ("api", service.name);
+  EXPECT_TRUE(service.enabled);
+  EXPECT_EQ(1.5, service.timeout);
+  EXPECT_EQ("a.example", service.primary.host);
+  EXPECT_EQ(8080, service.primary.port);
+  ASSERT_EQ(2u, service.replicas.size());
+  EXPECT_EQ("b.example", service.replicas[0].host);
+  EXPECT_EQ(80, service.replicas[0].port);
+  EXPECT_EQ("c.example", service.replicas[1].host);
+  EXPECT_EQ(9000, service.replicas[1].port);
+  EXPECT_EQ((std::map<std::string, int>{{"burst", 20}, {"rps", 100}}),
+            service.limits);
+  EXPECT_EQ((std::vector<std::string>{"x", "y"}), service.tags);
+}
+
+TEST(BindingTest, SkipsUnknownKeys) {
+  Endpoint endpoint;
+  ASSERT_TRUE(LoadInto(
+      "extra: {a: [1, {b: c}], [complex]: key}\n"
+      "[complex, key]: {host: wrong}\n"
+      "host: right\n"
+      "more: [[], {}]\n",
+      endpoint));
+  EXPECT_EQ("right", endpoint.host);
+  EXPECT_EQ(80, endpoint.port);
+}
+
+TEST(BindingTest, OptionalNullKeepsValue) {
+  Endpoint endpoint;
+  endpoint.port = 443;
+  ASSERT_TRUE(LoadInto("host: a\nport: ~\n", endpoint));
+  EXPECT_EQ(443, endpoint.port);
+}
+
+TEST(BindingTest, ReplacesContainers) {
+  Service service;
+  service.tags = {"old"};
+  service.limits = {{"old", 1}};
+  ASSERT_TRUE(LoadInto(
+      "name: n\nprimary: {host: h}\ntags: [new]\nlimits: {new: 2}\n",
+      service));
+  EXPECT_EQ(std::vector<std::string>{"new"}, service.tags);
+  EXPECT_EQ((std::map<std::string, int>{{"new", 2}}), service.limits);
+}
+
+TEST(BindingTest, AliasesOfScalars) {
+  std::vector<Endpoint> endpoints;
+  ASSERT_TRUE(LoadInto(
+      "- {skipped: &h shared, port: &p 1234, host: a}\n"
+      "- {host: *h, port: *p}\n",
+      endpoints));
+  ASSERT_EQ(2u, endpoints.size());
+  EXPECT_EQ("shared", endpoints[1].host);
+  EXPECT_EQ(1234, endpoints[1].port);
+}
+
+TEST(BindingTest, SkipsAnchoredSubtrees) {
+  Endpoint endpoint;
+  ASSERT_TRUE(LoadInto(
+      "extra: &e {a: &x [1, &y {b: c}], d: &z long scalar value}\n"
+      "host: right\n",
+      endpoint));
+  EXPECT_EQ("right", endpoint.host);
+
+  // (so their anchors aren't kept, to be bound)
+  EXPECT_THROW(LoadInto("extra: {a: &x name}\nhost: *x\n", endpoint),
+               RepresentationException);
+}
+
+TEST(BindingTest, AliasOfCollectionThrows) {
+  std::vector<Endpoint> endpoints;
+  EXPECT_THROW(LoadInto("- &e {host: a}\n- *e\n", endpoints),
+               RepresentationException);
+}
+
+TEST(BindingTest, MissingRequiredFieldThrows) {
+  Endpoint endpoint;
+  try {
+    LoadInto("\n  port: 1\n", endpoint);
+    FAIL() << "expected KeyNotFound";
+  } catch (const KeyNotFound& e) {
+    EXPECT_EQ(1, e.mark.line);
+    EXPECT_EQ(2, e.mark.column);
+    EXPECT_EQ(ErrorMsg::KEY_NOT_FOUND_WITH_KEY(std::string("host")), e.msg);
+  }
+}
+
+TEST(BindingTest, BadScalarThrows) {
+  Endpoint endpoint;
+  EXPECT_THROW(LoadInto("host: a\nport: eighty\n", endpoint),
+               TypedBadConversion<int>);
+  EXPECT_THROW(LoadInto("host: [a]\n", endpoint),
+               TypedBadConversion<std::string>);
+  EXPECT_THROW(LoadInto("[host, a]", endpoint), TypedBadConversion<Endpoint>);
+}
+
+TEST(BindingTest, EmptyInput) {
+  Endpoint endpoint;
+  endpoint.host = "unchanged";
+  EXPECT_FALSE(LoadInto("", endpoint));
+  EXPECT_EQ("unchanged", endpoint.host);
+}
+
+TEST(BindingTest, EachDocument) {
+  std::stringstream input("host: a\n---\nhost: b\nport: 2\n");
+  Parser parser(input);
+  Endpoint endpoint;
+  BindingHandler<Endpoint> handler(endpoint);
+
+  ASSERT_TRUE(parser.HandleNextDocument(handler));
+  EXPECT_EQ("a", endpoint.host);
+  ASSERT_TRUE(parser.HandleNextDocument(handler));
+  EXPECT_EQ("b", endpoint.host);
+  EXPECT_EQ(2, endpoint.port);
+  EXPECT_FALSE(parser.HandleNextDocument(handler));
+}
+
+TEST(BindingTest, MatchesNodeConversions) {
+  const char* input = "[0x10, -3, .inf, 1e3, On, 'quoted', ~]";
+  std::vector<std::string> strings;
+  ASSERT_TRUE(LoadInto(input, strings));
+  EXPECT_EQ(Load(input).as<std::vector<std::string>>(), strings);
+
+  std::vector<double> numbers;
+  ASSERT_TRUE(LoadInto("[16, -3, .inf, 1e3]", numbers));
+  EXPECT_EQ(Load("[16, -3, .inf, 1e3]").as<std::vector<double>>(), numbers);
+
+  bool on = false;
+  ASSERT_TRUE(LoadInto("On", on));
+  EXPECT_TRUE(on);
+}
+}  // namespace
+}  // namespace YAML
@@ -929,6 +929,21 @@ TEST_F(EmitterTest, DoubleQuotedString) {
   ExpectEmit("\"\\\" \\\\ \\n \\t \\r \\b \\x15 \\ufeff $\"");
 }
 
+TEST_F(EmitterTest, LongStringsWithCharactersToEscape) {
+  const std::string run(37, 'x');
+  out << BeginSeq;
+  out << run + ": " + run;
+  out << run + " #" + run;
+  out << DoubleQuoted << run + "\"" + run + "\\";
+  out << SingleQuoted << run + "'" + run;
+  out << run + "\xC2\xA2" + run;
+  out << EndSeq;
+
+  ExpectEmit("- \"" + run + ": " + run + "\"\n- \"" + run + " #" + run +
+             "\"\n- \"" + run + "\\\"" + run + "\\\\\"\n- '" + run + "''" +
+             run + "'\n- " + run + "\xC2\xA2" + run);
+}
+
 struct Foo {
   Foo() : x(0) {}
   Foo(int x_, const std::string& bar_) : x(x_), bar(bar_) {}
@@ -1292,6 +1307,28 @@ TEST_F(EmitterTest, HexAndOct) {
   ExpectEmit("[31, 0x1f, 037]");
 }
 
+TEST_F(EmitterTest, RepeatedLocalManipulatorsAreUndone) {
+  out << Flow << BeginSeq;
+  out << Hex << Oct << 31;
+  out << 31;
+  out << Flow << Block << BeginMap;
+  out << Key << "a" << Value << Hex << 31;
+  out << EndMap;
+  out << 31;
+  out << EndSeq;
+  ExpectEmit("[037, 31, {a: 0x1f}, 31]");
+}
+
+TEST_F(EmitterTest, NestedGroupSettingsLastUntilGroupEnds) {
+  out << Flow << Hex << BeginSeq;
+  out << Oct << BeginSeq << 31 << EndSeq;
+  out << 31;
+  out << EndSeq;
+  out << 31;
+
+  ExpectEmit("[[037], 0x1f]\n---\n31");
+}
+
 TEST_F(EmitterTest, CompactMapWithNewline) {
   out << Comment("Characteristics");
   out << BeginSeq;
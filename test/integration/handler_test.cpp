@@ -72,5 +72,37 @@ TEST_F(HandlerTest, CommentOnNewlineOfMapValueWithManySpace) {
   EXPECT_CALL(handler, OnDocumentEnd());
   Parse("key: value\n    # comment");
 }
+
+// a handler that keeps the scalars it's handed, rather than copying them
+class TakingEventHandler : public MockEventHandler {
+ public:
+  void OnOwnedScalar(const Mark&, std::string&& tag, anchor_t,
+                     std::string&& value) override {
+    tags.push_back(std::move(tag));
+    values.push_back(std::move(value));
+  }
+
+  std::vector<std::string> tags;
+  std::vector<std::string> values;
+};
+
+TEST(OwnedScalarTest, ScalarsAreHandedOver) {
+  NiceMock<TakingEventHandler> handler;
+  EXPECT_CALL(handler, OnScalar(_, _, _, _)).Times(0);
+
+  std::stringstream stream(
+      "- a scalar that's too long for the small string buffer\n"
+      "- !t 'x'\n"
+      "- !!str\n");
+  Parser parser(stream);
+  parser.HandleNextDocument(handler);
+
+  EXPECT_EQ(std::vector<std::string>({"?", "!t", "tag:yaml.org,2002:str"}),
+            handler.tags);
+  EXPECT_EQ(std::vector<std::string>(
+                {"a scalar that's too long for the small string buffer", "x",
+                 ""}),
+            handler.values);
+}
 }  // namespace
 }  // namespace YAML
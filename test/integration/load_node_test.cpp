@@ -1,5 +1,7 @@
 #include "yaml-cpp/yaml.h"  // IWYU pragma: keep
 
+#include <sstream>
+
 #include "gtest/gtest.h"
 
 namespace YAML {
@@ -94,6 +96,31 @@ TEST(LoadNodeTest, BinaryWithWhitespaces) {
             node["binaryText"].as<Binary>());
 }
 
+TEST(LoadNodeTest, BinaryWithWhitespaceInPadding) {
+  Node node = Load("[!!binary \"SGk= \", !!binary \"SQ= =\"]");
+  EXPECT_EQ(Binary(reinterpret_cast<const unsigned char*>("Hi"), 2),
+            node[0].as<Binary>());
+  EXPECT_EQ(Binary(reinterpret_cast<const unsigned char*>("I"), 1),
+            node[1].as<Binary>());
+}
+
+TEST(LoadNodeTest, InvalidBinary) {
+  EXPECT_THROW(Load("!!binary \"SGVs\xC3\xA9G8=\"").as<Binary>(),
+               TypedBadConversion<Binary>);
+}
+
+TEST(LoadNodeTest, LargeBinaryRoundTrip) {
+  std::vector<unsigned char> data(10000);
+  for (std::size_t i = 0; i < data.size(); i++) {
+    data[i] = static_cast<unsigned char>(i * 7 + i / 256);
+  }
+  const Binary binary(data.data(), data.size());
+
+  Emitter out;
+  out << binary;
+  EXPECT_EQ(binary, Load(out.c_str()).as<Binary>());
+}
+
 TEST(LoadNodeTest, IterateSequence) {
   Node node = Load("[1, 3, 5, 7]");
   int seq[] = {1, 3, 5, 7};
@@ -316,6 +343,50 @@ TEST(NodeTest, IncorrectFlow) {
   }
 }
 
+TEST(NodeTest, UnterminatedQuotedScalar) {
+  EXPECT_THROW(Load("'a\n"), ParserException);
+  EXPECT_THROW(Load("\"a\n\n"), ParserException);
+  EXPECT_EQ("a", Load("'a'").as<std::string>());
+}
+
+#ifndef YAML_CPP_NO_NODE_MARKS
+TEST(NodeTest, Marks) {
+  // long enough that it's read ahead in more than one block
+  std::string input = "a: 1\r\nb:\n  - x\n";
+  for (int i = 0; i < 1000; i++) {
+    input += "  - y\n";
+  }
+  input += "c:   [\n  z]\n";
+  Node node = Load(input);
+
+  EXPECT_EQ(3, node["a"].Mark().pos);
+  EXPECT_EQ(0, node["a"].Mark().line);
+  EXPECT_EQ(3, node["a"].Mark().column);
+  EXPECT_EQ(2, node["b"].Mark().line);
+  EXPECT_EQ(2, node["b"].Mark().column);
+  EXPECT_EQ(2, node["b"][0].Mark().line);
+  EXPECT_EQ(4, node["b"][0].Mark().column);
+  EXPECT_EQ(1002, node["b"][1000].Mark().line);
+  EXPECT_EQ(4, node["b"][1000].Mark().column);
+  EXPECT_EQ(1003, node["c"].Mark().line);
+  EXPECT_EQ(5, node["c"].Mark().column);
+  EXPECT_EQ(1004, node["c"][0].Mark().line);
+  EXPECT_EQ(2, node["c"][0].Mark().column);
+  EXPECT_EQ(static_cast<int>(input.size()) - 3, node["c"][0].Mark().pos);
+}
+
+TEST(NodeTest, MarksInUtf16) {
+  const std::string input(
+      "\xff\xfe"
+      "a\0:\0 \0b\0\n\0c\0:\0 \0d\0\n\0",
+      20);
+  Node node = Load(input);
+  EXPECT_EQ(1, node["c"].Mark().line);
+  EXPECT_EQ(3, node["c"].Mark().column);
+  EXPECT_EQ(8, node["c"].Mark().pos);
+}
+#endif
+
 TEST(NodeTest, LoadTildeAsNull) {
   Node node = Load("~");
   ASSERT_TRUE(node.IsNull());
@@ -345,5 +416,159 @@ TEST(NodeTest, LoadTagWithNullScalar) {
   EXPECT_TRUE(node.IsNull());
 }
 
+TEST(NodeTest, LookUpKeysByString) {
+  const Node node = Load("{a: 1, [b]: 2, ~: 3, \"\": 4, b: 5}");
+  EXPECT_EQ(1, node["a"].as<int>());
+  EXPECT_EQ(1, node[std::string("a")].as<int>());
+  EXPECT_EQ(5, node["b"].as<int>());
+  EXPECT_EQ(4, node[""].as<int>());
+  // (a null key isn't the string "~", as it wasn't when keys were decoded)
+  EXPECT_FALSE(node["~"]);
+  EXPECT_FALSE(node["c"]);
+}
+
+void ExpectSameAsLoadAll(const std::string& input) {
+  const std::vector<Node> expected = LoadAll(input);
+  const std::vector<Node> docs = LoadAllParallel(input, 4);
+  ASSERT_EQ(expected.size(), docs.size());
+  for (std::size_t i = 0; i < docs.size(); i++) {
+    EXPECT_EQ(Dump(expected[i]), Dump(docs[i])) << "document " << i;
+    EXPECT_EQ(expected[i].Mark().pos, docs[i].Mark().pos);
+    EXPECT_EQ(expected[i].Mark().line, docs[i].Mark().line);
+    EXPECT_EQ(expected[i].Mark().column, docs[i].Mark().column);
+  }
+}
+
+TEST(LoadAllParallelTest, ManyDocuments) {
+  std::string input;
+  for (int i = 0; i < 200; i++) {
+    input += "---\nid: " + std::to_string(i) + "\nitems: [a, b, {c: d}]\n";
+  }
+  ExpectSameAsLoadAll(input);
+  EXPECT_EQ(200u, LoadAllParallel(input, 4).size());
+}
+
+TEST(LoadAllParallelTest, DocumentMarkersInScalars) {
+  std::string input;
+  for (int i = 0; i < 50; i++) {
+    input +=
+        "--- |\n  ---\n  ...\n---\nkey: >\n ---\n ...\n"
+        "--- \"--- \\\n  ...\"\n--- plain\n ---\n";
+  }
+  ExpectSameAsLoadAll(input);
+}
+
+TEST(LoadAllParallelTest, DocumentEnd) {
+  std::string input = "\xEF\xBB\xBF";
+  for (int i = 0; i < 50; i++) {
+    input += "a: " + std::to_string(i) + "\n...\n# comment\n\n[b]\n... # c\n";
+  }
+  ExpectSameAsLoadAll(input);
+}
+
+TEST(LoadAllParallelTest, Directives) {
+  std::string input = "%TAG ! !foo\n%YAML 1.2\n--- !a 0\n";
+  for (int i = 0; i < 50; i++) {
+    input += "--- !b " + std::to_string(i) + "\n";
+    if (i % 10 == 9) {
+      input += "...\n%TAG ! !bar" + std::to_string(i) + "\n--- !c x\n";
+    }
+  }
+  ExpectSameAsLoadAll(input);
+  const std::vector<Node> docs = LoadAllParallel(input, 4);
+  EXPECT_EQ("!foob", docs[1].Tag());
+  EXPECT_EQ("!bar49c", docs.back().Tag());
+}
+
+TEST(LoadAllParallelTest, NotSplittable) {
+  // the '%' line is part of the block scalar
+  std::string input;
+  for (int i = 0; i < 50; i++) {
+    input += "--- |\n%not a directive\n";
+  }
+  ExpectSameAsLoadAll(input);
+}
+
+TEST(LoadAllParallelTest, ErrorHasSameMark) {
+  std::string input;
+  for (int i = 0; i < 100; i++) {
+    input += "---\n- " + std::to_string(i) + "\n";
+  }
+  input += "---\n[unclosed\n---\n- ok\n";
+  for (int i = 0; i < 100; i++) {
+    input += "---\n{a: \"unclosed\n";
+  }
+
+  Mark expected;
+  try {
+    LoadAll(input);
+    FAIL() << "expected a ParserException";
+  } catch (const ParserException& e) {
+    expected = e.mark;
+  }
+  try {
+    LoadAllParallel(input, 4);
+    FAIL() << "expected a ParserException";
+  } catch (const ParserException& e) {
+    EXPECT_EQ(expected.pos, e.mark.pos);
+    EXPECT_EQ(expected.line, e.mark.line);
+    EXPECT_EQ(expected.column, e.mark.column);
+  }
+}
+
+TEST(LoadAllParallelTest, RepeatedDocumentEnd) {
+  std::string input;
+  for (int i = 0; i < 50; i++) {
+    input += "a\n...\n\n...\n";
+  }
+  ExpectSameAsLoadAll(input);
+}
+
+TEST(LoadAllParallelTest, CutInsideQuotedScalar) {
+  std::string input;
+  for (int i = 0; i < 100; i++) {
+    input += "--- 'a\n--- b'\n";
+  }
+  EXPECT_THROW(LoadAll(input), ParserException);
+  EXPECT_THROW(LoadAllParallel(input, 4), ParserException);
+}
+
+TEST(DocumentStreamTest, ReadsDocumentsInOrder) {
+  std::stringstream input("a\n---\n[b, c]\n---\nd: e\n");
+  std::vector<std::string> docs;
+  for (const Node& doc : Documents(input)) {
+    docs.push_back(Dump(doc));
+  }
+  EXPECT_EQ(std::vector<std::string>({"a", "[b, c]", "d: e"}), docs);
+}
+
+TEST(DocumentStreamTest, Empty) {
+  std::stringstream input("# nothing\n");
+  DocumentStream docs = Documents(input);
+  EXPECT_TRUE(docs.begin() == docs.end());
+}
+
+TEST(DocumentStreamTest, KeptDocumentsAreNotChanged) {
+  std::stringstream input("a: 1\n---\nb: 2\n");
+  DocumentStream docs = Documents(input);
+  DocumentStream::iterator it = docs.begin();
+  Node first = *it++;
+  EXPECT_EQ(1, first["a"].as<int>());
+  ASSERT_TRUE(it != docs.end());
+  EXPECT_EQ(2, (*it)["b"].as<int>());
+  EXPECT_EQ(1, first["a"].as<int>());
+  EXPECT_FALSE(first["b"]);
+  EXPECT_TRUE(++it == docs.end());
+}
+
+TEST(DocumentStreamTest, ReadsOnlyAsFarAsNeeded) {
+  std::stringstream input("a\n---\nb\n---\n[unclosed\n");
+  DocumentStream docs = Documents(input);
+  DocumentStream::iterator it = docs.begin();
+  EXPECT_EQ("a", it->as<std::string>());
+  EXPECT_EQ("b", (++it)->as<std::string>());
+  EXPECT_THROW(++it, ParserException);
+}
+
 }  // namespace
 }  // namespace YAML
@@ -0,0 +1,214 @@
+#include "yaml-cpp/yaml.h"  // IWYU pragma: keep
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace YAML {
+namespace {
+// Writes down every event, with its mark, as a line of text.
+class RecordingHandler : public EventHandler {
+ public:
+  explicit RecordingHandler(std::size_t chunkSize = 0)
+      : events{}, documents(0), m_chunkSize(chunkSize) {}
+
+  void OnDocumentStart(const Mark& mark) override {
+    Record("+DOC", mark);
+    documents++;
+  }
+  void OnDocumentEnd() override { events.push_back("-DOC"); }
+
+  void OnNull(const Mark& mark, anchor_t anchor) override {
+    Record("NULL &" + std::to_string(anchor), mark);
+  }
+  void OnAlias(const Mark& mark, anchor_t anchor) override {
+    Record("ALIAS *" + std::to_string(anchor), mark);
+  }
+  void OnScalar(const Mark& mark, const std::string& tag, anchor_t anchor,
+                const std::string& value) override {
+    Record("SCALAR " + tag + " &" + std::to_string(anchor) + " " + value,
+           mark);
+  }
+
+  std::size_t ScalarChunkSize() const override { return m_chunkSize; }
+  void OnScalarStart(const Mark& mark, const std::string& tag,
+                     anchor_t anchor) override {
+    Record("+SCALAR " + tag + " &" + std::to_string(anchor), mark);
+  }
+  void OnScalarChunk(const char* data, std::size_t size) override {
+    events.push_back("CHUNK " + std::string(data, size));
+  }
+  void OnScalarEnd() override { events.push_back("-SCALAR"); }
+
+  void OnSequenceStart(const Mark& mark, const std::string& tag,
+                       anchor_t anchor, EmitterStyle::value) override {
+    Record("+SEQ " + tag + " &" + std::to_string(anchor), mark);
+  }
+  void OnSequenceEnd() override { events.push_back("-SEQ"); }
+
+  void OnMapStart(const Mark& mark, const std::string& tag, anchor_t anchor,
+                  EmitterStyle::value) override {
+    Record("+MAP " + tag + " &" + std::to_string(anchor), mark);
+  }
+  void OnMapEnd() override { events.push_back("-MAP"); }
+
+  std::vector<std::string> events;
+  std::size_t documents;
+
+ private:
+  std::size_t m_chunkSize;
+
+  void Record(const std::string& event, const Mark& mark) {
+    events.push_back(event + " @" + std::to_string(mark.pos) + ":" +
+                     std::to_string(mark.line) + ":" +
+                     std::to_string(mark.column));
+  }
+};
+
+// (an error is written down as the last event)
+std::vector<std::string> PullEvents(const std::string& input,
+                                    std::size_t chunkSize = 0) {
+  std::stringstream stream(input);
+  Parser parser(stream);
+  RecordingHandler handler(chunkSize);
+  try {
+    while (parser.HandleNextDocument(handler)) {
+    }
+  } catch (const ParserException& e) {
+    handler.events.push_back(std::string("ERROR ") + e.what());
+  }
+  return handler.events;
+}
+
+std::vector<std::string> PushEvents(const std::string& input,
+                                    std::size_t pieceSize,
+                                    std::size_t chunkSize = 0) {
+  RecordingHandler handler(chunkSize);
+  PushParser parser(handler);
+  std::size_t documents = 0;
+  try {
+    for (std::size_t i = 0; i < input.size(); i += pieceSize) {
+      documents += parser.feed(input.data() + i,
+                               std::min(pieceSize, input.size() - i));
+    }
+    documents += parser.finish();
+  } catch (const ParserException& e) {
+    handler.events.push_back(std::string("ERROR ") + e.what());
+    return handler.events;
+  }
+  EXPECT_EQ(handler.documents, documents);
+  return handler.events;
+}
+
+TEST(PushParserTest, SameEventsAsParser) {
+  const std::string inputs[] = {
+      "",
+      "a: 1\n",
+      "a: 1",
+      "- a\n- b\n---\n- c\n",
+      "--- a\n--- b\n--- |\n  c\n...\n",
+      "a\n...\n...\nb\n",
+      "...\n",
+      "# comment\n...\n---\nx\n",
+      "a: &x 1\nb: *x\n...\nc: &x 2\nd: *x\n",
+      "%TAG !e! tag:example.com,2000:\n--- !e!foo a\n--- !e!foo b\n",
+      "a\n...\n%YAML 1.2\n---\nb\n--- !!str c\n",
+      "key: |\n  text\n---\n  - x\n",
+      "a\n... # done\n\n--- b\n",
+      "a\n... c\n",
+      "\xEF\xBB\xBF" "a: 1\n---\nb: 2\n",
+      "a\n...\n\xC3\xA9: 1\n",
+      "a\r\n---\r\nb\r\n...\r\nc\r\n",
+      "a\n---\nb\n%not a directive\n---\nc\n",
+      "[a,\n b]\n---\n{c: d,\n e: f}\n",
+      "a: |\n  chunk\n\n  chunk\n...\nb: >\n  more\n",
+      "- &a [b, {c: d}, e: f, : g]\n- *a\n- ? h\n  : i\n- !!str\n- &j\n",
+      // UTF-16LE, with a character outside the BMP (a surrogate pair)
+      std::string("\xFF\xFE" "a\0:\0 \0\x3D\xD8\x00\xDE\n\0-\0-\0-\0\n\0"
+                  "b\0\n\0", 26),
+  };
+  for (const std::string& input : inputs) {
+    const std::vector<std::string> expected = PullEvents(input);
+    for (std::size_t pieceSize : {1, 2, 5, 4096}) {
+      EXPECT_EQ(expected, PushEvents(input, pieceSize))
+          << "\"" << input << "\" in pieces of " << pieceSize;
+    }
+  }
+}
+
+TEST(PushParserTest, SameErrorsAsParser) {
+  const std::string inputs[] = {
+      "\"a\n---\nb\"\n",
+      "  x: |\n  lit\n  ---\n  y: 1\n...\n  z: [\n",
+      "a\n...\n[b\n...\nc\n",
+      "a: 1\n---\nb: 2\n  c: 3\n---\nd\n",
+      "- a\n...\n%YAML 1.2\n%YAML 1.2\n---\nb\n",
+      "a\n---\n{b: c\n",
+      "a: |\n  text\n\tb\n",
+      std::string(600, '['),
+  };
+  for (const std::string& input : inputs) {
+    const std::vector<std::string> expected = PullEvents(input);
+    ASSERT_FALSE(expected.empty());
+    EXPECT_EQ(0u, expected.back().find("ERROR ")) << "\"" << input << "\"";
+    for (std::size_t pieceSize : {1, 2, 5, 4096}) {
+      EXPECT_EQ(expected, PushEvents(input, pieceSize))
+          << "\"" << input << "\" in pieces of " << pieceSize;
+    }
+  }
+}
+
+TEST(PushParserTest, SameChunksAsParser) {
+  const std::string inputs[] = {
+      "a: |\n  chunk\n\n  chunk\n...\nb: >\n  more\n",
+      "- |+\n  one\n  two\n\n- >-\n  three\n  four\n---\n|\n  five\n",
+      "a: |\n  text\n  more text\n\tb\n",
+  };
+  for (const std::string& input : inputs) {
+    const std::vector<std::string> expected = PullEvents(input, 3);
+    for (std::size_t pieceSize : {1, 2, 5, 4096}) {
+      EXPECT_EQ(expected, PushEvents(input, pieceSize, 3))
+          << "\"" << input << "\" in pieces of " << pieceSize;
+    }
+  }
+}
+
+TEST(PushParserTest, HandlesEventsBeforeTheDocumentEnds) {
+  const std::string input = "a: 1\nb: [2, 3]\nc: 4\n";
+  RecordingHandler handler;
+  PushParser parser(handler);
+
+  EXPECT_EQ(0u, parser.feed(input.data(), input.size()));
+  EXPECT_LT(2u, handler.events.size());
+  EXPECT_EQ(1u, parser.finish());
+  EXPECT_EQ(PullEvents(input), handler.events);
+}
+
+TEST(PushParserTest, HandlesDocumentsAsSoonAsTheyEnd) {
+  RecordingHandler handler;
+  PushParser parser(handler);
+
+  EXPECT_EQ(0u, parser.feed("a: 1\n", 5));
+  EXPECT_EQ(0u, parser.feed("..", 2));
+  EXPECT_EQ(1u, parser.feed(".\nb: ", 5));
+  EXPECT_EQ(0u, parser.feed("2\n", 2));
+  EXPECT_EQ(1u, parser.feed("---\nc", 5));
+  EXPECT_EQ(1u, parser.finish());
+  EXPECT_EQ(0u, parser.finish());
+  EXPECT_EQ(3u, handler.documents);
+}
+
+TEST(PushParserTest, ThrowsOnErrorsAndTakesNoMoreInput) {
+  RecordingHandler handler;
+  PushParser parser(handler);
+
+  EXPECT_EQ(1u, parser.feed("a\n...\n", 6));
+  EXPECT_THROW(parser.feed("b: c: d\n...\n", 12), ParserException);
+  EXPECT_EQ(0u, parser.feed("e\n...\n", 6));
+  EXPECT_EQ(0u, parser.finish());
+  EXPECT_EQ(2u, handler.documents);
+}
+}  // namespace
+}  // namespace YAML
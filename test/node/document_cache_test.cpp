@@ -0,0 +1,166 @@
+#include "yaml-cpp/node/document_cache.h"
+#include "yaml-cpp/exceptions.h"
+#include "yaml-cpp/node/convert.h"
+#include "yaml-cpp/node/detail/impl.h"
+#include "yaml-cpp/node/impl.h"
+#include "yaml-cpp/node/node.h"
+
+#include "gtest/gtest.h"
+#include "temp_files.h"
+
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace YAML {
+namespace {
+TEST(DocumentCacheTest, SharesDocuments) {
+  const std::string filename =
+      WriteTempFile("document_cache_a.yaml", ItemsDocument(10));
+  const std::string copy =
+      WriteTempFile("document_cache_b.yaml", ItemsDocument(10));
+  DocumentCache cache;
+
+  const std::shared_ptr<const Node> pDocument = cache.Get(filename);
+  ASSERT_TRUE(pDocument);
+  EXPECT_EQ(10, (*pDocument)["items"].size());
+  EXPECT_EQ(pDocument, cache.Get(filename));
+  // (the same contents, so the same document)
+  EXPECT_EQ(pDocument, cache.Get(copy));
+  EXPECT_EQ(2, cache.size());
+
+  std::remove(filename.c_str());
+  std::remove(copy.c_str());
+}
+
+TEST(DocumentCacheTest, ReloadsChangedFiles) {
+  const std::string filename =
+      WriteTempFile("document_cache_a.yaml", ItemsDocument(10));
+  DocumentCache cache;
+
+  const std::shared_ptr<const Node> pDocument = cache.Get(filename);
+  WriteTempFile("document_cache_a.yaml", ItemsDocument(20));
+  const std::shared_ptr<const Node> pChanged = cache.Get(filename);
+  EXPECT_NE(pDocument, pChanged);
+  EXPECT_EQ(20, (*pChanged)["items"].size());
+  // (the old one is still whole)
+  EXPECT_EQ(10, (*pDocument)["items"].size());
+  EXPECT_EQ(1, cache.size());
+
+  std::remove(filename.c_str());
+}
+
+TEST(DocumentCacheTest, Invalidates) {
+  const std::string filename =
+      WriteTempFile("document_cache_a.yaml", ItemsDocument(10));
+  const std::string other =
+      WriteTempFile("document_cache_b.yaml", ItemsDocument(5));
+  DocumentCache cache;
+
+  const std::shared_ptr<const Node> pDocument = cache.Get(filename);
+  cache.Get(other);
+  EXPECT_EQ(2, cache.size());
+  EXPECT_LT(0, cache.bytes());
+
+  cache.Invalidate(filename);
+  EXPECT_EQ(1, cache.size());
+  const std::shared_ptr<const Node> pReloaded = cache.Get(filename);
+  EXPECT_NE(pDocument, pReloaded);
+  EXPECT_EQ(10, (*pReloaded)["items"].size());
+
+  cache.Clear();
+  EXPECT_EQ(0, cache.size());
+  EXPECT_EQ(0, cache.bytes());
+
+  std::remove(filename.c_str());
+  std::remove(other.c_str());
+}
+
+TEST(DocumentCacheTest, ThrowsOnBadFiles) {
+  const std::string malformed =
+      WriteTempFile("document_cache_bad.yaml", "a: [unclosed\n");
+  const std::string empty = WriteTempFile("document_cache_empty.yaml", "");
+  DocumentCache cache;
+
+  EXPECT_THROW(cache.Get(::testing::TempDir() + "/missing"), BadFile);
+  EXPECT_THROW(cache.Get(malformed), ParserException);
+  EXPECT_TRUE(cache.Get(empty)->IsNull());
+  EXPECT_EQ(1, cache.size());
+
+  std::remove(empty.c_str());
+  EXPECT_THROW(cache.Get(empty), BadFile);
+  EXPECT_EQ(0, cache.size());
+
+  std::remove(malformed.c_str());
+}
+
+TEST(DocumentCacheTest, EvictsLeastRecentlyUsed) {
+  std::vector<std::string> filenames;
+  for (int i = 0; i < 4; i++) {
+    filenames.push_back(WriteTempFile(
+        "document_cache_" + std::to_string(i) + ".yaml",
+        ItemsDocument(100 + i)));
+  }
+  // (room for about two of them)
+  DocumentCache sizer(0);
+  sizer.Get(filenames[0]);
+  DocumentCache cache(sizer.bytes() * 5 / 2);
+
+  for (const std::string& filename : filenames) {
+    cache.Get(filename);
+    EXPECT_LE(cache.bytes(), sizer.bytes() * 5 / 2);
+  }
+  EXPECT_EQ(2, cache.size());
+
+  // (the newest is kept, even on its own over the limit)
+  DocumentCache tiny(1);
+  EXPECT_EQ(101, (*tiny.Get(filenames[1]))["items"].size());
+  EXPECT_EQ(1, tiny.size());
+  tiny.Get(filenames[2]);
+  EXPECT_EQ(1, tiny.size());
+
+  for (const std::string& filename : filenames) {
+    std::remove(filename.c_str());
+  }
+}
+
+TEST(DocumentCacheTest, SharesBetweenThreads) {
+  std::vector<std::string> filenames;
+  for (int i = 0; i < 8; i++) {
+    filenames.push_back(
+        WriteTempFile("document_cache_" + std::to_string(i) + ".yaml",
+                      ItemsDocument(i * 10)));
+  }
+  DocumentCache cache;
+
+  std::vector<std::vector<std::shared_ptr<const Node>>> seen(4);
+  std::vector<std::thread> threads;
+  for (std::size_t t = 0; t < seen.size(); t++) {
+    threads.emplace_back([&, t] {
+      for (int round = 0; round < 10; round++) {
+        for (const std::string& filename : filenames) {
+          seen[t].push_back(cache.Get(filename));
+        }
+      }
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+
+  for (std::size_t i = 0; i < filenames.size(); i++) {
+    const std::shared_ptr<const Node> pDocument = cache.Get(filenames[i]);
+    EXPECT_EQ(i * 10, (*pDocument)["items"].size());
+    for (const auto& documents : seen) {
+      EXPECT_EQ(pDocument, documents[documents.size() - filenames.size() + i]);
+    }
+  }
+
+  for (const std::string& filename : filenames) {
+    std::remove(filename.c_str());
+  }
+}
+}  // namespace
+}  // namespace YAML
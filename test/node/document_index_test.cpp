@@ -0,0 +1,160 @@
+#include "yaml-cpp/node/document_index.h"
+#include "yaml-cpp/exceptions.h"
+#include "yaml-cpp/node/convert.h"
+#include "yaml-cpp/node/detail/impl.h"
+#include "yaml-cpp/node/emit.h"
+#include "yaml-cpp/node/impl.h"
+#include "yaml-cpp/node/node.h"
+#include "yaml-cpp/node/parse.h"
+
+#include "gtest/gtest.h"
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace YAML {
+namespace {
+// Documents that start in all the ways there are, with directives that
+// carry over to later cuts.
+const char* const kStream =
+    "\xEF\xBB\xBF"
+    "first: 1\n"
+    "---\n"
+    "- second\n"
+    "...\n"
+    "...\n"
+    "# comment\n"
+    "%TAG !e! tag:example.com,2000:\n"
+    "---\n"
+    "third: !e!tagged |\n"
+    "  literal\n"
+    "--- fourth\n"
+    "... fifth\n"
+    "...\n"
+    "\n"
+    "sixth: [a,\n"
+    "  b]\n"
+    "---\n"
+    "!e!seventh {}\n";
+
+void ExpectSameDocuments(const std::string& input) {
+  const std::vector<Node> docs = LoadAll(input);
+  const DocumentIndex index = BuildDocumentIndex(input);
+  ASSERT_EQ(docs.size(), index.size()) << input;
+
+  std::istringstream stream(input);
+  for (std::size_t i = 0; i < docs.size(); i++) {
+    const Node doc = LoadDocument(stream, index, i);
+    EXPECT_EQ(Dump(docs[i]), Dump(doc)) << i;
+    EXPECT_EQ(docs[i].Tag(), doc.Tag()) << i;
+    EXPECT_EQ(docs[i].Mark().pos, doc.Mark().pos) << i;
+    EXPECT_EQ(docs[i].Mark().line, doc.Mark().line) << i;
+    EXPECT_EQ(docs[i].Mark().column, doc.Mark().column) << i;
+  }
+  EXPECT_FALSE(LoadDocument(stream, index, docs.size()).IsDefined());
+}
+
+TEST(DocumentIndexTest, MatchesLoadAll) {
+  ExpectSameDocuments(kStream);
+  EXPECT_EQ(7u, BuildDocumentIndex(kStream).size());
+
+  for (const char* input :
+       {"", "# comment\n", "---\n", "...\n", "a\n...\n...\nb\n",
+        "a\n... b\n", "%YAML 1.2\n---\n", "a\n---\n...\n---\n",
+        "---\n...\n"}) {
+    ExpectSameDocuments(input);
+  }
+
+  // (a stream that can't be cut is parsed from the start)
+  ExpectSameDocuments(std::string("\xFF\xFE" "a\0\n\0-\0-\0-\0\n\0b\0", 16));
+}
+
+TEST(DocumentIndexTest, SaveAndLoad) {
+  const DocumentIndex index = BuildDocumentIndex(kStream);
+  std::stringstream saved;
+  SaveDocumentIndex(index, saved);
+  const DocumentIndex loaded = LoadDocumentIndex(saved);
+  EXPECT_EQ(index.size(), loaded.size());
+
+  std::istringstream stream(kStream);
+  EXPECT_EQ("literal\n",
+            LoadDocument(stream, loaded, 2)["third"].as<std::string>());
+  EXPECT_EQ("tag:example.com,2000:seventh",
+            LoadDocument(stream, loaded, 6).Tag());
+
+  std::istringstream notIndex("a: 1\n");
+  EXPECT_THROW(LoadDocumentIndex(notIndex), BadDocumentIndex);
+  std::string text = saved.str();
+  std::istringstream truncated(text.substr(0, text.size() - 4));
+  EXPECT_THROW(LoadDocumentIndex(truncated), BadDocumentIndex);
+}
+
+TEST(DocumentIndexTest, ChecksTheStream) {
+  const DocumentIndex index = BuildDocumentIndex(kStream);
+  std::istringstream other(std::string(kStream) + "# more\n");
+  EXPECT_THROW(LoadDocument(other, index, 1), BadDocumentIndex);
+  // (the same size, but with the cuts moved)
+  std::string shifted = kStream;
+  shifted.insert(3, "\n");
+  shifted.pop_back();
+  std::istringstream moved(shifted);
+  EXPECT_THROW(LoadDocument(moved, index, 1), BadDocumentIndex);
+
+  // yaml-cpp reads more after a document's root node as another document
+  const std::string stray = "a\n# comment\nb\n---\nc\n";
+  EXPECT_EQ(3u, LoadAll(stray).size());
+  const DocumentIndex strayIndex = BuildDocumentIndex(stray);
+  std::istringstream stream(stray);
+  EXPECT_THROW(LoadDocument(stream, strayIndex, 0), BadDocumentIndex);
+}
+
+TEST(DocumentIndexTest, Files) {
+  const std::string filename = ::testing::TempDir() + "/document_index.yaml";
+  const std::string indexFilename = filename + ".index";
+  {
+    std::ofstream fout(filename, std::ios::binary);
+    fout << kStream;
+  }
+  std::remove(indexFilename.c_str());
+
+  const DocumentIndex built = BuildDocumentIndexFile(filename, indexFilename);
+  EXPECT_TRUE(std::ifstream(indexFilename).good());
+  const DocumentIndex saved = BuildDocumentIndexFile(filename, indexFilename);
+  EXPECT_EQ(built.size(), LoadDocumentIndexFile(indexFilename).size());
+  EXPECT_EQ("fourth", LoadDocument(filename, saved, 3).as<std::string>());
+
+  // the saved index is only used for a file of the same size
+  {
+    std::ofstream fout(filename, std::ios::binary | std::ios::app);
+    fout << "---\neighth\n";
+  }
+  const DocumentIndex rebuilt = BuildDocumentIndexFile(filename, indexFilename);
+  EXPECT_EQ(8u, rebuilt.size());
+  EXPECT_EQ("eighth", LoadDocument(filename, rebuilt, 7).as<std::string>());
+  EXPECT_THROW(LoadDocument(filename, built, 0), BadDocumentIndex);
+
+  // nor one with the same size, but other contents (and the cuts moved)
+  std::string shifted = kStream;
+  shifted.insert(3, "\n");
+  shifted.pop_back();
+  {
+    std::ofstream fout(filename, std::ios::binary);
+    fout << shifted;
+  }
+  const DocumentIndex reshifted =
+      BuildDocumentIndexFile(filename, indexFilename);
+  EXPECT_EQ(7u, reshifted.size());
+  EXPECT_EQ(Dump(LoadAll(shifted)[1]),
+            Dump(LoadDocument(filename, reshifted, 1)));
+  EXPECT_THROW(LoadDocument(filename, built, 1), BadDocumentIndex);
+
+  std::remove(filename.c_str());
+  std::remove(indexFilename.c_str());
+  EXPECT_THROW(BuildDocumentIndexFile(filename), BadFile);
+  EXPECT_THROW(LoadDocument(filename, built, 0), BadFile);
+}
+}  // namespace
+}  // namespace YAML
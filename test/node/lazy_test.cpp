@@ -0,0 +1,187 @@
+#include "yaml-cpp/node/node.h"
+#include "yaml-cpp/exceptions.h"
+#include "yaml-cpp/node/convert.h"
+#include "yaml-cpp/node/detail/impl.h"
+#include "yaml-cpp/node/emit.h"
+#include "yaml-cpp/node/impl.h"
+#include "yaml-cpp/node/parse.h"
+
+#include "gtest/gtest.h"
+
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace YAML {
+namespace {
+// A config with sections big enough to be left lazy, each followed by some
+// small entries; 'broken' is put in the middle of the "routes" section.
+std::string Config(const std::string& broken = "") {
+  std::string config = "name: server\n";
+  config += "env:\n";
+  for (int i = 0; i < 200; i++) {
+    config += "  VAR_" + std::to_string(i) + ": \"value " +
+              std::to_string(i) + "\"  # comment\n";
+  }
+  config += "port: 80\n";
+  config += "routes:\n";
+  for (int i = 0; i < 100; i++) {
+    if (i == 50)
+      config += broken;
+    config += "- path: /v" + std::to_string(i) + "\n";
+    config += "  methods: [GET,\n    POST]\n";
+    config += "  text: |\n    don't \"stop\n";
+  }
+  config += "'quoted key': {a: 1}\n";
+  return config;
+}
+
+TEST(LazyTest, MatchesLoad) {
+  const std::string config = Config();
+  const Node lazy = LoadLazy(config);
+  const Node eager = Load(config);
+
+  EXPECT_EQ("value 7", lazy["env"]["VAR_7"].as<std::string>());
+  EXPECT_EQ(100u, lazy["routes"].size());
+  EXPECT_EQ("/v42", lazy["routes"][42]["path"].as<std::string>());
+  EXPECT_EQ(Dump(eager), Dump(lazy));
+
+  for (const char* key : {"env", "routes", "quoted key"}) {
+    EXPECT_EQ(eager[key].Mark().pos, lazy[key].Mark().pos) << key;
+    EXPECT_EQ(eager[key].Mark().line, lazy[key].Mark().line) << key;
+    EXPECT_EQ(eager[key].Mark().column, lazy[key].Mark().column) << key;
+    EXPECT_EQ(eager[key].Tag(), lazy[key].Tag()) << key;
+  }
+  EXPECT_EQ(eager["routes"][99]["text"].Mark().line,
+            lazy["routes"][99]["text"].Mark().line);
+  EXPECT_EQ(eager["env"]["VAR_199"].Mark().pos,
+            lazy["env"]["VAR_199"].Mark().pos);
+}
+
+TEST(LazyTest, NullsAtTheEndOfARunHaveLoadsMarks) {
+  std::string input = "top:\n  - k: value\n    empty:\n  - big:\n";
+  for (int i = 0; i < 400; i++) {
+    input += "      filler_" + std::to_string(i) + ": x\n";
+  }
+  input += "    last:\n# comment\nafter: 1\n";
+  const Node lazy = LoadLazy(input);
+  const Node eager = Load(input);
+  EXPECT_EQ(Dump(eager), Dump(lazy));
+
+  const Node nulls[][2] = {{eager["top"][0]["empty"], lazy["top"][0]["empty"]},
+                           {eager["top"][1]["last"], lazy["top"][1]["last"]}};
+  for (const auto& pair : nulls) {
+    EXPECT_TRUE(pair[1].IsNull());
+    EXPECT_EQ(pair[0].Mark().pos, pair[1].Mark().pos);
+    EXPECT_EQ(pair[0].Mark().line, pair[1].Mark().line);
+    EXPECT_EQ(pair[0].Mark().column, pair[1].Mark().column);
+  }
+}
+
+TEST(LazyTest, ErrorsAreThrownWhenTouched) {
+  const Node lazy = LoadLazy(Config("- key: value: another\n"));
+  EXPECT_EQ(80, lazy["port"].as<int>());
+  EXPECT_EQ("value 1", lazy["env"]["VAR_1"].as<std::string>());
+  EXPECT_TRUE(lazy["routes"].IsSequence());
+
+  std::string first;
+  try {
+    lazy["routes"].size();
+    FAIL() << "expected a ParserException";
+  } catch (const ParserException& e) {
+    first = e.what();
+  }
+  // and again, the same way
+  EXPECT_THROW(lazy["routes"][0], ParserException);
+  try {
+    Dump(lazy);
+    FAIL() << "expected a ParserException";
+  } catch (const ParserException& e) {
+    EXPECT_EQ(first, e.what());
+  }
+
+  EXPECT_THROW(Load(Config("- key: value: another\n")), ParserException);
+}
+
+TEST(LazyTest, LinesThatEndACollectionEarlyAreErrors) {
+  // each has lines indented less than a big collection, but more than its
+  // parent, which Load doesn't take as part of the collection
+  std::string shallower = "a:\n";
+  std::string underItem = "-   k: v\n";
+  std::string afterSequence = "a:\n  b:\n    - 1\n";
+  for (int i = 0; i < 300; i++) {
+    shallower += "  filler_" + std::to_string(i) + ": x\n";
+    underItem += "  filler_" + std::to_string(i) + ": some value\n";
+    afterSequence += "    key" + std::to_string(i) + ": v\n";
+  }
+  shallower += " bad: indent\n";
+  underItem += "- x\n";
+
+  for (const std::string& input : {shallower, underItem, afterSequence}) {
+    std::string expected;
+    try {
+      Load(input);
+    } catch (const ParserException& e) {
+      expected = e.what();
+    }
+    ASSERT_FALSE(expected.empty());
+
+    try {
+      Dump(LoadLazy(input));
+      ADD_FAILURE() << "expected a ParserException";
+    } catch (const ParserException& e) {
+      EXPECT_EQ(expected, e.what());
+    }
+  }
+}
+
+TEST(LazyTest, CanBeModified) {
+  Node lazy = LoadLazy(Config());
+  lazy["env"]["EXTRA"] = "yes";
+  lazy["routes"].push_back("last");
+  EXPECT_EQ(201u, lazy["env"].size());
+  EXPECT_EQ("last", lazy["routes"][100].as<std::string>());
+
+  lazy["routes"] = 5;
+  EXPECT_EQ(5, lazy["routes"].as<int>());
+}
+
+TEST(LazyTest, SharesBetweenThreads) {
+  const std::string config = Config();
+  const Node lazy = LoadLazy(config);
+
+  // (they all look inside the same collections at once, which parses each
+  // of them once)
+  std::vector<std::string> dumps(4);
+  std::vector<std::thread> threads;
+  for (std::size_t t = 0; t < dumps.size(); t++) {
+    threads.emplace_back([&, t] {
+      EXPECT_EQ(100u, lazy["routes"].size());
+      EXPECT_EQ("value 7", lazy["env"]["VAR_7"].as<std::string>());
+      dumps[t] = Dump(lazy);
+    });
+  }
+  for (std::thread& thread : threads)
+    thread.join();
+
+  for (const std::string& dump : dumps)
+    EXPECT_EQ(Dump(Load(config)), dump);
+}
+
+TEST(LazyTest, LoadsOtherDocumentsLikeLoad) {
+  for (const char* input :
+       {"", "# only a comment\n", "scalar", "[flow, sequence]",
+        "a: &x 1\nb: *x\n", "%YAML 1.2\n---\na: 1\n", "--- {a: 1}\n"}) {
+    EXPECT_EQ(Dump(Load(input)), Dump(LoadLazy(input))) << input;
+  }
+
+  const Node aliased = LoadLazy("a: &x [1]\nb: *x\n");
+  EXPECT_TRUE(aliased["a"].is(aliased["b"]));
+  EXPECT_THROW(LoadLazy("a: [1\n"), ParserException);
+}
+
+TEST(LazyTest, LoadFileLazy) {
+  EXPECT_THROW(LoadFileLazy("doesnotexist.yaml"), BadFile);
+}
+}  // namespace
+}  // namespace YAML
@@ -0,0 +1,151 @@
+#include "yaml-cpp/node/load_files.h"
+#include "inflight.h"
+#include "yaml-cpp/exceptions.h"
+#include "yaml-cpp/node/convert.h"
+#include "yaml-cpp/node/detail/impl.h"
+#include "yaml-cpp/node/emit.h"
+#include "yaml-cpp/node/impl.h"
+#include "yaml-cpp/node/node.h"
+#include "yaml-cpp/node/parse.h"
+
+#include "gtest/gtest.h"
+#include "temp_files.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace YAML {
+namespace {
+class LoadFilesTest : public ::testing::Test {
+ protected:
+  LoadFilesTest() : filenames{} {}
+
+  void SetUp() override {
+    for (int i = 0; i < 20; i++) {
+      filenames.push_back(
+          WriteTempFile("load_files_" + std::to_string(i) + ".yaml",
+                        "file: " + std::to_string(i) + "\n" +
+                            ItemsDocument(i * 10)));
+    }
+  }
+
+  void TearDown() override {
+    for (const std::string& filename : filenames) {
+      std::remove(filename.c_str());
+    }
+  }
+
+  std::vector<std::string> filenames;
+};
+
+TEST_F(LoadFilesTest, LoadsInOrder) {
+  LoadFilesOptions options;
+  options.numThreads = 4;
+  const std::vector<LoadedFile> files = LoadFiles(filenames, options);
+  ASSERT_EQ(filenames.size(), files.size());
+  for (std::size_t i = 0; i < files.size(); i++) {
+    EXPECT_FALSE(files[i].error) << i;
+    EXPECT_EQ(Dump(LoadFile(filenames[i])), Dump(files[i].document)) << i;
+  }
+
+  EXPECT_TRUE(LoadFiles({}).empty());
+}
+
+TEST_F(LoadFilesTest, ReportsErrorsPerFile) {
+  filenames.insert(filenames.begin() + 3,
+                   WriteTempFile("load_files_bad.yaml", "a: [unclosed\n"));
+  filenames.insert(filenames.begin() + 7, ::testing::TempDir() + "/missing");
+  const std::vector<LoadedFile> files = LoadFiles(filenames);
+  ASSERT_EQ(filenames.size(), files.size());
+
+  EXPECT_THROW(std::rethrow_exception(files[3].error), ParserException);
+  EXPECT_THROW(std::rethrow_exception(files[7].error), BadFile);
+  EXPECT_TRUE(files[3].document.IsNull());
+  EXPECT_EQ(3, files[4].document["file"].as<int>());
+  EXPECT_EQ(6, files[8].document["file"].as<int>());
+  EXPECT_FALSE(files[8].error);
+}
+
+TEST_F(LoadFilesTest, LimitsBytesInFlight) {
+  // (every file is over the limit, so each is loaded on its own)
+  LoadFilesOptions options;
+  options.numThreads = 4;
+  options.maxBytesInFlight = 16;
+  const std::vector<LoadedFile> files = LoadFiles(filenames, options);
+  for (std::size_t i = 0; i < files.size(); i++) {
+    EXPECT_EQ(static_cast<int>(i), files[i].document["file"].as<int>());
+    EXPECT_EQ(i * 10, files[i].document["items"].size());
+  }
+}
+
+TEST(InFlightTest, KeepsBytesUnderTheLimit) {
+  // (each thread holds its room for a while, so that they'd overlap)
+  InFlight inFlight(100);
+  std::mutex mutex;
+  std::size_t bytes = 0;
+  std::size_t most = 0;
+  std::size_t alone = 0;  // of the reservations over the limit
+  auto load = [&](std::size_t size) {
+    Reservation reservation(inFlight, size);
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (size > 100 && bytes == 0)
+        alone++;
+      bytes += size;
+      most = std::max(most, bytes);
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    std::lock_guard<std::mutex> lock(mutex);
+    bytes -= size;
+  };
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 8; i++) {
+    threads.emplace_back([&, i] {
+      for (int round = 0; round < 5; round++) {
+        load(i == 0 ? 150 : 40);
+      }
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  EXPECT_LE(most, 150u);
+  EXPECT_EQ(5u, alone);
+  // (and under the limit, two at once fit)
+  EXPECT_GE(most, 80u);
+}
+
+TEST(InFlightTest, GrowsAFileThatCantBeSized) {
+  InFlight inFlight(100);
+  std::unique_ptr<Reservation> pOther(new Reservation(inFlight, 60));
+  std::atomic<std::size_t> grown(0);
+  std::thread reader([&] {
+    GrowingReservation reservation(inFlight);
+    for (int i = 0; i < 4; i++) {
+      reservation.Grow(30);
+      grown += 30;
+    }
+  });
+
+  // there's room for one chunk, and then it waits for the other file
+  for (int i = 0; i < 1000 && grown < 30; i++)
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  EXPECT_EQ(30u, grown.load());
+
+  // and alone, it can go over the limit
+  pOther.reset();
+  reader.join();
+  EXPECT_EQ(120u, grown.load());
+  Reservation after(inFlight, 100);
+}
+}  // namespace
+}  // namespace YAML
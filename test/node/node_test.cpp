@@ -5,11 +5,15 @@
 #include "yaml-cpp/node/emit.h"
 #include "yaml-cpp/node/impl.h"
 #include "yaml-cpp/node/iterator.h"
+#include "yaml-cpp/node/parse.h"
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 
+#include <cmath>
 #include <sstream>
+#include <string>
+#include <vector>
 
 namespace {
 
@@ -645,6 +649,111 @@ TEST(NodeTest, AccessNonexistentKeyOnConstNode) {
   ASSERT_FALSE(other["5"]);
 }
 
+// (what DecodeNumber did before it read plain decimals itself)
+template <typename T>
+bool DecodeNumberWithStream(const std::string& input, T& rhs) {
+  std::stringstream stream(input);
+  stream.unsetf(std::ios::dec);
+  if ((stream.peek() == '-') && std::is_unsigned<T>::value)
+    return false;
+  return conversion::ConvertStreamTo(stream, rhs);
+}
+
+template <typename T>
+void ExpectDecodedLikeStream(const std::string& input) {
+  T expected = T(), actual = T();
+  const bool decoded = DecodeNumberWithStream(input, expected);
+  ASSERT_EQ(decoded, conversion::DecodeNumber(input, actual)) << input;
+  if (decoded) {
+    EXPECT_EQ(expected, actual) << input;
+    EXPECT_EQ(std::signbit(expected), std::signbit(actual)) << input;
+  }
+}
+
+template <typename T>
+void ExpectDecodedLikeStream(const std::vector<std::string>& inputs) {
+  for (const std::string& input : inputs)
+    ExpectDecodedLikeStream<T>(input);
+}
+
+TEST(NodeTest, DecodeNumberReadsDecimalsLikeTheStream) {
+  std::vector<std::string> inputs = {
+      "0",           "-0",          "007",          "0x1F",
+      "+5",          "5 ",          "",             "-",
+      "1.",          ".5",          "1e",           "1e+",
+      "2147483647",  "2147483648",  "-2147483648",  "-2147483649",
+      "4294967295",  "4294967296",  "-1",           "9007199254740993",
+      "1e22",        "1e23",        "1e-22",        "1e-23",
+      "123456789e-5", "0.000001",   "1E+5",         "-0.0",
+      "18446744073709551615",       "18446744073709551616",
+      "9223372036854775807",        "-9223372036854775808",
+      "-9223372036854775809",       "1e400",        "1e-400"};
+
+  // and some pseudo-random ones
+  unsigned seed = 1;
+  auto next = [&seed](unsigned n) {
+    seed = seed * 1103515245 + 12345;
+    return (seed >> 16) % n;
+  };
+  for (int i = 0; i < 2000; i++) {
+    std::string input = next(4) == 0 ? "-" : "";
+    for (unsigned j = next(20) + 1; j > 0; j--)
+      input += static_cast<char>('0' + next(10));
+    if (next(2) == 0) {
+      input += '.';
+      for (unsigned j = next(10) + 1; j > 0; j--)
+        input += static_cast<char>('0' + next(10));
+    }
+    if (next(3) == 0)
+      input += "e" + std::to_string(static_cast<int>(next(60)) - 30);
+    inputs.push_back(input);
+  }
+
+  ExpectDecodedLikeStream<short>(inputs);
+  ExpectDecodedLikeStream<int>(inputs);
+  ExpectDecodedLikeStream<unsigned>(inputs);
+  ExpectDecodedLikeStream<long long>(inputs);
+  ExpectDecodedLikeStream<unsigned long long>(inputs);
+  ExpectDecodedLikeStream<float>(inputs);
+  ExpectDecodedLikeStream<double>(inputs);
+  ExpectDecodedLikeStream<long double>(inputs);
+}
+
+TEST(NodeTest, AsArray) {
+  Node node = Load("[1, 2.5, -3e2, .inf, 010]");
+  std::vector<double> numbers = {7};
+  node.as_array(numbers);
+  EXPECT_EQ(node.as<std::vector<double>>(), numbers);
+
+  std::vector<std::string> strings;
+  node.as_array(strings);
+  EXPECT_EQ((std::vector<std::string>{"1", "2.5", "-3e2", ".inf", "010"}),
+            strings);
+
+  std::vector<std::vector<int>> nested;
+  Load("[[1, 2], [], [3]]").as_array(nested);
+  EXPECT_EQ((std::vector<std::vector<int>>{{1, 2}, {}, {3}}), nested);
+}
+
+TEST(NodeTest, AsArrayReportsFirstBadElement) {
+  std::vector<int> numbers;
+  try {
+    Load("[1, 2,\n x, [4], 5]").as_array(numbers);
+    FAIL() << "expected TypedBadElementConversion";
+  } catch (const TypedBadElementConversion<int>& e) {
+    EXPECT_EQ(2u, e.index);
+#ifndef YAML_CPP_NO_NODE_MARKS
+    EXPECT_EQ(1, e.mark.line);
+    EXPECT_EQ(1, e.mark.column);
+#endif
+  }
+  EXPECT_EQ((std::vector<int>{1, 2}), numbers);
+
+  EXPECT_THROW(Load("{a: 1}").as_array(numbers),
+               TypedBadConversion<std::vector<int>>);
+  EXPECT_THROW(Load("[[1]]").as_array(numbers), TypedBadConversion<int>);
+}
+
 class NodeEmitterTest : public ::testing::Test {
  protected:
   void ExpectOutput(const std::string& output, const Node& node) {
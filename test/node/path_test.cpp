@@ -0,0 +1,249 @@
+#include "yaml-cpp/node/path.h"
+#include "yaml-cpp/exceptions.h"
+#include "yaml-cpp/node/convert.h"
+#include "yaml-cpp/node/detail/impl.h"
+#include "yaml-cpp/node/emit.h"
+#include "yaml-cpp/node/impl.h"
+#include "yaml-cpp/node/node.h"
+#include "yaml-cpp/node/parse.h"
+
+#include "gtest/gtest.h"
+
+#include <string>
+#include <vector>
+
+namespace YAML {
+namespace {
+const char* const kDocument =
+    "metadata:\n"
+    "  name: api\n"
+    "  labels: {app.kubernetes.io/name: api, tier: back end}\n"
+    "spec:\n"
+    "  template:\n"
+    "    containers:\n"
+    "    - name: web\n"
+    "      image: nginx:1.25\n"
+    "      ports: [80, 443]\n"
+    "    - name: sidecar\n"
+    "      image: envoy:1.29\n"
+    "      ports: [9901]\n"
+    "    - name: init\n"
+    "      command: [sh]\n"
+    "  replicas: 3\n";
+
+std::vector<std::string> Scalars(const std::string& path, const Node& root) {
+  std::vector<std::string> scalars;
+  for (const Node& node : Path(path).Select(root)) {
+    scalars.push_back(node.IsScalar() ? node.Scalar() : Dump(node));
+  }
+  return scalars;
+}
+
+using Strings = std::vector<std::string>;
+
+TEST(PathTest, KeysAndIndices) {
+  const Node root = Load(kDocument);
+  EXPECT_EQ(Strings{"nginx:1.25"},
+            Scalars("spec.template.containers[0].image", root));
+  EXPECT_EQ(Strings{"nginx:1.25"},
+            Scalars("$.spec.template.containers[0].image", root));
+  EXPECT_EQ(Strings{"[sh]"}, Scalars("spec.template.containers[-1].command",
+                                     root));
+  EXPECT_EQ(Strings{"api"},
+            Scalars("metadata.labels['app.kubernetes.io/name']", root));
+  EXPECT_EQ(Strings{"back end"}, Scalars("metadata.labels[\"tier\"]", root));
+  EXPECT_EQ(Strings{"3"}, Scalars("spec.replicas", root));
+
+  // nothing, rather than an error, for what isn't there
+  EXPECT_TRUE(Scalars("spec.missing.image", root).empty());
+  EXPECT_TRUE(Scalars("spec.template.containers[3]", root).empty());
+  EXPECT_TRUE(Scalars("spec.template.containers[-4]", root).empty());
+  EXPECT_TRUE(Scalars("spec.replicas.value", root).empty());
+  EXPECT_TRUE(Scalars("spec[0]", root).empty());
+
+  const Node all = Path("$").SelectFirst(root);
+  EXPECT_TRUE(all.is(root));
+}
+
+TEST(PathTest, WildcardsAndDescendants) {
+  const Node root = Load(kDocument);
+  EXPECT_EQ((Strings{"nginx:1.25", "envoy:1.29"}),
+            Scalars("spec.template.containers[*].image", root));
+  EXPECT_EQ((Strings{"nginx:1.25", "envoy:1.29"}), Scalars("..image", root));
+  EXPECT_EQ((Strings{"api", "web", "sidecar", "init"}),
+            Scalars("..name", root));
+  EXPECT_EQ((Strings{"api", "back end"}), Scalars("metadata.labels.*", root));
+  EXPECT_EQ((Strings{"80", "9901"}), Scalars("..ports[0]", root));
+  EXPECT_EQ(3u, Scalars("spec.template.containers[0].*", root).size());
+  EXPECT_EQ(24u, Path("..*").Select(root).size());
+}
+
+TEST(PathTest, Filters) {
+  const Node root = Load(kDocument);
+  EXPECT_EQ(Strings{"envoy:1.29"},
+            Scalars("spec.template.containers[?(@.name == 'sidecar')].image",
+                    root));
+  EXPECT_EQ(Strings{"[80, 443]"},
+            Scalars("..containers[?(@.image==\"nginx:1.25\")].ports", root));
+  EXPECT_EQ((Strings{"web", "sidecar"}),
+            Scalars("..containers[?(@.image)].name", root));
+  EXPECT_EQ((Strings{"web", "init"}),
+            Scalars("..containers[?(@.name != sidecar)].name", root));
+  // (one without the key doesn't count as "not equal")
+  EXPECT_EQ(Strings{"sidecar"},
+            Scalars("..containers[?(@.image != nginx:1.25)].name", root));
+  EXPECT_EQ(Strings{"web"},
+            Scalars("..containers[?(@.ports[*] == 443)].name", root));
+  EXPECT_EQ(Strings{"443"}, Scalars("..ports[?(@ == 443)]", root));
+}
+
+TEST(PathTest, SelectIntoAndFirst) {
+  const Node root = Load(kDocument);
+  const Path path("..image");
+  std::vector<Node> matches;
+  matches.reserve(8);
+  EXPECT_EQ(2u, path.Select(root, matches));
+  EXPECT_EQ(2u, path.Select(root, matches));
+  EXPECT_EQ(4u, matches.size());
+
+  EXPECT_EQ("nginx:1.25", path.SelectFirst(root).as<std::string>());
+  const Node missing = Path("spec.missing").SelectFirst(root);
+  EXPECT_FALSE(missing);
+  EXPECT_THROW(missing.as<std::string>(), InvalidNode);
+  EXPECT_THROW(path.Select(root["nothing"]["here"]), InvalidNode);
+
+  // the nodes are the document's own
+  Node image = path.SelectFirst(root);
+  image = "nginx:1.26";
+  EXPECT_EQ("nginx:1.26", root["spec"]["template"]["containers"][0]["image"]
+                              .as<std::string>());
+}
+
+TEST(PathTest, LazyDocuments) {
+  std::string input = "items:\n";
+  for (int i = 0; i < 1000; i++) {
+    input += "- {id: " + std::to_string(i) + "}\n";
+  }
+  const Node root = LoadLazy(input);
+  EXPECT_EQ(Strings{"999"}, Scalars("items[-1].id", root));
+  EXPECT_EQ(Strings{"500"}, Scalars("items[?(@.id == 500)].id", root));
+}
+
+// A document with a section big enough to be left lazy; 'broken' is put in
+// the middle of it.
+std::string Manifest(const std::string& broken = "") {
+  std::string manifest = kDocument;
+  manifest += "data:\n";
+  for (int i = 0; i < 300; i++) {
+    if (i == 150)
+      manifest += broken;
+    manifest += "  key" + std::to_string(i) + ": [value, " +
+                std::to_string(i) + "]\n";
+  }
+  manifest += "status: {ready: true}\n";
+  return manifest;
+}
+
+TEST(LoadProjectedTest, KeepsJustWhatIsSelected) {
+  const std::vector<Path> paths = {
+      Path("metadata.name"), Path("spec.template.containers[1].image"),
+      Path("data.key299[1]"), Path("status")};
+  const Node full = Load(Manifest());
+  const Node projected = LoadProjected(Manifest(), paths);
+
+  for (const Path& path : paths) {
+    const std::vector<Node> expected = path.Select(full);
+    const std::vector<Node> actual = path.Select(projected);
+    ASSERT_EQ(1u, actual.size()) << path.Expression();
+    EXPECT_EQ(Dump(expected[0]), Dump(actual[0])) << path.Expression();
+    EXPECT_EQ(expected[0].Mark().line, actual[0].Mark().line);
+    EXPECT_EQ(expected[0].Mark().column, actual[0].Mark().column);
+  }
+
+  EXPECT_EQ(
+      "metadata:\n"
+      "  name: api\n"
+      "spec:\n"
+      "  template:\n"
+      "    containers:\n"
+      "      - ~\n"
+      "      - image: envoy:1.29\n"
+      "      - ~\n"
+      "data:\n"
+      "  key299: [~, 299]\n"
+      "status: {ready: true}",
+      Dump(projected));
+  EXPECT_EQ(full["spec"].Mark().line, projected["spec"].Mark().line);
+}
+
+TEST(LoadProjectedTest, NegativeIndices) {
+  std::string input = "a:\n";
+  for (int i = 0; i < 500; i++) {
+    input += "- {id: " + std::to_string(i) + "}\n";
+  }
+  const Node full = Load(input);
+
+  for (const char* expression : {"a[-2]", "a[-2].id", "a[0]", "a[-500].id"}) {
+    const Path path(expression);
+    const Node projected = LoadProjected(input, {path});
+    const std::vector<Node> expected = path.Select(full);
+    const std::vector<Node> actual = path.Select(projected);
+    ASSERT_EQ(1u, actual.size()) << expression;
+    EXPECT_EQ(Dump(expected[0]), Dump(actual[0])) << expression;
+    EXPECT_EQ(500u, projected["a"].size()) << expression;
+  }
+}
+
+TEST(LoadProjectedTest, WildcardsAndOverlappingPaths) {
+  const Node projected = LoadProjected(
+      kDocument, {Path("spec.template.containers[*].name"),
+                  Path("metadata"), Path("metadata.labels.tier"),
+                  Path("spec.missing")});
+  EXPECT_EQ(Dump(Load(kDocument)["metadata"]), Dump(projected["metadata"]));
+  EXPECT_EQ(
+      "- name: web\n"
+      "- name: sidecar\n"
+      "- name: init",
+      Dump(projected["spec"]["template"]["containers"]));
+  EXPECT_EQ(2u, projected.size());
+
+  EXPECT_EQ("{}", Dump(LoadProjected(kDocument, {Path("nothing")})));
+  EXPECT_EQ(Dump(Load(kDocument)), Dump(LoadProjected(kDocument, {Path("$")})));
+}
+
+TEST(LoadProjectedTest, OnlyParsesWhatItNeeds) {
+  const std::string broken = Manifest("  key: value: another\n");
+  EXPECT_THROW(Load(broken), ParserException);
+  const Node projected = LoadProjected(broken, {Path("status.ready")});
+  EXPECT_TRUE(projected["status"]["ready"].as<bool>());
+  EXPECT_THROW(LoadProjected(broken, {Path("data.key0")}), ParserException);
+
+  EXPECT_THROW(LoadFileProjected("doesnotexist.yaml", {Path("a")}), BadFile);
+}
+
+TEST(LoadProjectedTest, LinesThatEndACollectionEarlyAreErrors) {
+  std::string input = "a:\n  b:\n    - 1\n";
+  for (int i = 0; i < 300; i++) {
+    input += "    key" + std::to_string(i) + ": v\n";
+  }
+  EXPECT_THROW(Load(input), ParserException);
+  // (the selected sequence is only parsed when it's read)
+  EXPECT_THROW(Dump(LoadProjected(input, {Path("a.b")})), ParserException);
+}
+
+TEST(PathTest, BadPaths) {
+  for (const char* expression :
+       {"a.", "a..", "a[", "a[x]", "a[0", "a['b]", "a[?(b)]", "a[?(@.b == )]",
+        "a[?(@.b = c)]", "a b", "a]"}) {
+    EXPECT_THROW(Path{expression}, BadPath) << expression;
+  }
+  try {
+    Path("spec.[0]");
+    FAIL() << "expected a BadPath";
+  } catch (const BadPath& e) {
+    EXPECT_EQ(std::string("bad path: expected a key at 6 in \"spec.[0]\""),
+              e.what());
+  }
+}
+}  // namespace
+}  // namespace YAML
@@ -0,0 +1,185 @@
+#include "yaml-cpp/snapshot.h"
+#include "yaml-cpp/node/detail/impl.h"
+#include "yaml-cpp/node/emit.h"
+#include "yaml-cpp/node/parse.h"
+#include "sha256.h"
+
+#include "gtest/gtest.h"
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace YAML {
+namespace {
+const char* const kDocument =
+    "name: &n server\n"
+    "ports: !ports [80, 443]\n"
+    "limits: {rps: 100, burst: 20}\n"
+    "alias: *n\n"
+    "text: |\n"
+    "  two\n"
+    "  lines\n"
+    "empty: ~\n";
+
+std::string Snapshot(const Tape& tape, bool withMarks = true) {
+  std::stringstream stream;
+  SaveSnapshot(tape, stream, withMarks);
+  return stream.str();
+}
+
+Tape Restore(const std::string& snapshot) {
+  std::stringstream stream(snapshot);
+  return LoadSnapshot(stream);
+}
+
+TEST(SnapshotTest, RoundTrip) {
+  const Tape tape = Restore(Snapshot(LoadTape(kDocument)));
+  const TapeNode root = tape.Root();
+
+  EXPECT_EQ("server", root.find("alias").Scalar());
+  EXPECT_EQ("!ports", root.find("ports").Tag());
+  EXPECT_EQ(EmitterStyle::Flow, root.find("limits").Style());
+  EXPECT_EQ("two\nlines\n", root.find("text").Scalar());
+  EXPECT_EQ(1, root.find("ports").Mark().line);
+  EXPECT_EQ(8, root.find("limits").Mark().column);
+  EXPECT_EQ(LoadTape(kDocument).Root().find("text").Mark().pos,
+            root.find("text").Mark().pos);
+  EXPECT_EQ(Dump(Load(kDocument)), Dump(root.ToNode()));
+
+  const Node node = root.ToNode();
+  EXPECT_TRUE(node["name"].is(node["alias"]));
+}
+
+TEST(SnapshotTest, FromMemory) {
+  const std::string snapshot = Snapshot(LoadTape(kDocument));
+  const Tape tape = LoadSnapshot(snapshot.data(), snapshot.size());
+  EXPECT_EQ(Dump(Load(kDocument)), Dump(tape.Root().ToNode()));
+  EXPECT_THROW(LoadSnapshot(snapshot.data(), 10), BadSnapshot);
+}
+
+TEST(SnapshotTest, WithoutMarks) {
+  const std::string withMarks = Snapshot(LoadTape(kDocument));
+  const std::string snapshot = Snapshot(LoadTape(kDocument), false);
+  EXPECT_LT(snapshot.size(), withMarks.size());
+
+  const Tape tape = Restore(snapshot);
+  EXPECT_TRUE(tape.Root().find("ports").Mark().is_null());
+  EXPECT_EQ(Dump(Load(kDocument)), Dump(tape.Root().ToNode()));
+}
+
+TEST(SnapshotTest, Empty) {
+  EXPECT_FALSE(Restore(Snapshot(LoadTape(""))).Root());
+  EXPECT_FALSE(Restore(Snapshot(Tape())).Root());
+}
+
+TEST(SnapshotTest, RejectsBadSnapshots) {
+  const std::string snapshot = Snapshot(LoadTape(kDocument));
+
+  EXPECT_THROW(Restore(""), BadSnapshot);
+  EXPECT_THROW(Restore(kDocument), BadSnapshot);
+  EXPECT_THROW(Restore(snapshot.substr(0, snapshot.size() - 1)), BadSnapshot);
+
+  std::string version = snapshot;
+  version[8] = 1;
+  EXPECT_THROW(Restore(version), BadSnapshot);
+
+  // every byte of the payload is covered by the checksum
+  for (std::size_t i = 80; i < snapshot.size(); i += 7) {
+    std::string damaged = snapshot;
+    damaged[i] ^= 0x10;
+    EXPECT_THROW(Restore(damaged), BadSnapshot) << "at " << i;
+  }
+}
+
+// The name of the cache's snapshot of a file with 'contents' (its key is
+// their SHA-256 digest).
+std::string CacheFilename(const std::string& directory,
+                          const std::string& contents) {
+  return directory + "/" + ToHex(Sha256(contents.data(), contents.size())) +
+         ".snapshot";
+}
+
+bool Exists(const std::string& filename) {
+  return std::ifstream(filename).good();
+}
+
+TEST(SnapshotTest, LoadFileUsesTheCache) {
+  const std::string directory = ::testing::TempDir();
+  const std::string filename = directory + "/snapshot_test.yaml";
+  const std::string snapshot = CacheFilename(directory, kDocument);
+  {
+    std::ofstream fout(filename);
+    fout << kDocument;
+  }
+  std::remove(snapshot.c_str());
+
+  const Node uncached = LoadFile(filename);
+  EXPECT_FALSE(Exists(snapshot));
+
+  SetSnapshotCacheDirectory(directory);
+  const Node first = LoadFile(filename);
+  EXPECT_TRUE(Exists(snapshot));
+  const Node second = LoadFile(filename);
+
+  // a damaged snapshot is replaced
+  {
+    std::fstream file(snapshot, std::ios::in | std::ios::out |
+                                    std::ios::binary);
+    file.seekp(100);
+    file.put('?');
+  }
+  const Node third = LoadFile(filename);
+  EXPECT_NO_THROW(LoadSnapshotFile(snapshot));
+  SetSnapshotCacheDirectory("");
+  std::remove(filename.c_str());
+  std::remove(snapshot.c_str());
+
+  for (const Node& node : {uncached, first, second, third}) {
+    EXPECT_EQ(Dump(Load(kDocument)), Dump(node));
+#ifndef YAML_CPP_NO_NODE_MARKS
+    EXPECT_EQ(2, node["limits"].Mark().line);
+#endif
+    EXPECT_TRUE(node["name"].is(node["alias"]));
+  }
+}
+
+TEST(SnapshotTest, WritersDontShareTemporaryFiles) {
+  const std::string directory = ::testing::TempDir();
+  const std::string filename = directory + "/snapshot_writers.yaml";
+  std::string contents;
+  for (int i = 0; i < 2000; i++)
+    contents += "- {id: " + std::to_string(i) + ", name: item}\n";
+  {
+    std::ofstream fout(filename);
+    fout << contents;
+  }
+  const std::string snapshot = CacheFilename(directory, contents);
+  std::remove(snapshot.c_str());
+
+  // (each one misses the cache, so they all write the snapshot at once)
+  SetSnapshotCacheDirectory(directory);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; t++) {
+    threads.emplace_back([&] {
+      for (int round = 0; round < 5; round++) {
+        std::remove(snapshot.c_str());
+        EXPECT_EQ(2000, LoadFile(filename).size());
+      }
+    });
+  }
+  for (std::thread& thread : threads)
+    thread.join();
+  SetSnapshotCacheDirectory("");
+
+  EXPECT_EQ(2000, LoadFile(filename).size());
+  ASSERT_TRUE(Exists(snapshot));
+  EXPECT_EQ(2000, LoadSnapshotFile(snapshot).Root().size());
+  std::remove(filename.c_str());
+  std::remove(snapshot.c_str());
+}
+}  // namespace
+}  // namespace YAML
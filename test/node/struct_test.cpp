@@ -0,0 +1,104 @@
+#include "yaml-cpp/node/struct.h"
+#include "yaml-cpp/node/emit.h"
+#include "yaml-cpp/node/parse.h"
+
+#include "gtest/gtest.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace test {
+struct Limits {
+  int rps = 0;
+  int burst = 0;
+};
+
+struct Service {
+  std::string name;
+  bool enabled = false;
+  double timeout = 1.5;
+  Limits limits;
+  std::vector<std::string> tags;
+  std::map<std::string, int> ports;
+};
+}  // namespace test
+
+YAML_DEFINE_STRUCT(test::Limits, rps, burst)
+YAML_DEFINE_STRUCT(test::Service, name, enabled, timeout, limits, tags, ports)
+
+namespace YAML {
+namespace {
+TEST(StructTest, Decode) {
+  Node node = Load(
+      "tags: [a, b]\n"
+      "unknown: {x: 1}\n"
+      "name: api\n"
+      "limits: {burst: 20, rps: 100}\n"
+      "[complex]: key\n"
+      "ports: {http: 80}\n"
+      "enabled: true\n");
+  test::Service service = node.as<test::Service>();
+
+  EXPECT_EQ("api", service.name);
+  EXPECT_TRUE(service.enabled);
+  EXPECT_EQ(1.5, service.timeout);
+  EXPECT_EQ(100, service.limits.rps);
+  EXPECT_EQ(20, service.limits.burst);
+  EXPECT_EQ((std::vector<std::string>{"a", "b"}), service.tags);
+  EXPECT_EQ((std::map<std::string, int>{{"http", 80}}), service.ports);
+}
+
+TEST(StructTest, DecodeErrors) {
+  EXPECT_THROW(Load("[1, 2]").as<test::Limits>(),
+               TypedBadConversion<test::Limits>);
+  EXPECT_THROW(Load("{rps: lots}").as<test::Limits>(),
+               TypedBadConversion<test::Limits>);
+}
+
+TEST(StructTest, DecodeReturnsFalseForBadFields) {
+  test::Service service;
+  EXPECT_FALSE(convert<test::Service>::decode(Load("{timeout: [1]}"), service));
+  EXPECT_FALSE(
+      convert<test::Service>::decode(Load("{limits: {burst: x}}"), service));
+  EXPECT_FALSE(convert<test::Service>::decode(Load("{tags: a}"), service));
+  EXPECT_TRUE(convert<test::Service>::decode(Load("{timeout: 2}"), service));
+  EXPECT_EQ(2, service.timeout);
+  EXPECT_TRUE(convert<test::Service>::decode(Load("{timeout: ~}"), service));
+  EXPECT_EQ(2, service.timeout);
+}
+
+TEST(StructTest, EncodeKeepsFieldOrder) {
+  test::Limits limits;
+  limits.rps = 1;
+  limits.burst = 2;
+
+  Node node(limits);
+  ASSERT_TRUE(node.IsMap());
+  EXPECT_EQ("rps: 1\nburst: 2", Dump(node));
+}
+
+TEST(StructTest, RoundTrip) {
+  test::Service service;
+  service.name = "api";
+  service.timeout = 0.25;
+  service.tags = {"x"};
+  service.ports = {{"https", 443}};
+
+  test::Service copy = Load(Dump(Node(service))).as<test::Service>();
+  EXPECT_EQ(service.name, copy.name);
+  EXPECT_EQ(service.enabled, copy.enabled);
+  EXPECT_EQ(service.timeout, copy.timeout);
+  EXPECT_EQ(service.tags, copy.tags);
+  EXPECT_EQ(service.ports, copy.ports);
+}
+
+TEST(StructTest, Binding) {
+  test::Service service;
+  ASSERT_TRUE(LoadInto("name: api\nlimits: {rps: 5}\n", service));
+  EXPECT_EQ("api", service.name);
+  EXPECT_EQ(5, service.limits.rps);
+  EXPECT_EQ(0, service.limits.burst);
+}
+}  // namespace
+}  // namespace YAML
@@ -0,0 +1,148 @@
+#include "yaml-cpp/tape.h"
+#include "yaml-cpp/node/detail/impl.h"
+#include "yaml-cpp/node/emit.h"
+#include "yaml-cpp/node/parse.h"
+
+#include "gtest/gtest.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace YAML {
+namespace {
+const char* const kDocument =
+    "name: server\n"
+    "ports: [80, 443]\n"
+    "limits:\n"
+    "  rps: 100\n"
+    "  burst: 20\n"
+    "enabled: true\n"
+    "timeout: 1.5\n"
+    "empty: ~\n"
+    "tagged: !custom value\n";
+
+TEST(TapeTest, Find) {
+  const Tape tape = LoadTape(kDocument);
+  const TapeNode root = tape.Root();
+
+  ASSERT_TRUE(root.IsMap());
+  EXPECT_EQ(7u, root.size());
+  EXPECT_EQ("server", root.find("name").Scalar());
+  EXPECT_EQ(100, root.find("limits").find("rps").as<int>());
+  EXPECT_EQ(20, root.find(std::string("limits")).find("burst").as<int>());
+  EXPECT_TRUE(root.find("empty").IsNull());
+  EXPECT_EQ("!custom", root.find("tagged").Tag());
+  EXPECT_EQ(3, root.find("limits").Mark().line);
+
+  EXPECT_FALSE(root.find("missing"));
+  EXPECT_FALSE(root.find("ports").find("80"));
+  EXPECT_FALSE(root.find("name").find("name"));
+}
+
+TEST(TapeTest, At) {
+  const Tape tape = LoadTape("[a, [b, c], {d: e}, f]");
+  const TapeNode root = tape.Root();
+
+  ASSERT_TRUE(root.IsSequence());
+  EXPECT_EQ(4u, root.size());
+  EXPECT_EQ("a", root.at(0).Scalar());
+  EXPECT_EQ("c", root.at(1).at(1).Scalar());
+  EXPECT_EQ("e", root.at(2).find("d").Scalar());
+  EXPECT_EQ("f", root.at(3).Scalar());
+  EXPECT_FALSE(root.at(4));
+  EXPECT_EQ(EmitterStyle::Flow, root.Style());
+}
+
+TEST(TapeTest, Marks) {
+  const Tape tape = LoadTape("a: [1,\n  2]\nb:\n  c: x\n");
+  const TapeNode root = tape.Root();
+
+  const Mark two = root.find("a").at(1).Mark();
+  EXPECT_EQ(9, two.pos);
+  EXPECT_EQ(1, two.line);
+  EXPECT_EQ(2, two.column);
+  const Mark x = root.find("b").find("c").Mark();
+  EXPECT_EQ(20, x.pos);
+  EXPECT_EQ(3, x.line);
+  EXPECT_EQ(5, x.column);
+  EXPECT_EQ(0, root.Mark().pos);
+}
+
+TEST(TapeTest, Iteration) {
+  const Tape tape = LoadTape(kDocument);
+  const TapeNode root = tape.Root();
+
+  std::vector<std::string> keys;
+  for (const TapeValue& value : root)
+    keys.push_back(value.first.Scalar());
+  EXPECT_EQ((std::vector<std::string>{"name", "ports", "limits", "enabled",
+                                      "timeout", "empty", "tagged"}),
+            keys);
+
+  std::vector<int> ports;
+  for (TapeIterator it = root.find("ports").begin();
+       it != root.find("ports").end(); ++it)
+    ports.push_back(it->as<int>());
+  EXPECT_EQ((std::vector<int>{80, 443}), ports);
+
+  const TapeNode name = root.find("name");
+  EXPECT_TRUE(name.begin() == name.end());
+}
+
+TEST(TapeTest, As) {
+  const Tape tape = LoadTape(kDocument);
+  const TapeNode root = tape.Root();
+
+  EXPECT_EQ("server", root.find("name").as<std::string>());
+  EXPECT_TRUE(root.find("enabled").as<bool>());
+  EXPECT_EQ(1.5, root.find("timeout").as<double>());
+  EXPECT_EQ("null", root.find("empty").as<std::string>());
+  EXPECT_EQ((std::vector<int>{80, 443}),
+            root.find("ports").as<std::vector<int>>());
+  EXPECT_EQ((std::map<std::string, int>{{"rps", 100}, {"burst", 20}}),
+            (root.find("limits").as<std::map<std::string, int>>()));
+
+  EXPECT_THROW(root.find("name").as<int>(), TypedBadConversion<int>);
+  EXPECT_THROW(root.find("missing").as<int>(), InvalidNode);
+  EXPECT_EQ(7, root.find("name").as<int>(7));
+  EXPECT_EQ(7, root.find("missing").as<int>(7));
+}
+
+TEST(TapeTest, Aliases) {
+  const Tape tape = LoadTape("a: &x {b: 1}\nc: *x\nd: [*x, &y 2, *y]\n");
+  const TapeNode root = tape.Root();
+
+  EXPECT_EQ(1, root.find("c").find("b").as<int>());
+  EXPECT_EQ(1, root.find("d").at(0).find("b").as<int>());
+  EXPECT_EQ(2, root.find("d").at(2).as<int>());
+
+  const Node node = root.ToNode();
+  EXPECT_TRUE(node["a"].is(node["c"]));
+  EXPECT_TRUE(node["a"].is(node["d"][0]));
+  EXPECT_TRUE(node["d"][1].is(node["d"][2]));
+
+  // an alias of a node outside the subtree is a copy of it
+  const Node d = root.find("d").ToNode();
+  EXPECT_EQ(1, d[0]["b"].as<int>());
+}
+
+TEST(TapeTest, ToNodeMatchesLoad) {
+  const Tape tape = LoadTape(kDocument);
+  EXPECT_EQ(Dump(Load(kDocument)), Dump(tape.Root().ToNode()));
+  EXPECT_EQ(Dump(Load(kDocument)["limits"]),
+            Dump(tape.Root().find("limits").ToNode()));
+}
+
+TEST(TapeTest, Empty) {
+  const Tape tape = LoadTape("");
+  EXPECT_FALSE(tape.Root());
+  EXPECT_EQ(NodeType::Undefined, tape.Root().Type());
+  EXPECT_FALSE(tape.Root().find("a"));
+  EXPECT_FALSE(Tape().Root().ToNode().IsDefined());
+
+  EXPECT_TRUE(LoadTape("~").Root().IsNull());
+  EXPECT_THROW(LoadTape("[a"), ParserException);
+}
+}  // namespace
+}  // namespace YAML
@@ -53,6 +53,18 @@ TEST(OstreamWrapperTest, Position) {
   EXPECT_EQ(13, wrapper.pos());
 }
 
+TEST(OstreamWrapperTest, PositionAfterSeveralLines) {
+  YAML::ostream_wrapper wrapper;
+  wrapper.write("Hello");
+  wrapper.write(", world");
+  EXPECT_EQ(0, wrapper.row());
+  EXPECT_EQ(12, wrapper.col());
+  wrapper.write("\n\nfoo\nbar");
+  EXPECT_EQ(3, wrapper.row());
+  EXPECT_EQ(3, wrapper.col());
+  EXPECT_EQ(21, wrapper.pos());
+}
+
 TEST(OstreamWrapperTest, Comment) {
   YAML::ostream_wrapper wrapper;
   wrapper.write("Hello, world ");
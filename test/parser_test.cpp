@@ -1,14 +1,63 @@
 #include <yaml-cpp/depthguard.h>
 #include "yaml-cpp/parser.h"
 #include "yaml-cpp/exceptions.h"
+#include "yaml-cpp/nulleventhandler.h"
+#include "yaml-cpp/yaml.h"
 #include "mock_event_handler.h"
 #include "gtest/gtest.h"
 
 using YAML::Parser;
 using YAML::MockEventHandler;
+using YAML::NullEventHandler;
 using ::testing::NiceMock;
 using ::testing::StrictMock;
 
+namespace {
+class ChunkingEventHandler : public YAML::EventHandler {
+ public:
+  explicit ChunkingEventHandler(std::size_t chunkSize)
+      : chunkSize(chunkSize), chunked{}, whole{}, inScalar(false) {}
+
+  std::size_t ScalarChunkSize() const override { return chunkSize; }
+  void OnScalarStart(const YAML::Mark&, const std::string&,
+                     YAML::anchor_t) override {
+    EXPECT_FALSE(inScalar);
+    inScalar = true;
+    chunked.emplace_back();
+  }
+  void OnScalarChunk(const char* data, std::size_t size) override {
+    EXPECT_TRUE(inScalar);
+    EXPECT_GT(size, 0u);
+    EXPECT_LE(size, chunkSize);
+    chunked.back().append(data, size);
+  }
+  void OnScalarEnd() override {
+    EXPECT_TRUE(inScalar);
+    inScalar = false;
+  }
+  void OnScalar(const YAML::Mark&, const std::string&, YAML::anchor_t,
+                const std::string& value) override {
+    whole.push_back(value);
+  }
+
+  void OnDocumentStart(const YAML::Mark&) override {}
+  void OnDocumentEnd() override {}
+  void OnNull(const YAML::Mark&, YAML::anchor_t) override {}
+  void OnAlias(const YAML::Mark&, YAML::anchor_t) override {}
+  void OnSequenceStart(const YAML::Mark&, const std::string&, YAML::anchor_t,
+                       YAML::EmitterStyle::value) override {}
+  void OnSequenceEnd() override {}
+  void OnMapStart(const YAML::Mark&, const std::string&, YAML::anchor_t,
+                  YAML::EmitterStyle::value) override {}
+  void OnMapEnd() override {}
+
+  std::size_t chunkSize;
+  std::vector<std::string> chunked;
+  std::vector<std::string> whole;
+  bool inScalar;
+};
+}  // namespace
+
 TEST(ParserTest, Empty) {
     Parser parser;
 
@@ -62,3 +111,71 @@ TEST(ParserTest, CVE_2019_6285) {
     NiceMock<MockEventHandler> handler;
     EXPECT_THROW(parser.HandleNextDocument(handler), YAML::DeepRecursion);
 }
+
+TEST(ParserTest, NullEventHandlerReadsEveryDocument) {
+    std::istringstream input{"a: [b, c]\n---\n- d\n---\n{e: f}\n"};
+    Parser parser{input};
+
+    NullEventHandler handler;
+    int documents = 0;
+    while (parser.HandleNextDocument(handler))
+        documents++;
+    EXPECT_EQ(3, documents);
+}
+
+TEST(ParserTest, NullEventHandlerStillThrowsOnErrors) {
+    std::istringstream input{"a: [b, c"};
+    Parser parser{input};
+
+    NullEventHandler handler;
+    EXPECT_THROW(parser.HandleNextDocument(handler), YAML::ParserException);
+}
+
+TEST(ParserTest, ChunkedBlockScalarsMatchWholeOnes) {
+    const std::string inputs[] = {
+        "|\n  abc\n  def\n",
+        "|-\n  abc\n\n\n",
+        "|+\n  abc\n\n\n",
+        "|\n\n\n",
+        "|+\n\n\n",
+        "|2\n    x\n   y\n",
+        ">\n  a\n  b\n\n  c\n    d\n  e\n",
+        ">-\n  folded\n   more\n\n\n",
+        ">\n\n  a\n\n\n  b\n",
+        "--- |\n  in a document\n...\n",
+    };
+    for (const std::string& text : inputs) {
+        const std::string expected = YAML::Load(text).as<std::string>();
+        for (std::size_t chunkSize : {1, 3, 64}) {
+            std::istringstream input{text};
+            Parser parser{input};
+            ChunkingEventHandler handler(chunkSize);
+            EXPECT_TRUE(parser.HandleNextDocument(handler));
+            ASSERT_EQ(1u, handler.chunked.size()) << text;
+            EXPECT_EQ(expected, handler.chunked[0]) << text;
+            EXPECT_TRUE(handler.whole.empty());
+        }
+    }
+}
+
+TEST(ParserTest, OnlyBlockScalarsAreChunked) {
+    std::istringstream input{
+        "a: |\n  first\n  line\nb: plain\nc: >\n  second\n"
+        "d: 'quoted'\n"};
+    Parser parser{input};
+
+    ChunkingEventHandler handler(4);
+    EXPECT_TRUE(parser.HandleNextDocument(handler));
+    EXPECT_EQ((std::vector<std::string>{"first\nline\n", "second\n"}),
+              handler.chunked);
+    EXPECT_EQ((std::vector<std::string>{"a", "b", "plain", "c", "d", "quoted"}),
+              handler.whole);
+}
+
+TEST(ParserTest, ChunkedBlockScalarsStillThrowOnErrors) {
+    std::istringstream input{"a: |\n  text\n\t tab\n"};
+    Parser parser{input};
+
+    ChunkingEventHandler handler(2);
+    EXPECT_THROW(parser.HandleNextDocument(handler), YAML::ParserException);
+}
@@ -0,0 +1,40 @@
+#include "scanner.h"
+#include "gtest/gtest.h"
+
+#include <sstream>
+#include <string>
+
+using YAML::Scanner;
+
+namespace {
+// Scans 'count' entries of a block sequence of maps (with flow collections
+// in them), and returns the scanner's capacity after 'checkpoint' of them,
+// and at the end.
+std::pair<std::size_t, std::size_t> ScanEntries(int count, int checkpoint) {
+  std::string input;
+  for (int i = 0; i < count; i++) {
+    input += "- name: item\n  values: [1, {a: b}, [c]]\n  nested:\n"
+             "    deeper: {x: y}\n";
+  }
+  std::istringstream stream(input);
+  Scanner scanner(stream);
+
+  std::size_t early = 0;
+  const int tokensPerEntry = 30;
+  int tokens = 0;
+  while (!scanner.empty()) {
+    scanner.pop();
+    if (++tokens == checkpoint * tokensPerEntry)
+      early = scanner.capacity();
+  }
+  return std::make_pair(early, scanner.capacity());
+}
+
+TEST(ScannerTest, MemoryDoesNotGrowWithLength) {
+  const std::pair<std::size_t, std::size_t> capacity =
+      ScanEntries(10000, 100);
+  EXPECT_LT(0u, capacity.first);
+  EXPECT_EQ(capacity.first, capacity.second);
+  EXPECT_LT(capacity.second, 256u);
+}
+}  // namespace
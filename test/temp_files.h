@@ -0,0 +1,36 @@
+#ifndef TEMP_FILES_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+#define TEMP_FILES_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+
+#if defined(_MSC_VER) ||                                            \
+    (defined(__GNUC__) && (__GNUC__ == 3 && __GNUC_MINOR__ >= 4) || \
+     (__GNUC__ >= 4))  // GCC supports "pragma once" correctly since 3.4
+#pragma once
+#endif
+
+#include <fstream>
+#include <string>
+
+#include "gtest/gtest.h"
+
+namespace YAML {
+// Writes 'contents' to the file 'name' in the test's temporary directory,
+// and returns its path.
+inline std::string WriteTempFile(const std::string& name,
+                                 const std::string& contents) {
+  const std::string filename = ::testing::TempDir() + "/" + name;
+  std::ofstream fout(filename, std::ios::binary);
+  fout << contents;
+  return filename;
+}
+
+// A map with a sequence of 'count' small maps under "items".
+inline std::string ItemsDocument(int count) {
+  std::string contents = "items:\n";
+  for (int i = 0; i < count; i++) {
+    contents += "- {id: " + std::to_string(i) + ", name: item}\n";
+  }
+  return contents;
+}
+}  // namespace YAML
+
+#endif  // TEMP_FILES_H_62B23520_7C8E_11DE_8A39_0800200C9A66
@@ -0,0 +1,71 @@
+#include "tokenqueue.h"
+#include "gtest/gtest.h"
+
+#include <string>
+#include <vector>
+
+using YAML::Mark;
+using YAML::Token;
+using YAML::TokenQueue;
+
+namespace {
+TEST(TokenQueueTest, FirstInFirstOut) {
+  TokenQueue queue;
+  EXPECT_TRUE(queue.empty());
+
+  for (int i = 0; i < 100; i++) {
+    queue.push(Token::PLAIN_SCALAR, Mark()).value = std::to_string(i);
+  }
+  EXPECT_EQ(100u, queue.size());
+  EXPECT_EQ("99", queue.back().value);
+
+  for (int i = 0; i < 100; i++) {
+    ASSERT_FALSE(queue.empty());
+    EXPECT_EQ(std::to_string(i), queue.front().value);
+    queue.pop();
+  }
+  EXPECT_TRUE(queue.empty());
+}
+
+TEST(TokenQueueTest, TokensDontMoveAsTheQueueGrows) {
+  TokenQueue queue;
+  std::vector<Token*> tokens;
+
+  // keep a few in the queue as it wraps around, so it has to grow in the
+  // middle of its ring
+  for (int i = 0; i < 1000; i++) {
+    tokens.push_back(&queue.push(Token::KEY, Mark()));
+    tokens.back()->data = i;
+    if (i % 3 == 0) {
+      EXPECT_EQ(queue.front().data, tokens[tokens.size() - queue.size()]->data);
+      queue.pop();
+    }
+  }
+
+  for (std::size_t i = tokens.size() - queue.size(); i < tokens.size(); i++) {
+    EXPECT_EQ(tokens[i], &queue.front());
+    EXPECT_EQ(static_cast<int>(i), queue.front().data);
+    queue.pop();
+  }
+}
+
+TEST(TokenQueueTest, PreparedTokenIsOnlyAddedOnCommit) {
+  TokenQueue queue;
+  queue.push(Token::KEY, Mark());
+
+  Token& token = queue.prepare(Token::TAG, Mark());
+  token.value = "abandoned";
+  token.params.push_back("param");
+  EXPECT_EQ(1u, queue.size());
+
+  Token& next = queue.prepare(Token::ANCHOR, Mark());
+  EXPECT_EQ(&token, &next);
+  EXPECT_EQ(Token::ANCHOR, next.type);
+  EXPECT_TRUE(next.value.empty());
+  EXPECT_TRUE(next.params.empty());
+
+  queue.commit();
+  EXPECT_EQ(2u, queue.size());
+  EXPECT_EQ(&next, &queue.back());
+}
+}  // namespace
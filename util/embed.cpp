@@ -0,0 +1,159 @@
+#include "yaml-cpp/snapshot.h"
+#include "yaml-cpp/yaml.h"  // IWYU pragma: keep
+
+#include <cctype>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Compiles a YAML file into a C++ source file (and its header) with a snapshot
+// of the document in a constant array, and a function that returns it as a
+// YAML::Tape; so a program can carry the document without parsing it.
+
+void usage() {
+  std::cerr << "Usage: yaml-cpp-embed [--namespace NS] [--no-marks] NAME "
+               "INPUT OUTPUT.cpp OUTPUT.h\n";
+}
+
+bool is_identifier(const std::string& name) {
+  if (name.empty() || std::isdigit(static_cast<unsigned char>(name[0]))) {
+    return false;
+  }
+  for (char ch : name) {
+    if (!std::isalnum(static_cast<unsigned char>(ch)) && ch != '_') {
+      return false;
+    }
+  }
+  return true;
+}
+
+// splits "a::b" into {"a", "b"}
+bool split_namespace(const std::string& ns, std::vector<std::string>& names) {
+  std::size_t begin = 0;
+  while (true) {
+    const std::size_t end = ns.find("::", begin);
+    names.push_back(ns.substr(begin, end - begin));
+    if (!is_identifier(names.back())) {
+      return false;
+    }
+    if (end == std::string::npos) {
+      return true;
+    }
+    begin = end + 2;
+  }
+}
+
+std::string base_name(const std::string& path) {
+  const std::size_t slash = path.find_last_of("/\\");
+  return slash == std::string::npos ? path : path.substr(slash + 1);
+}
+
+void open_namespaces(std::ostream& out, const std::vector<std::string>& names) {
+  for (const std::string& name : names) {
+    out << "namespace " << name << " {\n";
+  }
+}
+
+void close_namespaces(std::ostream& out,
+                      const std::vector<std::string>& names) {
+  for (std::size_t i = names.size(); i > 0; i--) {
+    out << "}  // namespace " << names[i - 1] << "\n";
+  }
+}
+
+void write_header(std::ostream& out, const std::string& name,
+                  const std::vector<std::string>& names,
+                  const std::string& input) {
+  out << "// Generated by yaml-cpp-embed from " << base_name(input)
+      << "; do not edit.\n"
+      << "#pragma once\n\n"
+      << "#include \"yaml-cpp/tape.h\"\n\n";
+  open_namespaces(out, names);
+  out << "// The document in " << base_name(input) << ".\n"
+      << "const YAML::Tape& " << name << "();\n";
+  close_namespaces(out, names);
+}
+
+void write_source(std::ostream& out, const std::string& name,
+                  const std::vector<std::string>& names,
+                  const std::string& input, const std::string& header,
+                  const std::string& snapshot) {
+  out << "// Generated by yaml-cpp-embed from " << base_name(input)
+      << "; do not edit.\n"
+      << "#include \"" << base_name(header) << "\"\n\n"
+      << "#include \"yaml-cpp/snapshot.h\"\n\n"
+      << "namespace {\n"
+      << "const unsigned char kSnapshot[] = {";
+  char hex[8];
+  for (std::size_t i = 0; i < snapshot.size(); i++) {
+    out << (i % 12 == 0 ? "\n    " : " ");
+    std::snprintf(hex, sizeof(hex), "0x%02x,",
+                  static_cast<unsigned char>(snapshot[i]));
+    out << hex;
+  }
+  out << "\n};\n"
+      << "}  // namespace\n\n";
+  open_namespaces(out, names);
+  out << "const YAML::Tape& " << name << "() {\n"
+      << "  static const YAML::Tape tape = YAML::LoadSnapshot(\n"
+      << "      reinterpret_cast<const char*>(kSnapshot), "
+         "sizeof(kSnapshot));\n"
+      << "  return tape;\n"
+      << "}\n";
+  close_namespaces(out, names);
+}
+
+int main(int argc, char** argv) {
+  std::string ns;
+  bool withMarks = true;
+  std::vector<std::string> args;
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    if (arg == "--namespace") {
+      i++;
+      if (i >= argc) {
+        usage();
+        return -1;
+      }
+      ns = argv[i];
+    } else if (arg == "--no-marks") {
+      withMarks = false;
+    } else {
+      args.push_back(arg);
+    }
+  }
+
+  std::vector<std::string> names;
+  if (args.size() != 4 || !is_identifier(args[0]) ||
+      (!ns.empty() && !split_namespace(ns, names))) {
+    usage();
+    return -1;
+  }
+  const std::string& name = args[0];
+  const std::string& input = args[1];
+  const std::string& source = args[2];
+  const std::string& header = args[3];
+
+  std::string snapshot;
+  try {
+    std::ostringstream stream;
+    YAML::SaveSnapshot(YAML::LoadTapeFile(input), stream, withMarks);
+    snapshot = stream.str();
+  } catch (const YAML::Exception& e) {
+    std::cerr << input << ": " << e.what() << "\n";
+    return 1;
+  }
+
+  std::ofstream sourceOut(source);
+  write_source(sourceOut, name, names, input, header, snapshot);
+  std::ofstream headerOut(header);
+  write_header(headerOut, name, names, input);
+  if (!sourceOut || !headerOut) {
+    std::cerr << "could not write " << source << " and " << header << "\n";
+    return 1;
+  }
+  return 0;
+}
@@ -1,39 +1,35 @@
-#include "yaml-cpp/emitterstyle.h"
-#include "yaml-cpp/eventhandler.h"
+#include "yaml-cpp/nulleventhandler.h"
 #include "yaml-cpp/yaml.h"  // IWYU pragma: keep
 
 #include <cstdlib>
 #include <fstream>
 #include <iostream>
-
-class NullEventHandler : public YAML::EventHandler {
- public:
-  using Mark = YAML::Mark;
-  using anchor_t = YAML::anchor_t;
-
-  NullEventHandler() = default;
-
-  void OnDocumentStart(const Mark&) override {}
-  void OnDocumentEnd() override {}
-  void OnNull(const Mark&, anchor_t) override {}
-  void OnAlias(const Mark&, anchor_t) override {}
-  void OnScalar(const Mark&, const std::string&, anchor_t,
-                const std::string&) override {}
-  void OnSequenceStart(const Mark&, const std::string&, anchor_t,
-                       YAML::EmitterStyle::value style) override {}
-  void OnSequenceEnd() override {}
-  void OnMapStart(const Mark&, const std::string&, anchor_t,
-                  YAML::EmitterStyle::value style) override {}
-  void OnMapEnd() override {}
-};
+#include <string>
+#include <vector>
 
 void run(std::istream& in) {
   YAML::Parser parser(in);
-  NullEventHandler handler;
+  YAML::NullEventHandler handler;
+  // (this is the version that calls the handler directly; see Parser)
   parser.HandleNextDocument(handler);
 }
 
-void usage() { std::cerr << "Usage: read [-n N] [-c, --cache] [filename]\n"; }
+// loads every document, on 'threads' threads (0 means one per core)
+void run_parallel(std::istream& in, unsigned threads) {
+  YAML::LoadAllParallel(in, threads);
+}
+
+// loads each file as a document, several at once, on 'threads' threads (0
+// means one per core)
+void run_files(const std::vector<std::string>& filenames, unsigned threads) {
+  YAML::LoadFilesOptions options;
+  options.numThreads = threads;
+  YAML::LoadFiles(filenames, options);
+}
+
+void usage() {
+  std::cerr << "Usage: read [-n N] [-c, --cache] [-j THREADS] [filename...]\n";
+}
 
 std::string read_stream(std::istream& in) {
   return std::string((std::istreambuf_iterator<char>(in)),
@@ -43,7 +39,10 @@ std::string read_stream(std::istream& in) {
 int main(int argc, char** argv) {
   int N = 1;
   bool cache = false;
+  bool parallel = false;
+  unsigned threads = 0;
   std::string filename;
+  std::vector<std::string> filenames;
   for (int i = 1; i < argc; i++) {
     std::string arg = argv[i];
     if (arg == "-n") {
@@ -59,15 +58,32 @@ int main(int argc, char** argv) {
       }
     } else if (arg == "-c" || arg == "--cache") {
       cache = true;
-    } else {
-      filename = argv[i];
-      if (i + 1 != argc) {
+    } else if (arg == "-j") {
+      i++;
+      if (i >= argc || std::atoi(argv[i]) < 0) {
         usage();
         return -1;
       }
+      parallel = true;
+      threads = static_cast<unsigned>(std::atoi(argv[i]));
+    } else {
+      filenames.assign(argv + i, argv + argc);
+      filename = filenames.front();
+      break;
     }
   }
 
+  if (filenames.size() > 1) {
+    if (cache) {
+      usage();
+      return -1;
+    }
+    for (int i = 0; i < N; i++) {
+      run_files(filenames, threads);
+    }
+    return 0;
+  }
+
   if (N > 1 && !cache && filename.empty()) {
     usage();
     return -1;
@@ -84,18 +100,30 @@ int main(int argc, char** argv) {
     std::istringstream in(input);
     for (int i = 0; i < N; i++) {
       in.seekg(std::ios_base::beg);
-      run(in);
+      if (parallel) {
+        run_parallel(in, threads);
+      } else {
+        run(in);
+      }
     }
   } else {
     if (!filename.empty()) {
       std::ifstream in(filename);
       for (int i = 0; i < N; i++) {
         in.seekg(std::ios_base::beg);
-        run(in);
+        if (parallel) {
+          run_parallel(in, threads);
+        } else {
+          run(in);
+        }
       }
     } else {
       for (int i = 0; i < N; i++) {
-        run(std::cin);
+        if (parallel) {
+          run_parallel(std::cin, threads);
+        } else {
+          run(std::cin);
+        }
       }
     }
   }
@@ -0,0 +1,42 @@
+# yaml_cpp_embed(<target> <name> <file> [NAMESPACE <namespace>] [NO_MARKS])
+#
+# Compiles the YAML document in <file> into <target>, with yaml-cpp-embed, as
+# a function
+#
+#   const YAML::Tape& <name>();
+#
+# (in <namespace>, if given) declared in "<name>.h". The document is kept in
+# the program as a binary snapshot (see yaml-cpp/snapshot.h), so it isn't
+# parsed at runtime; NO_MARKS leaves out where each node is in <file>, which
+# makes it smaller. <target> must link to yaml-cpp.
+
+include(CMakeParseArguments)
+
+function(yaml_cpp_embed target name file)
+  cmake_parse_arguments(EMBED "NO_MARKS" "NAMESPACE" "" ${ARGN})
+
+  get_filename_component(input "${file}" ABSOLUTE)
+  set(output-dir "${CMAKE_CURRENT_BINARY_DIR}/yaml-cpp-embed")
+  set(source "${output-dir}/${name}.cpp")
+  set(header "${output-dir}/${name}.h")
+
+  set(options)
+  if (EMBED_NAMESPACE)
+    list(APPEND options --namespace "${EMBED_NAMESPACE}")
+  endif()
+  if (EMBED_NO_MARKS)
+    list(APPEND options --no-marks)
+  endif()
+
+  add_custom_command(
+    OUTPUT "${source}" "${header}"
+    COMMAND "${CMAKE_COMMAND}" -E make_directory "${output-dir}"
+    COMMAND yaml-cpp-embed ${options} "${name}" "${input}" "${source}"
+      "${header}"
+    DEPENDS "${input}" yaml-cpp-embed
+    COMMENT "Embedding ${file} as ${name}()"
+    VERBATIM)
+
+  target_sources(${target} PRIVATE "${source}" "${header}")
+  target_include_directories(${target} PRIVATE "${output-dir}")
+endfunction()